@@ -0,0 +1,74 @@
+/*
+ * mod-dungeon-master — bench/BenchAlloc.cpp
+ * Counting operator new / delete. Each block carries a 16-byte header with its
+ * size so live and peak bytes can be tracked without the platform's usable-size call.
+ */
+
+#include "BenchAlloc.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+constexpr std::size_t HEADER = 16;      // keeps the user pointer 16-byte aligned
+
+std::atomic<uint64> g_calls{0};
+std::atomic<uint64> g_bytes{0};
+std::atomic<uint64> g_live{0};
+std::atomic<uint64> g_peak{0};
+
+void* CountedAlloc(std::size_t size)
+{
+    void* raw = std::malloc(size + HEADER);
+    if (!raw)
+        throw std::bad_alloc();
+    *static_cast<std::size_t*>(raw) = size;
+
+    g_calls.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    uint64 live = g_live.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64 peak = g_peak.load(std::memory_order_relaxed);
+    while (live > peak && !g_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        ;
+    return static_cast<char*>(raw) + HEADER;
+}
+
+void CountedFree(void* p)
+{
+    if (!p)
+        return;
+    void* raw = static_cast<char*>(p) - HEADER;
+    g_live.fetch_sub(*static_cast<std::size_t*>(raw), std::memory_order_relaxed);
+    std::free(raw);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)                     { return CountedAlloc(size); }
+void* operator new[](std::size_t size)                   { return CountedAlloc(size); }
+void  operator delete(void* p) noexcept                  { CountedFree(p); }
+void  operator delete[](void* p) noexcept                { CountedFree(p); }
+void  operator delete(void* p, std::size_t) noexcept     { CountedFree(p); }
+void  operator delete[](void* p, std::size_t) noexcept   { CountedFree(p); }
+
+namespace DungeonMaster
+{
+
+AllocCounts GetAllocCounts()
+{
+    AllocCounts c;
+    c.Calls = g_calls.load(std::memory_order_relaxed);
+    c.Bytes = g_bytes.load(std::memory_order_relaxed);
+    c.Live  = g_live.load(std::memory_order_relaxed);
+    c.Peak  = g_peak.load(std::memory_order_relaxed);
+    return c;
+}
+
+void ResetAllocPeak()
+{
+    g_peak.store(g_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+} // namespace DungeonMaster
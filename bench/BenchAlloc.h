@@ -0,0 +1,28 @@
+/*
+ * mod-dungeon-master — bench/BenchAlloc.h
+ * Global operator new counting for the offline tools. Linking BenchAlloc.cpp
+ * replaces the allocator for the whole executable.
+ */
+
+#ifndef DM_BENCH_ALLOC_H
+#define DM_BENCH_ALLOC_H
+
+#include "Define.h"
+
+namespace DungeonMaster
+{
+
+struct AllocCounts
+{
+    uint64 Calls = 0;       // operator new calls since start
+    uint64 Bytes = 0;       // bytes requested by them
+    uint64 Live  = 0;       // bytes allocated and not yet freed
+    uint64 Peak  = 0;       // high-water mark of Live
+};
+
+AllocCounts GetAllocCounts();
+void        ResetAllocPeak();   // Peak restarts from the current Live
+
+} // namespace DungeonMaster
+
+#endif // DM_BENCH_ALLOC_H
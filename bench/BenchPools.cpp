@@ -0,0 +1,245 @@
+/*
+ * mod-dungeon-master — bench/BenchPools.cpp
+ * CSV parsing and synthetic pool generation.
+ */
+
+#include "BenchPools.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace DungeonMaster
+{
+
+// Comma-separated unsigned / signed fields; false for headers and comments
+static bool ParseRow(const std::string& line, std::vector<int64>& out)
+{
+    out.clear();
+    if (line.empty() || line[0] == '#')
+        return false;
+
+    const char* p = line.c_str();
+    while (*p)
+    {
+        char* end = nullptr;
+        int64 v = std::strtoll(p, &end, 10);
+        if (end == p)
+            return false;       // not a number: header row
+        out.push_back(v);
+        p = end;
+        while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+        if (*p == ',') ++p;
+        else if (*p) return false;
+    }
+    return !out.empty();
+}
+
+template <typename RowFn>
+static bool ReadCsv(const std::string& path, size_t minColumns, RowFn&& onRow)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    std::string line;
+    std::vector<int64> row;
+    uint32 rows = 0, skipped = 0;
+    while (std::getline(in, line))
+    {
+        if (!ParseRow(line, row))
+            continue;
+        if (row.size() < minColumns)
+        {
+            ++skipped;
+            continue;
+        }
+        onRow(row);
+        ++rows;
+    }
+    std::printf("Loaded %u rows from %s", rows, path.c_str());
+    if (skipped)
+        std::printf(" (%u short rows skipped)", skipped);
+    std::printf("\n");
+    return true;
+}
+
+static ItemStatProfile StatPairs(const std::vector<int64>& row, size_t first)
+{
+    ItemStatProfile profile;
+    for (size_t i = first; i + 1 < row.size(); i += 2)
+        AddItemStat(profile, static_cast<uint32>(row[i]), static_cast<int32>(row[i + 1]));
+    return profile;
+}
+
+bool LoadCreatureCsv(const std::string& path, BenchPools& pools)
+{
+    return ReadCsv(path, 5, [&](const std::vector<int64>& r)
+    {
+        CreaturePoolEntry e;
+        e.Entry    = static_cast<uint32>(r[0]);
+        e.Type     = static_cast<uint32>(r[1]);
+        e.MinLevel = static_cast<uint8>(r[2]);
+        e.MaxLevel = static_cast<uint8>(r[3]);
+        uint32 rank = static_cast<uint32>(r[4]);
+        // Same split as LoadCreaturePools: elite / rare-elite go to the boss fallback
+        if (rank == 1 || rank == 2 || rank == 4)
+            pools.Elites[e.Type].push_back(e);
+        else
+            pools.Trash[e.Type].push_back(e);
+    });
+}
+
+bool LoadBossCsv(const std::string& path, BenchPools& pools)
+{
+    return ReadCsv(path, 4, [&](const std::vector<int64>& r)
+    {
+        CreaturePoolEntry e;
+        e.Entry    = static_cast<uint32>(r[0]);
+        e.Type     = static_cast<uint32>(r[1]);
+        e.MinLevel = static_cast<uint8>(r[2]);
+        e.MaxLevel = static_cast<uint8>(r[3]);
+        pools.DungeonBosses[e.Type].push_back(e);
+    });
+}
+
+bool LoadRewardCsv(const std::string& path, BenchPools& pools)
+{
+    return ReadCsv(path, 8, [&](const std::vector<int64>& r)
+    {
+        RewardItem ri;
+        ri.Entry          = static_cast<uint32>(r[0]);
+        ri.MinLevel       = static_cast<uint8>(r[1]);
+        ri.MaxLevel       = ri.MinLevel + 5;
+        ri.Quality        = static_cast<uint8>(r[2]);
+        ri.InventoryType  = static_cast<uint32>(r[3]);
+        ri.Class          = static_cast<uint32>(r[4]);
+        ri.SubClass       = static_cast<uint32>(r[5]);
+        ri.AllowableClass = static_cast<int32>(r[6]);
+        ri.ItemLevel      = static_cast<uint16>(r[7]);
+        ri.Stats          = StatPairs(r, 8);
+        pools.Rewards.push_back(ri);
+    });
+}
+
+bool LoadLootCsv(const std::string& path, BenchPools& pools)
+{
+    return ReadCsv(path, 7, [&](const std::vector<int64>& r)
+    {
+        LootPoolItem li;
+        li.Entry          = static_cast<uint32>(r[0]);
+        li.MinLevel       = static_cast<uint8>(r[1]);
+        li.Quality        = static_cast<uint8>(r[2]);
+        li.ItemClass      = static_cast<uint8>(r[3]);
+        li.SubClass       = static_cast<uint8>(r[4]);
+        li.AllowableClass = static_cast<int32>(r[5]);
+        li.ItemLevel      = static_cast<uint16>(r[6]);
+        li.Stats          = StatPairs(r, 7);
+        pools.Loot.push_back(li);
+    });
+}
+
+// Stats land on one primary attribute (or none, like trinkets and rings
+// without a main stat) plus stamina, so class scoring has real spread
+static ItemStatProfile SyntheticStats(DMRng& rng, uint32 level)
+{
+    ItemStatProfile profile;
+    uint32 budget = 2 + level / 2;
+    static constexpr uint32 primaries[] = { 3, 4, 5, 0 };
+    uint32 primary = primaries[rng.Below(4)];
+    if (primary)
+        AddItemStat(profile, primary, static_cast<int32>(budget));
+    AddItemStat(profile, 7, static_cast<int32>(rng.Range<uint32>(budget / 2, budget)));
+    return profile;
+}
+
+static void FillCreatures(CreaturePool& pool, uint32 count, DMRng& rng, uint32 entryBase)
+{
+    // Combat types 1..10 without Critter (8), weighted toward Humanoid and Beast
+    static constexpr uint32 types[]   = { 1, 2, 3, 4, 5, 6, 7, 9, 10 };
+    static constexpr uint32 weights[] = { 20, 4, 6, 8, 3, 12, 35, 8, 4 };
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 roll = rng.Below(100), type = types[0];
+        for (size_t t = 0; t < std::size(types); ++t)
+        {
+            if (roll < weights[t]) { type = types[t]; break; }
+            roll -= weights[t];
+        }
+
+        CreaturePoolEntry e;
+        e.Entry    = entryBase + i;
+        e.Type     = type;
+        e.MinLevel = static_cast<uint8>(rng.Range<uint32>(1, 80));
+        e.MaxLevel = static_cast<uint8>(std::min<uint32>(83, e.MinLevel + rng.Below(3)));
+        pool[type].push_back(e);
+    }
+}
+
+void FillSyntheticPools(BenchPools& pools, uint64 seed)
+{
+    DMRng rng(seed);
+
+    if (pools.Trash.empty())
+        FillCreatures(pools.Trash, 9000, rng, 100000);
+    if (pools.Elites.empty())
+        FillCreatures(pools.Elites, 3500, rng, 200000);
+    if (pools.DungeonBosses.empty())
+        FillCreatures(pools.DungeonBosses, 250, rng, 300000);
+
+    if (pools.Rewards.empty())
+    {
+        pools.Rewards.reserve(11000);
+        for (uint32 i = 0; i < 11000; ++i)
+        {
+            RewardItem ri;
+            ri.Entry          = 400000 + i;
+            ri.MinLevel       = static_cast<uint8>(rng.Range<uint32>(1, 80));
+            ri.MaxLevel       = ri.MinLevel + 5;
+            ri.Quality        = static_cast<uint8>(rng.Range<uint32>(2, 4));
+            ri.Class          = rng.Chance(30) ? 2 : 4;
+            ri.SubClass       = ri.Class == 4 ? rng.Range<uint32>(0, 4) : rng.Range<uint32>(0, 19);
+            ri.InventoryType  = rng.Range<uint32>(1, 26);
+            ri.AllowableClass = rng.Chance(85) ? -1 : static_cast<int32>(1u << rng.Below(11));
+            ri.ItemLevel      = static_cast<uint16>(ri.MinLevel * 2 + 5);
+            ri.Stats          = SyntheticStats(rng, ri.MinLevel);
+            pools.Rewards.push_back(ri);
+        }
+    }
+
+    if (pools.Loot.empty())
+    {
+        pools.Loot.reserve(20000);
+        for (uint32 i = 0; i < 20000; ++i)
+        {
+            // Grey and white trade goods / consumables, then equipment
+            LootPoolItem li;
+            li.Entry     = 500000 + i;
+            li.Quality   = static_cast<uint8>(rng.Below(5));
+            bool gear    = li.Quality >= 2 || rng.Chance(40);
+            li.ItemClass = gear ? (rng.Chance(30) ? 2 : 4) : (rng.Chance(50) ? 0 : 15);
+            li.SubClass  = static_cast<uint8>(li.ItemClass == 4 ? rng.Below(5) : rng.Below(20));
+            li.MinLevel  = gear ? static_cast<uint8>(rng.Range<uint32>(1, 80)) : 0;
+            li.ItemLevel = static_cast<uint16>(gear ? li.MinLevel * 2 + 5 : rng.Range<uint32>(1, 200));
+            li.AllowableClass = rng.Chance(90) ? -1 : static_cast<int32>(1u << rng.Below(11));
+            if (gear)
+                li.Stats = SyntheticStats(rng, li.MinLevel);
+            pools.Loot.push_back(li);
+        }
+    }
+}
+
+uint32 CountEntries(const CreaturePool& pool)
+{
+    uint32 n = 0;
+    for (const auto& [type, entries] : pool)
+        n += static_cast<uint32>(entries.size());
+    return n;
+}
+
+} // namespace DungeonMaster
@@ -0,0 +1,48 @@
+/*
+ * mod-dungeon-master — bench/BenchPools.h
+ * Creature and item pools for the offline tools: synthetic pools of roughly
+ * world-database size, or CSV dumps of the module's own pool queries.
+ */
+
+#ifndef DM_BENCH_POOLS_H
+#define DM_BENCH_POOLS_H
+
+#include "DMSelection.h"
+#include <string>
+#include <vector>
+
+namespace DungeonMaster
+{
+
+struct BenchPools
+{
+    CreaturePool              Trash;          // rank 0, by creature type
+    CreaturePool              Elites;         // rank 1 / 2 / 4, the boss fallback
+    CreaturePool              DungeonBosses;
+    std::vector<RewardItem>   Rewards;
+    std::vector<LootPoolItem> Loot;
+};
+
+// CSV columns follow the SELECTs in DungeonMasterMgr::Load*; blank lines, '#'
+// comments and a header row are skipped. Item files may append
+// stat_type,stat_value pairs (item_template stat_type1..10 / stat_value1..10).
+//
+//   creatures:  entry,type,minlevel,maxlevel,rank
+//   bosses:     entry,type,minlevel,maxlevel
+//   rewards:    entry,RequiredLevel,Quality,InventoryType,class,subclass,AllowableClass,ItemLevel[,stat pairs]
+//   loot:       entry,RequiredLevel,Quality,class,subclass,AllowableClass,ItemLevel[,stat pairs]
+//
+// Each returns false (and prints why) when the file cannot be read.
+bool LoadCreatureCsv(const std::string& path, BenchPools& pools);
+bool LoadBossCsv(const std::string& path, BenchPools& pools);
+bool LoadRewardCsv(const std::string& path, BenchPools& pools);
+bool LoadLootCsv(const std::string& path, BenchPools& pools);
+
+// Fills whichever pools are still empty
+void FillSyntheticPools(BenchPools& pools, uint64 seed);
+
+uint32 CountEntries(const CreaturePool& pool);
+
+} // namespace DungeonMaster
+
+#endif // DM_BENCH_POOLS_H
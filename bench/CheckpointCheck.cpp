@@ -0,0 +1,123 @@
+/*
+ * mod-dungeon-master — bench/CheckpointCheck.cpp
+ * Crash-recovery cases for CheckpointStore against the in-memory table in
+ * shim/DatabaseEnv.h. A "crash" is a fresh store loading whatever rows made it
+ * to the table. Exits non-zero if any case fails.
+ *
+ *   dm_checkpoint_check
+ */
+
+#include "DMCheckpoint.h"
+#include "DatabaseEnv.h"
+#include <cstdio>
+#include <vector>
+
+using namespace DungeonMaster;
+
+namespace
+{
+
+uint32 g_failures = 0;
+
+void Expect(bool ok, const char* what)
+{
+    std::printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok)
+        ++g_failures;
+}
+
+PlayerCheckpoint Row(uint32 guid, uint32 instanceId)
+{
+    PlayerCheckpoint cp;
+    cp.Guid        = guid;
+    cp.LeaderGuid  = 1;
+    cp.MapId       = 36;
+    cp.InstanceId  = instanceId;
+    cp.Seed        = 0x1234abcdULL;
+    cp.Creatures   = 12;
+    cp.DeadMask    = "0f00";
+    cp.Tier        = 3;
+    cp.Affixes     = "1,4";
+    cp.ReturnMapId = 0;
+    cp.ReturnPos   = { -8913.2f, 554.6f, 93.1f, 0.6f };
+    return cp;
+}
+
+// What a restart would hand out
+bool Recovers(uint32 guid)
+{
+    CheckpointStore restarted;
+    restarted.Load();
+    PlayerCheckpoint cp;
+    return restarted.TakeRecovery(guid, cp);
+}
+
+void Reset()
+{
+    CharacterDatabase.RunPending();
+    CharacterDatabase.Rows.clear();
+}
+
+} // namespace
+
+int main()
+{
+    // Session ended, server crashed before the next checkpoint write
+    {
+        Reset();
+        CheckpointStore store;
+        store.Write({ Row(1, 10), Row(2, 11) });
+        CharacterDatabase.RunPending();
+        store.Forget(1);
+        CharacterDatabase.RunPending();
+        Expect(!Recovers(1), "ended run is not recovered after a crash before the next write");
+        Expect(Recovers(2), "run still in progress is recovered");
+    }
+
+    // The Forget delete overtakes the REPLACE queued before it
+    {
+        Reset();
+        CheckpointStore store;
+        store.Write({ Row(1, 10) });
+        CharacterDatabase.RunPending();
+        store.Write({ Row(1, 12) });
+        store.Forget(1);
+        CharacterDatabase.RunPending(true);
+        store.Write({});
+        CharacterDatabase.RunPending();
+        Expect(!Recovers(1), "stale row left by a reordered delete is removed by the next write");
+    }
+
+    // The player is in a new session by the next write
+    {
+        Reset();
+        CheckpointStore store;
+        store.Write({ Row(1, 10) });
+        CharacterDatabase.RunPending();
+        store.Forget(1);
+        store.Write({ Row(1, 13) });
+        CharacterDatabase.RunPending();
+        CheckpointStore restarted;
+        restarted.Load();
+        PlayerCheckpoint cp;
+        Expect(restarted.TakeRecovery(1, cp) && cp.InstanceId == 13, "new session's row survives the forget");
+    }
+
+    // Row round trip
+    {
+        Reset();
+        CheckpointStore store;
+        store.Write({ Row(7, 20) });
+        CharacterDatabase.RunPending();
+        CheckpointStore restarted;
+        restarted.Load();
+        PlayerCheckpoint cp;
+        bool taken = restarted.TakeRecovery(7, cp);
+        Expect(taken && cp.DeadMask == "0f00" && cp.CountDead() == 4 && cp.Affixes == "1,4"
+            && cp.Seed == 0x1234abcdULL, "checkpoint row round-trips");
+        CharacterDatabase.RunPending();
+        Expect(!Recovers(7), "taken recovery is deleted");
+    }
+
+    return g_failures ? 1 : 0;
+}
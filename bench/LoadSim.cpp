@@ -0,0 +1,1398 @@
+/*
+ * mod-dungeon-master — bench/LoadSim.cpp
+ * Headless load simulator for sizing DungeonMaster.MaxConcurrentRuns. Keeps N
+ * sessions running through create, populate, streaming, kills, boss phase
+ * checks, deaths, wipes and roguelike floor transitions on mock players, maps
+ * and creatures. The once-a-second tick repeats DungeonMasterMgr::Update step
+ * by step on the module's own Session, SpawnRoster and DMSelection code; only
+ * the core objects (Player, Map, Creature) and chat/DB output are mocked.
+ *
+ * The Simulator methods are hand copies of module code and must be updated
+ * with it. They were last synced with commit 1979aec:
+ *   Tick                        DungeonMasterMgr::Update
+ *   CreateSession               DungeonMasterMgr::CreateSession
+ *   ApplyPresenceEvents         DungeonMasterMgr::ApplyPresenceEvents
+ *   PopulateDungeon             DungeonMasterMgr::PopulateDungeon
+ *   StreamPopulation            DungeonMasterMgr::StreamPopulation
+ *   FillCreatureLoot            DungeonMasterMgr::FillCreatureLoot
+ *   QueueKillXP                 DungeonMasterMgr::QueueKillXP
+ *   FlushKillCredit             DungeonMasterMgr::FlushKillCredit
+ *   DistributeRewards           DungeonMasterMgr::DistributeRewards
+ *   ReleaseSession, EndSession  DungeonMasterMgr::EndSession, ReleaseInstance,
+ *                               CleanupRoguelikeSession
+ *   CompleteFloor, EndRun       RoguelikeMgr::OnDungeonCompleted, EndRun
+ *   OnCreatureKilled            DungeonMasterMgr::OnCreatureDeathHook, HandleCreatureDeath
+ *   OnPlayerDied                DungeonMasterMgr::HandlePlayerDeath
+ *
+ *   dm_load_sim [--sessions 20,50,100,150,200] [--duration s] [--warmup s]
+ *               [--kill-rate k] [--death-rate d] [--wipe-rate w]
+ *               [--roguelike pct] [--boss-time s] [--stream-ahead yd]
+ *               [--budget n] [--seed n]
+ */
+
+#include "BenchAlloc.h"
+#include "BenchPools.h"
+#include "DMMemory.h"
+#include "DMRandom.h"
+#include "DMSelection.h"
+#include "DMTypes.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace DungeonMaster;
+
+namespace
+{
+
+// Module defaults (DMConfig.h) for the settings the simulated steps read
+struct SimConfig
+{
+    std::vector<uint32> SessionCounts = { 20, 50, 100, 150, 200 };
+    uint32 Duration        = 900;     // simulated seconds measured per session count
+    uint32 Warmup          = 300;     // seconds of ramp-up before measuring
+    float  KillRate        = 0.6f;    // trash killed per second while a party is fighting
+    float  DeathRate       = 4.0f;    // deaths per player per hour of combat
+    float  WipeRate        = 0.5f;    // wipes per session per hour of combat
+    uint32 RoguelikePct    = 30;      // share of new sessions that start a roguelike run
+    uint32 BossTime        = 45;      // seconds to kill a boss
+    uint32 PhaseChance     = 15;      // % of bosses whose script spawns a second phase
+    uint32 StreamAhead     = 150;
+    uint32 LiveBudget      = 5000;
+    float  PackRadius      = 8.0f;
+    uint32 PackMaxSize     = 5;
+    uint32 EliteChance     = 20;
+    uint32 RareChance      = 5;
+    uint32 BossCount       = 1;
+    float  MinDensity      = 0.5f;
+    uint32 CompletionDelay = 30;
+    uint32 TransitionDelay = 30;
+    uint64 Seed            = 1;
+};
+
+constexpr uint32 MAX_LEVEL      = 80;
+constexpr float  MOVE_PER_SEC   = 7.0f;     // yd a party advances per second out of combat
+constexpr float  ENGAGE_RANGE   = 25.0f;
+
+// ---- Mock world ----
+
+struct MockCreature
+{
+    ObjectGuid Guid;
+    uint32     Entry     = 0;
+    Position   Pos;
+    float      Distance  = 0.0f;    // from the entrance, as SpawnPoint::DistanceFromEntrance
+    uint32     MaxHealth = 0;
+    float      MinDamage = 0.0f;
+    float      MaxDamage = 0.0f;
+    bool       Alive     = true;
+    bool       Elite     = false;
+};
+
+// One dungeon instance; creatures are kept by GUID like the map's object store
+struct MockMap
+{
+    uint32 MapId      = 0;
+    uint32 InstanceId = 0;
+    std::unordered_map<ObjectGuid, MockCreature> Creatures;
+
+    MockCreature* GetCreature(ObjectGuid guid)
+    {
+        auto it = Creatures.find(guid);
+        return it == Creatures.end() ? nullptr : &it->second;
+    }
+};
+
+struct MockPlayer
+{
+    ObjectGuid Guid;
+    uint8      Level    = MAX_LEVEL;
+    uint32     Class    = 1;
+    bool       Alive    = true;
+    bool       InCombat = false;
+    MockMap*   Map      = nullptr;
+    uint64     XP       = 0;
+    uint32     Gold     = 0;
+    uint32     Items    = 0;
+};
+
+struct SimDungeon
+{
+    uint32         MapId = 0;
+    SpawnPointList Points;
+};
+
+struct SimDifficulty
+{
+    float HealthMult;
+    float DamageMult;
+    float MobCountMult;
+};
+
+// What a party is doing, outside the module's own Session
+struct PartyScript
+{
+    float  Progress   = 0.0f;           // yd from the entrance
+    float  KillCredit = 0.0f;           // kills owed at KillRate
+    uint32 BossFight  = 0;              // seconds on the current boss
+    bool   Fighting   = false;
+    uint32 InstanceId = 0;              // the map the party was teleported into
+    std::deque<ObjectGuid> Trash;       // summoned trash in pack-distance order
+};
+
+struct RunState
+{
+    uint32 RunId   = 0;
+    uint32 Tier    = 1;
+    uint32 PrevMap = 0;
+    uint32 Floors  = 0;
+    uint32 Affixes = 0;
+    std::vector<ObjectGuid> Players;
+    uint32 SessionId = 0;
+    bool   Wiped     = false;
+};
+
+struct PresenceEvent
+{
+    ObjectGuid Guid;
+    bool       Alive;
+    bool       InCombat;
+};
+
+// Module work per tick, summed over sessions (µs)
+enum SimPhase : uint8
+{
+    SIM_RESOLVE = 0,
+    SIM_DEATH_POLL,
+    SIM_STREAM,
+    SIM_PHASE_CHECKS,
+    SIM_AUTO_REZ,
+    SIM_KILL_CREDIT,
+    SIM_END_TRANSITION,
+    SIM_POPULATE,
+    SIM_HOOKS,          // creature death and player death hooks between ticks
+    MAX_SIM_PHASES
+};
+
+const char* const PHASE_NAMES[MAX_SIM_PHASES] =
+{
+    "resolve", "poll", "stream", "phase", "rez", "credit", "end", "populate", "hooks"
+};
+
+using Clock = std::chrono::steady_clock;
+
+uint32 MicrosSince(Clock::time_point start)
+{
+    return static_cast<uint32>(std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start).count());
+}
+
+// Adds its lifetime to one phase slot
+class PhaseTimer
+{
+public:
+    PhaseTimer(std::array<uint32, MAX_SIM_PHASES>& acc, SimPhase phase)
+        : _acc(acc), _phase(phase), _start(Clock::now()) { }
+    ~PhaseTimer() { _acc[_phase] += MicrosSince(_start); }
+
+private:
+    std::array<uint32, MAX_SIM_PHASES>& _acc;
+    SimPhase          _phase;
+    Clock::time_point _start;
+};
+
+struct Counters
+{
+    uint64 Created      = 0;
+    uint64 Completed    = 0;
+    uint64 Failed       = 0;
+    uint64 Floors       = 0;    // roguelike floors cleared
+    uint64 RunsEnded    = 0;
+    uint64 TrashKilled  = 0;
+    uint64 BossesKilled = 0;
+    uint64 Promotions   = 0;    // phase creatures promoted to boss
+    uint64 Deaths       = 0;
+    uint64 Wipes        = 0;
+};
+
+struct LoadResult
+{
+    uint32 Sessions = 0;
+    std::vector<uint32> Ticks;                                  // µs per tick
+    std::array<std::vector<uint32>, MAX_SIM_PHASES> Phases;     // µs per tick
+    uint64 CreatureTicks   = 0;     // roster sizes summed over ticks
+    uint64 SessionTicks    = 0;
+    uint64 PeakStateBytes  = 0;     // module session state, as .dm perf load
+    uint64 PeakHeapBytes   = 0;     // whole process, mock world included
+    uint64 TickAllocs      = 0;
+    Counters Totals;
+};
+
+// ---- Simulator ----
+
+class Simulator
+{
+public:
+    Simulator(const SimConfig& cfg, const BenchPools& pools, uint32 target);
+
+    void Step(bool measure, LoadResult* out);
+    void SetTarget(uint32 n) { _target = n; }
+
+    const Counters& GetCounters() const { return _counters; }
+
+private:
+    // Gossip / CreateSession path; not part of the tick
+    void   Replenish();
+    uint32 CreateSession(RunState* run);
+    MockPlayer& NewPlayer();
+
+    // DungeonMasterMgr::Update
+    void   Tick(std::array<uint32, MAX_SIM_PHASES>& acc);
+    void   ApplyPresenceEvents();
+    void   PopulateDungeon(Session& s, MockMap& map);
+    uint32 StreamPopulation(Session& s, MockMap& map, float progress);
+    MockCreature* Summon(MockMap& map, uint32 entry, const Position& pos, float distance,
+                         uint8 level, float hpMult, float dmgMult, bool elite);
+    void   FillCreatureLoot(const Session& s, const std::vector<MockPlayer*>& party, uint32 idx);
+    void   QueueKillXP(Session& s, const std::vector<MockPlayer*>& party, bool isBoss, bool isElite);
+    void   FlushKillCredit(Session& s, const std::vector<MockPlayer*>& party);
+    void   FlushKillCredit(Session& s) { FlushKillCredit(s, ResolveParty(s)); }
+    void   DistributeRewards(const Session& s);
+    void   EndSession(uint32 sid, bool success);
+    void   CompleteFloor(uint32 runId, uint32 sid);
+    void   EndRun(uint32 runId);
+    void   ReleaseSession(Session& s);
+
+    // Map threads: party behaviour and the death hooks
+    void   WorldStep(std::array<uint32, MAX_SIM_PHASES>& acc);
+    void   OnCreatureKilled(Session& s, MockCreature& c);
+    void   OnPlayerDied(Session& s, MockPlayer& p);
+    void   QueuePresence(const MockPlayer& p) { _presence.push_back({ p.Guid, p.Alive, p.InCombat }); }
+
+    std::vector<MockPlayer*> ResolveParty(const Session& s);
+    uint64 StateBytes() const;
+
+    const SimConfig&  _cfg;
+    const BenchPools& _pools;
+    uint32 _target;
+
+    DMRng  _rng;
+    uint64 _now = 1;                 // GameTime, seconds
+    uint32 _nextSessionId  = 1;
+    uint32 _nextInstanceId = 1;
+    uint32 _nextRunId      = 1;
+    uint64 _nextGuid       = 1;
+    uint32 _liveBudgetUsed = 0;
+
+    std::vector<SimDungeon>                      _dungeons;
+    std::vector<std::vector<uint32>>             _themes;
+    std::array<SimDifficulty, 4>                 _difficulties;
+    std::array<ClassLevelStatEntry, MAX_LEVEL + 4> _levelStats;
+
+    std::unordered_map<uint32, Session>          _activeSessions;
+    std::unordered_map<ObjectGuid, uint32>       _playerToSession;
+    std::unordered_map<uint32, uint32>           _instanceToSession;
+    std::unordered_map<uint32, PartyScript>      _scripts;
+    std::unordered_map<uint32, RunState>         _runs;
+    std::unordered_map<uint32, std::unique_ptr<MockMap>> _maps;     // by instance id
+    std::unordered_map<ObjectGuid, MockPlayer>   _players;
+    std::vector<PresenceEvent>                   _presence;
+
+    Counters _counters;
+};
+
+Simulator::Simulator(const SimConfig& cfg, const BenchPools& pools, uint32 target)
+    : _cfg(cfg), _pools(pools), _target(target), _rng(cfg.Seed)
+{
+    // Dungeons of 80-260 points along a winding corridor, bosses at the far end
+    for (uint32 d = 0; d < 24; ++d)
+    {
+        auto points = std::make_shared<std::vector<SpawnPoint>>();
+        uint32 count = _rng.Range<uint32>(80, 260);
+        float  length = count * 2.2f;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float along = _rng.Float(5.0f, length);
+            SpawnPoint sp;
+            sp.Pos = { along, 35.0f * std::sin(along / 45.0f) + _rng.Float(-6.0f, 6.0f), _rng.Float(-2.0f, 2.0f), 0.0f };
+            sp.DistanceFromEntrance = std::sqrt(sp.Pos.GetPositionX() * sp.Pos.GetPositionX()
+                + sp.Pos.GetPositionY() * sp.Pos.GetPositionY());
+            points->push_back(sp);
+        }
+        for (uint32 b = 0; b < 3; ++b)
+        {
+            SpawnPoint sp;
+            sp.Pos = { length + 20.0f + b * 15.0f, 0.0f, 0.0f, 0.0f };
+            sp.DistanceFromEntrance = sp.Pos.GetPositionX();
+            sp.IsBossPosition = true;
+            points->push_back(sp);
+        }
+        std::sort(points->begin(), points->end(), [](const SpawnPoint& a, const SpawnPoint& b)
+            { return a.DistanceFromEntrance < b.DistanceFromEntrance; });
+        _dungeons.push_back({ 30 + d, points });
+    }
+
+    _themes = { { 7, 6 }, { 1 }, { 3, 4 }, { 2 }, { 9, 10 }, { uint32(-1) } };
+    _difficulties = { { { 1.0f, 1.0f, 0.8f }, { 1.5f, 1.3f, 1.0f }, { 2.2f, 1.6f, 1.0f }, { 3.0f, 2.0f, 1.0f } } };
+
+    for (uint32 lvl = 0; lvl < _levelStats.size(); ++lvl)
+    {
+        _levelStats[lvl].BaseHP      = 40 + lvl * lvl * 2;
+        _levelStats[lvl].BaseDamage  = 2.0f + lvl * 1.6f;
+        _levelStats[lvl].AttackPower = lvl * 9;
+    }
+}
+
+MockPlayer& Simulator::NewPlayer()
+{
+    static constexpr uint32 classes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 11 };
+    MockPlayer p;
+    p.Guid  = ObjectGuid(_nextGuid++);
+    p.Level = _rng.Chance(70) ? MAX_LEVEL : static_cast<uint8>(_rng.Range<uint32>(15, MAX_LEVEL - 1));
+    p.Class = classes[_rng.Below(10)];
+    return _players.emplace(p.Guid, p).first->second;
+}
+
+void Simulator::Replenish()
+{
+    while (_activeSessions.size() < _target)
+    {
+        if (_rng.Chance(_cfg.RoguelikePct))
+        {
+            RunState& run = _runs[_nextRunId];
+            run.RunId = _nextRunId++;
+            uint32 size = _rng.Range<uint32>(1, MAX_PARTY_SIZE);
+            for (uint32 i = 0; i < size; ++i)
+                run.Players.push_back(NewPlayer().Guid);
+            run.SessionId = CreateSession(&run);
+        }
+        else
+            CreateSession(nullptr);
+    }
+}
+
+// CreateSession + TeleportPartyIn: the party arrives already on a fresh instance
+uint32 Simulator::CreateSession(RunState* run)
+{
+    std::vector<ObjectGuid> members;
+    if (run)
+        members = run->Players;
+    else
+    {
+        uint32 size = _rng.Range<uint32>(1, MAX_PARTY_SIZE);
+        for (uint32 i = 0; i < size; ++i)
+            members.push_back(NewPlayer().Guid);
+    }
+
+    const SimDungeon* dungeon = &_dungeons[_rng.Below(static_cast<uint32>(_dungeons.size()))];
+    if (run)
+        while (dungeon->MapId == run->PrevMap)
+            dungeon = &_dungeons[_rng.Below(static_cast<uint32>(_dungeons.size()))];
+
+    auto map = std::make_unique<MockMap>();
+    map->MapId      = dungeon->MapId;
+    map->InstanceId = _nextInstanceId++;
+
+    uint32 sid = _nextSessionId++;
+    Session& s = _activeSessions[sid];
+    s.SessionId      = sid;
+    s.LeaderGuid     = members.front();
+    s.DifficultyId   = _rng.Below(static_cast<uint32>(_difficulties.size()));
+    s.ThemeId        = _rng.Below(static_cast<uint32>(_themes.size()));
+    s.MapId          = dungeon->MapId;
+    s.RoguelikeRunId = run ? run->RunId : 0;
+    s.StartTime      = _now;
+    s.Seed           = _rng.Next();
+    s.Rng.Seed(s.Seed);
+
+    uint32 levelSum = 0;
+    for (ObjectGuid g : members)
+    {
+        MockPlayer& p = _players[g];
+        p.Map = map.get();
+        p.Alive = true;
+        p.InCombat = false;
+        levelSum += p.Level;
+
+        PlayerSessionData pd;
+        pd.PlayerGuid = g;
+        s.Players.push_back(pd);
+        s.UpdatePresence(s.Players.back(), true, true, false);
+        _playerToSession[g] = sid;
+    }
+    s.EffectiveLevel = static_cast<uint8>(levelSum / members.size());
+    s.LevelBandMin   = static_cast<uint8>(std::max<int>(1, s.EffectiveLevel - 3));
+    s.LevelBandMax   = static_cast<uint8>(std::min<int>(MAX_LEVEL + 3, s.EffectiveLevel + 3));
+    s.State          = SessionState::InProgress;
+
+    _scripts[sid].InstanceId = map->InstanceId;
+    _maps[map->InstanceId] = std::move(map);
+    ++_counters.Created;
+    return sid;
+}
+
+std::vector<MockPlayer*> Simulator::ResolveParty(const Session& s)
+{
+    std::vector<MockPlayer*> party;
+    party.reserve(s.Players.size());
+    for (const auto& pd : s.Players)
+    {
+        auto it = _players.find(pd.PlayerGuid);
+        party.push_back(it == _players.end() ? nullptr : &it->second);
+    }
+    return party;
+}
+
+void Simulator::ApplyPresenceEvents()
+{
+    for (const PresenceEvent& ev : _presence)
+    {
+        auto pit = _playerToSession.find(ev.Guid);
+        if (pit == _playerToSession.end())
+            continue;
+        auto sit = _activeSessions.find(pit->second);
+        if (sit == _activeSessions.end())
+            continue;
+        if (PlayerSessionData* pd = sit->second.GetPlayerData(ev.Guid))
+            sit->second.UpdatePresence(*pd, true, ev.Alive, ev.InCombat);
+    }
+    _presence.clear();
+}
+
+MockCreature* Simulator::Summon(MockMap& map, uint32 entry, const Position& pos, float distance,
+                                uint8 level, float hpMult, float dmgMult, bool elite)
+{
+    MockCreature c;
+    c.Guid     = ObjectGuid(_nextGuid++);
+    c.Entry    = entry;
+    c.Pos      = pos;
+    c.Distance = distance;
+    c.Elite    = elite;
+
+    // ApplyLevelAndStats
+    const ClassLevelStatEntry& base = _levelStats[std::min<uint32>(level, MAX_LEVEL + 3)];
+    c.MaxHealth = ScaleCreatureHealth(&base, 0, hpMult);
+    ScaleCreatureDamage(base, 2000, dmgMult, c.MinDamage, c.MaxDamage);
+
+    return &map.Creatures.emplace(c.Guid, c).first->second;
+}
+
+uint32 Simulator::StreamPopulation(Session& s, MockMap& map, float progress)
+{
+    float frontier = _cfg.StreamAhead ? progress + static_cast<float>(_cfg.StreamAhead)
+                                      : std::numeric_limits<float>::max();
+    if (frontier <= s.StreamFrontier)
+        return 0;
+    s.StreamFrontier = frontier;
+
+    PartyScript& script = _scripts[s.SessionId];
+    uint32 spawned = 0;
+    while (s.NextPlanned < s.SpawnPlan.size())
+    {
+        const PlannedSpawn& ps = s.SpawnPlan[s.NextPlanned];
+        if (ps.Distance > s.StreamFrontier)
+            break;
+        ++s.NextPlanned;
+
+        const SpawnPoint& sp = (*s.SpawnPoints)[ps.PointIndex];
+        uint8 level = static_cast<uint8>(s.Rng.Range<uint32>(s.LevelBandMin, s.LevelBandMax));
+        MockCreature* c = Summon(map, ps.Entry, sp.Pos, sp.DistanceFromEntrance, level,
+                                 s.HealthMult * ps.HpMult, s.DamageMult * ps.DmgMult, ps.IsElite);
+        s.SpawnedCreatures.Add(c->Guid, ps.Entry, ps.IsElite ? SPAWN_ELITE : 0, static_cast<uint16>(ps.PackId));
+        script.Trash.push_back(c->Guid);
+        ++spawned;
+    }
+    return spawned;
+}
+
+void Simulator::PopulateDungeon(Session& s, MockMap& map)
+{
+    const SimDifficulty& diff = _difficulties[s.DifficultyId];
+    const std::vector<uint32>& theme = _themes[s.ThemeId];
+
+    s.Rng.Seed(s.Seed);
+    for (const SimDungeon& d : _dungeons)
+        if (d.MapId == s.MapId)
+            s.SpawnPoints = d.Points;
+    const std::vector<SpawnPoint>& points = *s.SpawnPoints;
+
+    float party = PartyScaling(static_cast<uint32>(s.Players.size()), 0.5f, 0.25f);
+    s.HealthMult     = diff.HealthMult * party;
+    s.DamageMult     = diff.DamageMult * party;
+    s.BossDamageMult = party;
+    if (s.RoguelikeRunId)
+    {
+        uint32 tier = _runs[s.RoguelikeRunId].Tier;
+        s.HealthMult     *= TierScaling(tier, 0.10f, 5, 1.15f);
+        s.DamageMult     *= TierScaling(tier, 0.08f, 5, 1.15f);
+        s.BossDamageMult *= TierScaling(tier, 0.08f, 5, 1.15f);
+    }
+
+    uint32 trashPoints = 0;
+    for (const auto& sp : points)
+        if (!sp.IsBossPosition) ++trashPoints;
+
+    uint32 budgetLeft = _cfg.LiveBudget
+        ? (_cfg.LiveBudget > _liveBudgetUsed ? _cfg.LiveBudget - _liveBudgetUsed : 0) : UINT32_MAX;
+    PopulationPlan plan = PlanPopulation(trashPoints, diff.MobCountMult, 1.0f, budgetLeft, _cfg.MinDensity);
+
+    std::vector<bool> used(points.size(), false);
+    uint32 trashIndex = 0;
+    for (size_t i = 0; i < points.size(); ++i)
+        if (!points[i].IsBossPosition)
+            used[i] = KeepSpreadPoint(trashIndex++, trashPoints, plan.Placed);
+
+    uint32 packCount = 0;
+    std::vector<uint32> pointPack(points.size(), 0);
+    std::vector<float>  packDistance;
+    {
+        std::vector<PackPoint> packPoints;
+        std::vector<size_t>    packIndex;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            if (points[i].IsBossPosition || !used[i]) continue;
+            packPoints.push_back({ points[i].Pos.GetPositionX(), points[i].Pos.GetPositionY(), points[i].Pos.GetPositionZ() });
+            packIndex.push_back(i);
+        }
+        std::vector<uint32> packOf;
+        packCount = ClusterPacks(packPoints, _cfg.PackRadius, _cfg.PackMaxSize, packOf);
+        packDistance.assign(packCount, -1.0f);
+        for (size_t i = 0; i < packIndex.size(); ++i)
+        {
+            pointPack[packIndex[i]] = packOf[i];
+            if (packDistance[packOf[i]] < 0.0f)
+                packDistance[packOf[i]] = points[packIndex[i]].DistanceFromEntrance;
+        }
+    }
+
+    auto pickTrash = [&](const CreaturePool& pool) -> uint32
+    {
+        uint32 candidates = 0;
+        uint32 entry = PickPoolEntry(pool, &theme, s.Rng, &candidates);
+        return candidates ? entry : PickPoolEntry(pool, nullptr, s.Rng);
+    };
+
+    s.SpawnPlan.clear();
+    s.NextPlanned    = 0;
+    s.StreamFrontier = 0.0f;
+    std::vector<uint32> packSize(packCount, 0);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        if (points[i].IsBossPosition || !used[i]) continue;
+        uint32 packId = pointPack[i];
+        uint32 entry  = pickTrash(_pools.Trash);
+        if (!entry) continue;
+
+        bool isElite = s.Rng.Chance(_cfg.EliteChance);
+        ++packSize[packId];
+
+        PlannedSpawn ps;
+        ps.PointIndex = static_cast<uint32>(i);
+        ps.Entry      = entry;
+        ps.PackId     = packId;
+        ps.HpMult     = (isElite ? 2.0f : 1.0f) * plan.Toughness;
+        ps.DmgMult    = isElite ? 1.5f : 1.0f;
+        ps.IsElite    = isElite;
+        s.SpawnPlan.push_back(ps);
+    }
+    for (auto& ps : s.SpawnPlan)
+        ps.Distance = packDistance[ps.PackId];
+    std::stable_sort(s.SpawnPlan.begin(), s.SpawnPlan.end(),
+        [](const PlannedSpawn& a, const PlannedSpawn& b) { return a.PackId < b.PackId; });
+
+    s.TotalMobs  = static_cast<uint32>(s.SpawnPlan.size());
+    s.TotalPacks = static_cast<uint32>(std::count_if(packSize.begin(), packSize.end(), [](uint32 n) { return n >= 2; }));
+
+    StreamPopulation(s, map, 0.0f);
+
+    uint32 rares = 0;
+    if (s.Rng.Chance(_cfg.RareChance))
+    {
+        const SpawnPoint& sp = points[s.Rng.Range<size_t>(points.size() / 3, points.size() * 2 / 3)];
+        if (uint32 entry = pickTrash(_pools.Elites))
+        {
+            MockCreature* r = Summon(map, entry, sp.Pos, sp.DistanceFromEntrance, s.EffectiveLevel,
+                                     s.HealthMult * 4.0f, s.DamageMult * 2.0f, true);
+            s.SpawnedCreatures.Add(r->Guid, entry, SPAWN_ELITE | SPAWN_RARE);
+            ++rares;
+        }
+    }
+
+    uint32 bosses = 0;
+    for (const auto& sp : points)
+    {
+        if (!sp.IsBossPosition || bosses >= _cfg.BossCount)
+            continue;
+        uint32 candidates = 0;
+        uint32 entry = PickPoolEntry(_pools.DungeonBosses, &theme, s.Rng, &candidates);
+        if (!candidates)
+            entry = PickPoolEntry(_pools.DungeonBosses, nullptr, s.Rng);
+        if (!entry)
+            continue;
+        MockCreature* b = Summon(map, entry, sp.Pos, sp.DistanceFromEntrance, s.EffectiveLevel,
+                                 s.HealthMult * 8.0f, s.BossDamageMult * 1.5f, true);
+        s.SpawnedCreatures.Add(b->Guid, entry, SPAWN_ELITE | SPAWN_BOSS);
+        ++bosses;
+    }
+    s.TotalBosses = bosses;
+
+    s.BudgetCharge = s.TotalMobs + rares + bosses;
+    _liveBudgetUsed += s.BudgetCharge;
+}
+
+void Simulator::FillCreatureLoot(const Session& s, const std::vector<MockPlayer*>& party, uint32 idx)
+{
+    DMRng& rng = ThreadRng();
+    std::vector<uint32> classes;
+    for (MockPlayer* p : party)
+        if (p && p->Alive)
+            classes.push_back(p->Class);
+    uint32 lootClass = classes.empty() ? 0 : classes[rng.Below(static_cast<uint32>(classes.size()))];
+
+    const SpawnRoster& roster = s.SpawnedCreatures;
+    auto add = [&](uint8 minQ, uint8 maxQ, bool eqOnly)
+    {
+        return PickLootItem(_pools.Loot, s.EffectiveLevel, minQ, maxQ, eqOnly, eqOnly ? lootClass : 0, rng).Entry != 0;
+    };
+
+    if (roster.Has(idx, SPAWN_BOSS))
+    {
+        if (!add(3, 3, true)) add(2, 3, true);
+        if (!add(3, 3, true)) add(2, 3, true);
+    }
+    else if (roster.Has(idx, SPAWN_RARE))
+    {
+        if (!add(3, 3, true)) add(2, 3, true);
+    }
+    else if (roster.Has(idx, SPAWN_ELITE))
+    {
+        if (rng.Chance(40) && !add(2, 2, true))
+            add(2, 2, false);
+    }
+    else
+    {
+        if (rng.Chance(15)) add(0, 1, false);
+        if (rng.Chance(3))  add(2, 2, true);
+    }
+}
+
+void Simulator::QueueKillXP(Session& s, const std::vector<MockPlayer*>& party, bool isBoss, bool isElite)
+{
+    uint32 units = isBoss ? 10 : isElite ? 2 : 1;
+    for (size_t k = 0; k < party.size() && k < s.Players.size(); ++k)
+        if (party[k] && party[k]->Alive && party[k]->Level < MAX_LEVEL)
+            s.QueueKillXP(s.Players[k], ((party[k]->Level * 5) + 45) * units);
+}
+
+void Simulator::FlushKillCredit(Session& s, const std::vector<MockPlayer*>& party)
+{
+    if (!s.PendingKillXP && !s.PendingMobKills)
+        return;
+
+    if (s.PendingKillXP)
+        for (size_t k = 0; k < party.size() && k < s.Players.size(); ++k)
+        {
+            PlayerSessionData& pd = s.Players[k];
+            if (pd.PendingKillXP && party[k] && party[k]->Level < MAX_LEVEL)
+                party[k]->XP += pd.PendingKillXP;
+            pd.PendingKillXP = 0;
+        }
+
+    if (s.PendingMobKills)
+    {
+        char buf[160];
+        snprintf(buf, sizeof(buf),
+            "|cFF00FF00[Dungeon Master]|r |cFFFFFFFF%u|r %s slain, |cFFFFFFFF%u/%u|r",
+            s.PendingMobKills, s.PendingMobKills != 1 ? "enemies" : "enemy", s.MobsKilled, s.TotalMobs);
+        std::string packet(buf);    // serialized once, as ChatBroadcast does
+        (void)packet;
+    }
+
+    s.PendingKillXP   = 0;
+    s.PendingMobKills = 0;
+}
+
+void Simulator::DistributeRewards(const Session& s)
+{
+    DMRng& rng = ThreadRng();
+    for (const auto& pd : s.Players)
+    {
+        auto it = _players.find(pd.PlayerGuid);
+        if (it == _players.end())
+            continue;
+        MockPlayer& p = it->second;
+        p.Gold += 50000 + s.MobsKilled * 50 + s.BossesKilled * 10000;
+        if (rng.Chance(80))
+        {
+            uint8 quality = rng.Chance(15) ? 4 : rng.Chance(40) ? 3 : 2;
+            if (PickRewardItem(_pools.Rewards, p.Level, quality, p.Class, rng).Entry)
+                ++p.Items;
+        }
+    }
+}
+
+// Creatures leave with the instance; players go home and are retired
+void Simulator::ReleaseSession(Session& s)
+{
+    _liveBudgetUsed -= std::min(_liveBudgetUsed, s.BudgetCharge);
+    if (s.InstanceId)
+        _instanceToSession.erase(s.InstanceId);
+    for (const auto& pd : s.Players)
+    {
+        _playerToSession.erase(pd.PlayerGuid);
+        auto it = _players.find(pd.PlayerGuid);
+        if (it != _players.end())
+        {
+            it->second.Map = nullptr;
+            it->second.Alive = true;
+            it->second.InCombat = false;
+        }
+    }
+    auto sit = _scripts.find(s.SessionId);
+    if (sit != _scripts.end())
+    {
+        _maps.erase(sit->second.InstanceId);
+        _scripts.erase(sit);
+    }
+}
+
+void Simulator::EndSession(uint32 sid, bool success)
+{
+    auto it = _activeSessions.find(sid);
+    if (it == _activeSessions.end())
+        return;
+    Session& s = it->second;
+    FlushKillCredit(s);
+    if (success)
+    {
+        DistributeRewards(s);
+        ++_counters.Completed;
+    }
+    else
+        ++_counters.Failed;
+
+    ReleaseSession(s);
+    for (const auto& pd : s.Players)
+        _players.erase(pd.PlayerGuid);
+    _activeSessions.erase(it);
+}
+
+// RoguelikeMgr::OnDungeonCompleted: rewards, next tier, next dungeon
+void Simulator::CompleteFloor(uint32 runId, uint32 sid)
+{
+    auto rit = _runs.find(runId);
+    auto sit = _activeSessions.find(sid);
+    if (rit == _runs.end() || sit == _activeSessions.end())
+        return;
+
+    RunState& run = rit->second;
+    FlushKillCredit(sit->second);
+    DistributeRewards(sit->second);
+    run.PrevMap = sit->second.MapId;
+    ReleaseSession(sit->second);
+    _activeSessions.erase(sit);
+
+    ++run.Floors;
+    ++run.Tier;
+    run.Affixes = run.Tier >= 10 ? 3 : run.Tier >= 7 ? 2 : run.Tier >= 3 ? 1 : 0;
+    ++_counters.Floors;
+
+    run.SessionId = CreateSession(&run);
+    --_counters.Created;        // the same run, not a new session from the NPC
+}
+
+void Simulator::EndRun(uint32 runId)
+{
+    auto rit = _runs.find(runId);
+    if (rit == _runs.end())
+        return;
+    auto sit = _activeSessions.find(rit->second.SessionId);
+    if (sit != _activeSessions.end())
+    {
+        FlushKillCredit(sit->second);
+        ReleaseSession(sit->second);
+        _activeSessions.erase(sit);
+        ++_counters.Failed;
+    }
+    for (ObjectGuid g : rit->second.Players)
+        _players.erase(g);
+    _runs.erase(rit);
+    ++_counters.RunsEnded;
+}
+
+// OnCreatureDeathHook + HandleCreatureDeath
+void Simulator::OnCreatureKilled(Session& s, MockCreature& c)
+{
+    c.Alive = false;
+    SpawnRoster& roster = s.SpawnedCreatures;
+    uint32 i = roster.Find(c.Guid);
+    if (i == SpawnRoster::NOT_FOUND)
+        return;
+
+    bool isBoss = roster.Has(i, SPAWN_BOSS);
+    roster.Claim(i, SPAWN_DEAD);
+    std::vector<MockPlayer*> party = ResolveParty(s);
+    if (roster.Claim(i, SPAWN_LOOT_FILLED))
+        FillCreatureLoot(s, party, i);
+    if (roster.Claim(i, SPAWN_KILL_CREDITED))
+    {
+        QueueKillXP(s, party, isBoss, roster.Has(i, SPAWN_ELITE));
+        if (isBoss)
+        {
+            PendingPhaseCheck ppc;
+            ppc.DeathPos  = c.Pos;
+            ppc.DeathTime = _now;
+            ppc.OrigEntry = roster.GetEntry(i);
+            s.PendingPhaseChecks.push_back(ppc);
+            ++_counters.BossesKilled;
+        }
+        else
+        {
+            s.CreditMobKill();
+            ++_counters.TrashKilled;
+        }
+    }
+}
+
+// HandlePlayerDeath
+void Simulator::OnPlayerDied(Session& s, MockPlayer& p)
+{
+    p.Alive    = false;
+    p.InCombat = false;
+    ++_counters.Deaths;
+
+    ApplyPresenceEvents();
+    if (PlayerSessionData* pd = s.GetPlayerData(p.Guid))
+    {
+        s.CreditDeath(*pd);
+        s.UpdatePresence(*pd, true, false, false);
+    }
+
+    if (!s.IsPartyWiped())
+        return;
+
+    ++s.Wipes;
+    ++_counters.Wipes;
+    s.State   = SessionState::Failed;
+    s.EndTime = _now;
+    if (s.RoguelikeRunId)
+    {
+        _runs[s.RoguelikeRunId].Wiped = true;
+        return;
+    }
+
+    for (MockPlayer* m : ResolveParty(s))
+        if (m)
+        {
+            m->Alive = true;
+            m->Map   = nullptr;
+            QueuePresence(*m);
+        }
+}
+
+// The parties: advance, pull the next pack, fight the boss, sometimes die
+void Simulator::WorldStep(std::array<uint32, MAX_SIM_PHASES>& acc)
+{
+    float deathChance = _cfg.DeathRate / 3600.0f;
+    float wipeChance  = _cfg.WipeRate / 3600.0f;
+
+    for (auto& [sid, s] : _activeSessions)
+    {
+        if (s.State != SessionState::InProgress || (s.TotalMobs == 0 && s.TotalBosses == 0))
+            continue;
+
+        std::vector<MockPlayer*> party = ResolveParty(s);
+        MockMap* map = nullptr;
+        for (MockPlayer* p : party)
+            if (p && p->Map && p->Alive)
+                map = p->Map;
+        if (!map)
+            continue;
+
+        PartyScript& script = _scripts[sid];
+        bool wasFighting = script.Fighting;
+        script.Fighting = false;
+
+        while (!script.Trash.empty())
+        {
+            MockCreature* c = map->GetCreature(script.Trash.front());
+            if (c && c->Alive)
+                break;
+            script.Trash.pop_front();
+        }
+
+        if (!script.Trash.empty())
+        {
+            MockCreature* target = map->GetCreature(script.Trash.front());
+            if (target->Distance <= script.Progress + ENGAGE_RANGE)
+            {
+                script.Fighting = true;
+                script.KillCredit += _cfg.KillRate;
+                while (script.KillCredit >= 1.0f && !script.Trash.empty())
+                {
+                    script.KillCredit -= 1.0f;
+                    MockCreature* c = map->GetCreature(script.Trash.front());
+                    script.Trash.pop_front();
+                    if (!c || !c->Alive)
+                        continue;
+                    PhaseTimer hook(acc, SIM_HOOKS);
+                    OnCreatureKilled(s, *c);
+                }
+            }
+            else
+                script.Progress = std::min(script.Progress + MOVE_PER_SEC, target->Distance);
+        }
+        else if (s.NextPlanned < s.SpawnPlan.size())
+            script.Progress += MOVE_PER_SEC;
+        else
+        {
+            // Bosses (and promoted phase creatures) still standing
+            MockCreature* boss = nullptr;
+            const SpawnRoster& roster = s.SpawnedCreatures;
+            for (uint32 i = 0; i < roster.size() && !boss; ++i)
+                if (roster.Has(i, SPAWN_BOSS) && !roster.Has(i, SPAWN_DEAD))
+                    if (MockCreature* c = map->GetCreature(roster.GetGuid(i)); c && c->Alive)
+                        boss = c;
+
+            if (boss && boss->Distance > script.Progress + ENGAGE_RANGE)
+                script.Progress = std::min(script.Progress + MOVE_PER_SEC, boss->Distance);
+            else if (boss)
+            {
+                script.Fighting = true;
+                if (++script.BossFight >= _cfg.BossTime)
+                {
+                    script.BossFight = 0;
+                    // The boss script summons its next phase as it dies
+                    if (_rng.Chance(_cfg.PhaseChance))
+                        Summon(*map, boss->Entry + 1, boss->Pos, boss->Distance, s.EffectiveLevel,
+                               s.HealthMult * 8.0f, s.BossDamageMult, true);
+                    PhaseTimer hook(acc, SIM_HOOKS);
+                    OnCreatureKilled(s, *boss);
+                }
+            }
+        }
+
+        if (script.Fighting != wasFighting)
+            for (MockPlayer* p : party)
+                if (p && p->Alive)
+                {
+                    p->InCombat = script.Fighting;
+                    QueuePresence(*p);
+                }
+
+        if (!script.Fighting)
+            continue;
+
+        bool wipe = _rng.Float(0.0f, 1.0f) < wipeChance;
+        for (MockPlayer* p : party)
+        {
+            if (!p || !p->Alive || p->Map != map)
+                continue;
+            if (wipe || _rng.Float(0.0f, 1.0f) < deathChance)
+            {
+                PhaseTimer hook(acc, SIM_HOOKS);
+                OnPlayerDied(s, *p);
+                if (s.State == SessionState::Failed)
+                    break;
+            }
+        }
+    }
+}
+
+// DungeonMasterMgr::Update's once-a-second body, then RoguelikeMgr's wipe handling
+void Simulator::Tick(std::array<uint32, MAX_SIM_PHASES>& acc)
+{
+    std::vector<std::pair<uint32, bool>>   toEnd;
+    std::vector<std::pair<uint32, uint32>> roguelikeCompleted;
+
+    ApplyPresenceEvents();
+
+    for (auto& [sid, session] : _activeSessions)
+    {
+        std::vector<MockPlayer*> party;
+        MockPlayer* ref = nullptr;
+        {
+            PhaseTimer t(acc, SIM_RESOLVE);
+            party = ResolveParty(session);
+            for (MockPlayer* p : party)
+                if (p && p->Map && p->Map->MapId == session.MapId) { ref = p; break; }
+        }
+
+        if (session.IsActive())
+        {
+            if (ref)
+            {
+                MockMap& map = *ref->Map;
+                if (session.InstanceId == 0)
+                    session.InstanceId = map.InstanceId;
+                if (_instanceToSession.find(session.InstanceId) == _instanceToSession.end())
+                    _instanceToSession[session.InstanceId] = session.SessionId;
+
+                if (session.TotalMobs == 0 && session.TotalBosses == 0)
+                {
+                    PhaseTimer t(acc, SIM_POPULATE);
+                    PopulateDungeon(session, map);
+                }
+
+                std::set<ObjectGuid> ourGuids;
+                {
+                    PhaseTimer t(acc, SIM_DEATH_POLL);
+                    SpawnRoster& roster = session.SpawnedCreatures;
+                    ourGuids.insert(roster.GetGuids().begin(), roster.GetGuids().end());
+                    for (uint32 i = roster.NextUnprocessed(0); i < roster.size(); i = roster.NextUnprocessed(i + 1))
+                    {
+                        MockCreature* c = map.GetCreature(roster.GetGuid(i));
+                        if (!c || !c->Alive)
+                        {
+                            roster.Claim(i, SPAWN_DEAD);
+                            bool isBoss = roster.Has(i, SPAWN_BOSS);
+                            if (roster.Claim(i, SPAWN_LOOT_FILLED) && c)
+                                FillCreatureLoot(session, party, i);
+                            if (roster.Claim(i, SPAWN_KILL_CREDITED))
+                            {
+                                QueueKillXP(session, party, isBoss, roster.Has(i, SPAWN_ELITE));
+                                if (isBoss)
+                                {
+                                    PendingPhaseCheck ppc;
+                                    if (c)
+                                        ppc.DeathPos = c->Pos;
+                                    ppc.DeathTime = _now;
+                                    ppc.OrigEntry = roster.GetEntry(i);
+                                    session.PendingPhaseChecks.push_back(ppc);
+                                }
+                                else
+                                    session.CreditMobKill();
+                            }
+                        }
+                    }
+                }
+
+                if (session.NextPlanned < session.SpawnPlan.size())
+                {
+                    PhaseTimer t(acc, SIM_STREAM);
+                    StreamPopulation(session, map, _scripts[sid].Progress);
+                }
+
+                {
+                    PhaseTimer t(acc, SIM_PHASE_CHECKS);
+                    for (auto& ppc : session.PendingPhaseChecks)
+                    {
+                        if (ppc.Resolved || _now - ppc.DeathTime < 5)
+                            continue;
+                        ppc.Resolved = true;
+
+                        // The grid scan around the boss covers the whole instance
+                        bool phaseCreatureFound = false;
+                        for (auto& [guid, nc] : map.Creatures)
+                        {
+                            if (!nc.Alive || !nc.Elite || ourGuids.count(guid))
+                                continue;
+                            if (nc.Pos.GetExactDist(&ppc.DeathPos) > 40.0f)
+                                continue;
+                            session.SpawnedCreatures.Add(guid, nc.Entry, SPAWN_ELITE | SPAWN_BOSS);
+                            ourGuids.insert(guid);
+                            phaseCreatureFound = true;
+                            ++_counters.Promotions;
+                            break;
+                        }
+
+                        if (!phaseCreatureFound)
+                        {
+                            session.CreditBossKill();
+                            if (session.IsActive() && session.TotalBosses > 0
+                                && session.BossesKilled >= session.TotalBosses)
+                            {
+                                session.State   = SessionState::Completed;
+                                session.EndTime = _now;
+                                break;
+                            }
+                        }
+                    }
+                    session.PendingPhaseChecks.erase(
+                        std::remove_if(session.PendingPhaseChecks.begin(), session.PendingPhaseChecks.end(),
+                            [](const PendingPhaseCheck& p) { return p.Resolved; }),
+                        session.PendingPhaseChecks.end());
+                }
+                // Stray sweep: mock instances hold no DB-spawned creatures to sweep
+            }
+
+            {
+                PhaseTimer t(acc, SIM_AUTO_REZ);
+                if (session.IsActive() && session.HasDeadPlayers() && !session.IsGroupInCombat())
+                    for (MockPlayer* p : party)
+                        if (p && !p->Alive && p->Map && p->Map->MapId == session.MapId)
+                        {
+                            p->Alive = true;
+                            QueuePresence(*p);      // OnPlayerResurrect
+                            _scripts[sid].Progress = 0.0f;
+                        }
+            }
+        }
+
+        {
+            PhaseTimer t(acc, SIM_KILL_CREDIT);
+            FlushKillCredit(session, party);
+        }
+
+        if (session.State == SessionState::Completed)
+        {
+            uint32 delay = session.RoguelikeRunId ? _cfg.TransitionDelay : _cfg.CompletionDelay;
+            uint64 elapsed = _now - session.EndTime;
+            if (elapsed >= delay)
+            {
+                if (session.RoguelikeRunId)
+                    roguelikeCompleted.push_back({ session.RoguelikeRunId, sid });
+                else
+                    toEnd.emplace_back(sid, true);
+                continue;
+            }
+        }
+
+        if (session.State == SessionState::Failed)
+        {
+            if (session.RoguelikeRunId)
+                continue;
+            if (_now - session.EndTime >= 2)
+            {
+                toEnd.emplace_back(sid, false);
+                continue;
+            }
+        }
+
+        if (session.IsActive() && _now - session.StartTime >= 15 && !ref)
+        {
+            session.State = SessionState::Abandoned;
+            toEnd.emplace_back(sid, false);
+        }
+    }
+
+    PhaseTimer t(acc, SIM_END_TRANSITION);
+    for (const auto& [id, ok] : toEnd)
+        EndSession(id, ok);
+    for (const auto& [runId, sessId] : roguelikeCompleted)
+        CompleteFloor(runId, sessId);
+
+    // RoguelikeMgr::Update ends runs that wiped
+    std::vector<uint32> wiped;
+    for (const auto& [runId, run] : _runs)
+        if (run.Wiped)
+            wiped.push_back(runId);
+    for (uint32 runId : wiped)
+        EndRun(runId);
+}
+
+// The part of each session .dm mem and .dm perf load count, plus the lookup maps
+uint64 Simulator::StateBytes() const
+{
+    uint64 bytes = HeapBytes(_activeSessions) + HeapBytes(_playerToSession) + HeapBytes(_instanceToSession);
+    for (const auto& [sid, s] : _activeSessions)
+        bytes += HeapBytes(s.Players) + s.SpawnedCreatures.GetHeapBytes()
+               + HeapBytes(s.SpawnPlan) + HeapBytes(s.PendingPhaseChecks);
+    return bytes;
+}
+
+// One simulated second: players act on the map threads, then the module ticks
+void Simulator::Step(bool measure, LoadResult* out)
+{
+    std::array<uint32, MAX_SIM_PHASES> acc{};
+    WorldStep(acc);
+
+    AllocCounts before = GetAllocCounts();
+    Clock::time_point start = Clock::now();
+    Tick(acc);
+    uint32 micros = MicrosSince(start);
+    AllocCounts after = GetAllocCounts();
+
+    if (measure && out)
+    {
+        out->Ticks.push_back(micros);
+        for (uint8 i = 0; i < MAX_SIM_PHASES; ++i)
+            out->Phases[i].push_back(acc[i]);
+        out->TickAllocs += after.Calls - before.Calls;
+        out->SessionTicks += _activeSessions.size();
+        for (const auto& [sid, s] : _activeSessions)
+            out->CreatureTicks += s.SpawnedCreatures.size();
+        out->PeakStateBytes = std::max(out->PeakStateBytes, StateBytes());
+    }
+
+    ++_now;
+    Replenish();        // new parties talk to the NPC between ticks
+}
+
+uint32 Percentile(std::vector<uint32> v, uint32 pct)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    return v[(v.size() - 1) * pct / 100];
+}
+
+LoadResult RunLoad(const SimConfig& cfg, const BenchPools& pools, uint32 sessions)
+{
+    LoadResult r;
+    r.Sessions = sessions;
+
+    Simulator sim(cfg, pools, 0);
+
+    // Ramp up so sessions are spread over their lifecycles, not populated in one tick
+    for (uint32 t = 0; t < cfg.Warmup; ++t)
+    {
+        // Full load by half-way through the warm-up
+        uint64 ramp = uint64(sessions) * (t + 1) * 2 / std::max<uint32>(1, cfg.Warmup);
+        sim.SetTarget(static_cast<uint32>(std::clamp<uint64>(ramp, 1, sessions)));
+        sim.Step(false, nullptr);
+    }
+    sim.SetTarget(sessions);
+
+    Counters before = sim.GetCounters();
+    ResetAllocPeak();
+    for (uint32 t = 0; t < cfg.Duration; ++t)
+        sim.Step(true, &r);
+    r.PeakHeapBytes = GetAllocCounts().Peak;
+
+    const Counters& after = sim.GetCounters();
+    r.Totals.Created      = after.Created      - before.Created;
+    r.Totals.Completed    = after.Completed    - before.Completed;
+    r.Totals.Failed       = after.Failed       - before.Failed;
+    r.Totals.Floors       = after.Floors       - before.Floors;
+    r.Totals.RunsEnded    = after.RunsEnded    - before.RunsEnded;
+    r.Totals.TrashKilled  = after.TrashKilled  - before.TrashKilled;
+    r.Totals.BossesKilled = after.BossesKilled - before.BossesKilled;
+    r.Totals.Promotions   = after.Promotions   - before.Promotions;
+    r.Totals.Deaths       = after.Deaths       - before.Deaths;
+    r.Totals.Wipes        = after.Wipes        - before.Wipes;
+    return r;
+}
+
+bool ParseList(const char* text, std::vector<uint32>& out)
+{
+    out.clear();
+    const char* p = text;
+    while (*p)
+    {
+        char* end = nullptr;
+        unsigned long v = std::strtoul(p, &end, 10);
+        if (end == p || v == 0)
+            return false;
+        out.push_back(static_cast<uint32>(v));
+        p = (*end == ',') ? end + 1 : end;
+        if (*end && *end != ',')
+            return false;
+    }
+    return !out.empty();
+}
+
+bool ParseArgs(int argc, char** argv, SimConfig& c)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        auto value = [&](const char* flag) -> const char*
+        {
+            if (std::strcmp(argv[i], flag) != 0 || i + 1 >= argc)
+                return nullptr;
+            return argv[++i];
+        };
+        auto u = [](const char* v) { return static_cast<uint32>(std::strtoul(v, nullptr, 10)); };
+        auto f = [](const char* v) { return std::strtof(v, nullptr); };
+
+        if (const char* v = value("--sessions"))
+        {
+            if (!ParseList(v, c.SessionCounts))
+            {
+                std::fprintf(stderr, "--sessions expects a comma-separated list of counts\n");
+                return false;
+            }
+        }
+        else if (const char* v = value("--duration"))     c.Duration     = u(v);
+        else if (const char* v = value("--warmup"))       c.Warmup       = u(v);
+        else if (const char* v = value("--kill-rate"))    c.KillRate     = f(v);
+        else if (const char* v = value("--death-rate"))   c.DeathRate    = f(v);
+        else if (const char* v = value("--wipe-rate"))    c.WipeRate     = f(v);
+        else if (const char* v = value("--roguelike"))    c.RoguelikePct = u(v);
+        else if (const char* v = value("--boss-time"))    c.BossTime     = std::max<uint32>(1, u(v));
+        else if (const char* v = value("--stream-ahead")) c.StreamAhead  = u(v);
+        else if (const char* v = value("--budget"))       c.LiveBudget   = u(v);
+        else if (const char* v = value("--seed"))         c.Seed         = std::strtoull(v, nullptr, 10);
+        else
+        {
+            std::fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return c.Duration > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    SimConfig cfg;
+    if (!ParseArgs(argc, argv, cfg))
+        return 2;
+
+    BenchPools pools;
+    FillSyntheticPools(pools, cfg.Seed);
+
+    std::printf("Simulating %u s per load after %u s ramp-up; kills %.2f/s, deaths %.1f/h, wipes %.2f/h, "
+        "roguelike %u%%, budget %u\n\n", cfg.Duration, cfg.Warmup, cfg.KillRate, cfg.DeathRate, cfg.WipeRate,
+        cfg.RoguelikePct, cfg.LiveBudget);
+
+    std::vector<LoadResult> results;
+    std::printf("%8s %8s %8s %8s %8s %10s %10s %12s %10s\n", "sessions", "p50 us", "p99 us", "max us",
+        "mean us", "creat/ses", "allocs/t", "state KB pk", "heap MB pk");
+    for (uint32 n : cfg.SessionCounts)
+    {
+        LoadResult r = RunLoad(cfg, pools, n);
+        uint64 sum = 0;
+        for (uint32 t : r.Ticks)
+            sum += t;
+        std::printf("%8u %8u %8u %8u %8.0f %10.1f %10.0f %12.1f %10.1f\n", n,
+            Percentile(r.Ticks, 50), Percentile(r.Ticks, 99), Percentile(r.Ticks, 100),
+            static_cast<double>(sum) / r.Ticks.size(),
+            r.SessionTicks ? static_cast<double>(r.CreatureTicks) / r.SessionTicks : 0.0,
+            static_cast<double>(r.TickAllocs) / r.Ticks.size(),
+            r.PeakStateBytes / 1024.0, r.PeakHeapBytes / (1024.0 * 1024.0));
+        std::fflush(stdout);
+        results.push_back(std::move(r));
+    }
+
+    std::printf("\nPer-phase p99 / max (us per tick, summed over sessions; hooks run between ticks)\n");
+    std::printf("%8s", "sessions");
+    for (const char* name : PHASE_NAMES)
+        std::printf(" %15s", name);
+    std::printf("\n");
+    for (const LoadResult& r : results)
+    {
+        std::printf("%8u", r.Sessions);
+        for (uint8 i = 0; i < MAX_SIM_PHASES; ++i)
+        {
+            char cell[32];
+            snprintf(cell, sizeof(cell), "%u / %u", Percentile(r.Phases[i], 99), Percentile(r.Phases[i], 100));
+            std::printf(" %15s", cell);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("\nLifecycle over the measured window\n");
+    std::printf("%8s %8s %9s %7s %7s %9s %8s %7s %9s %7s %6s\n", "sessions", "created", "completed",
+        "failed", "floors", "runs end", "trash", "bosses", "promoted", "deaths", "wipes");
+    for (const LoadResult& r : results)
+        std::printf("%8u %8llu %9llu %7llu %7llu %9llu %8llu %7llu %9llu %7llu %6llu\n", r.Sessions,
+            (unsigned long long)r.Totals.Created, (unsigned long long)r.Totals.Completed,
+            (unsigned long long)r.Totals.Failed, (unsigned long long)r.Totals.Floors,
+            (unsigned long long)r.Totals.RunsEnded, (unsigned long long)r.Totals.TrashKilled,
+            (unsigned long long)r.Totals.BossesKilled, (unsigned long long)r.Totals.Promotions,
+            (unsigned long long)r.Totals.Deaths, (unsigned long long)r.Totals.Wipes);
+    return 0;
+}
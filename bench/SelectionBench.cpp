@@ -0,0 +1,234 @@
+/*
+ * mod-dungeon-master — bench/SelectionBench.cpp
+ * ns/op and allocations per call for the DMSelection pickers and the scaling
+ * math, over synthetic pools or CSV dumps (see BenchPools.h).
+ *
+ *   dm_selection_bench [--creatures f.csv] [--bosses f.csv] [--rewards f.csv]
+ *                      [--loot f.csv] [--min-time ms] [--seed n] [--filter text]
+ */
+
+#include "BenchAlloc.h"
+#include "BenchPools.h"
+#include "DMRandom.h"
+#include "DMSelection.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace DungeonMaster;
+
+namespace
+{
+
+// Results feed this so the optimizer cannot drop the calls
+volatile uint64 g_sink = 0;
+
+inline void Consume(uint64 v) { g_sink = g_sink + v; }
+
+struct Options
+{
+    std::string Creatures, Bosses, Rewards, Loot, Filter;
+    uint32 MinTimeMs = 200;
+    uint64 Seed      = 1;
+};
+
+// Per-call inputs, cycled so every call sees a different level and class
+struct CallInput
+{
+    uint8  Level;
+    uint8  Quality;
+    uint32 PlayerClass;
+    uint32 Tier;
+};
+
+constexpr uint32 INPUT_RING = 1024;
+
+struct Benchmark
+{
+    const char* Name;
+    std::function<void(uint64 iters)> Body;
+};
+
+void Run(const Benchmark& b, uint32 minTimeMs)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Grow the batch until it runs for at least min-time, like Google Benchmark
+    b.Body(16);     // warm-up
+    double targetNs = minTimeMs * 1e6;
+
+    uint64 iters = 1;
+    for (;;)
+    {
+        AllocCounts before = GetAllocCounts();
+        Clock::time_point start = Clock::now();
+        b.Body(iters);
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count());
+        AllocCounts after = GetAllocCounts();
+
+        if (ns >= targetNs || iters >= (1ull << 34))
+        {
+            std::printf("%-28s %12.1f %12.2f %12.1f %12llu\n", b.Name, ns / iters,
+                static_cast<double>(after.Calls - before.Calls) / iters,
+                static_cast<double>(after.Bytes - before.Bytes) / iters,
+                static_cast<unsigned long long>(iters));
+            return;
+        }
+
+        // Aim straight for the target once a batch takes measurable time
+        uint64 next = ns > 1e6 ? static_cast<uint64>(iters * (targetNs / ns) * 1.2) : iters * 10;
+        iters = std::max(next, iters + 1);
+    }
+}
+
+} // namespace
+
+static bool ParseArgs(int argc, char** argv, Options& o)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        auto value = [&](const char* flag) -> const char*
+        {
+            if (std::strcmp(argv[i], flag) != 0 || i + 1 >= argc)
+                return nullptr;
+            return argv[++i];
+        };
+
+        if (const char* v = value("--creatures"))     o.Creatures = v;
+        else if (const char* v = value("--bosses"))   o.Bosses    = v;
+        else if (const char* v = value("--rewards"))  o.Rewards   = v;
+        else if (const char* v = value("--loot"))     o.Loot      = v;
+        else if (const char* v = value("--filter"))   o.Filter    = v;
+        else if (const char* v = value("--min-time")) o.MinTimeMs = static_cast<uint32>(std::strtoul(v, nullptr, 10));
+        else if (const char* v = value("--seed"))     o.Seed      = std::strtoull(v, nullptr, 10);
+        else
+        {
+            std::fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt))
+        return 2;
+
+    BenchPools pools;
+    if ((!opt.Creatures.empty() && !LoadCreatureCsv(opt.Creatures, pools))
+        || (!opt.Bosses.empty() && !LoadBossCsv(opt.Bosses, pools))
+        || (!opt.Rewards.empty() && !LoadRewardCsv(opt.Rewards, pools))
+        || (!opt.Loot.empty() && !LoadLootCsv(opt.Loot, pools)))
+        return 1;
+    FillSyntheticPools(pools, opt.Seed);
+
+    std::printf("Pools: %u trash, %u elite, %u dungeon boss creatures; %zu reward, %zu loot items\n\n",
+        CountEntries(pools.Trash), CountEntries(pools.Elites), CountEntries(pools.DungeonBosses),
+        pools.Rewards.size(), pools.Loot.size());
+
+    DMRng rng(opt.Seed);
+    std::vector<CallInput> inputs(INPUT_RING);
+    static constexpr uint32 classes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 11 };
+    for (CallInput& in : inputs)
+    {
+        in.Level       = static_cast<uint8>(rng.Range<uint32>(10, 80));
+        in.Quality     = static_cast<uint8>(rng.Range<uint32>(2, 4));
+        in.PlayerClass = classes[rng.Below(10)];
+        in.Tier        = rng.Range<uint32>(1, 40);
+    }
+
+    // A two-type theme (Humanoid, Undead), as most of the stock themes are
+    const std::vector<uint32> theme = { 7, 6 };
+
+    // One dungeon's worth of trash points along a winding corridor
+    std::vector<PackPoint> points;
+    for (uint32 i = 0; i < 200; ++i)
+        points.push_back({ i * 3.0f + rng.Float(-4.0f, 4.0f), (i % 20) * 2.5f + rng.Float(-3.0f, 3.0f),
+                           rng.Float(-1.0f, 1.0f) });
+    std::vector<uint32> packOf;
+
+    ClassLevelStatEntry stats;
+    stats.BaseHP      = 9000;
+    stats.BaseDamage  = 120.0f;
+    stats.AttackPower = 700;
+
+    const std::vector<Benchmark> benchmarks =
+    {
+        { "PickPoolEntry/theme", [&](uint64 n) {
+            for (uint64 i = 0; i < n; ++i) Consume(PickPoolEntry(pools.Trash, &theme, rng)); } },
+        { "PickPoolEntry/any", [&](uint64 n) {
+            for (uint64 i = 0; i < n; ++i) Consume(PickPoolEntry(pools.Trash, nullptr, rng)); } },
+        { "SelectDungeonBoss", [&](uint64 n) {
+            // Themed pick with the any-type fallback, as SelectDungeonBoss does
+            for (uint64 i = 0; i < n; ++i)
+            {
+                uint32 candidates = 0;
+                uint32 entry = PickPoolEntry(pools.DungeonBosses, &theme, rng, &candidates);
+                if (!candidates)
+                    entry = PickPoolEntry(pools.DungeonBosses, nullptr, rng);
+                Consume(entry);
+            } } },
+        { "PickRewardItem", [&](uint64 n) {
+            for (uint64 i = 0; i < n; ++i)
+            {
+                const CallInput& in = inputs[i % INPUT_RING];
+                Consume(PickRewardItem(pools.Rewards, in.Level, in.Quality, in.PlayerClass, rng).Entry);
+            } } },
+        { "PickLootItem/gear", [&](uint64 n) {
+            for (uint64 i = 0; i < n; ++i)
+            {
+                const CallInput& in = inputs[i % INPUT_RING];
+                Consume(PickLootItem(pools.Loot, in.Level, 2, 4, true, in.PlayerClass, rng).Entry);
+            } } },
+        { "PickLootItem/any", [&](uint64 n) {
+            for (uint64 i = 0; i < n; ++i)
+            {
+                const CallInput& in = inputs[i % INPUT_RING];
+                Consume(PickLootItem(pools.Loot, in.Level, 0, 1, false, 0, rng).Entry);
+            } } },
+        { "ScoreItemForClass", [&](uint64 n) {
+            float sum = 0.0f;
+            for (uint64 i = 0; i < n; ++i)
+                sum += ScoreItemForClass(pools.Rewards[i % pools.Rewards.size()].Stats,
+                                         inputs[i % INPUT_RING].PlayerClass);
+            Consume(static_cast<uint64>(sum)); } },
+        { "ClusterPacks/200", [&](uint64 n) {
+            for (uint64 i = 0; i < n; ++i) Consume(ClusterPacks(points, 8.0f, 5, packOf)); } },
+        { "PlanPopulation/200", [&](uint64 n) {
+            for (uint64 i = 0; i < n; ++i)
+            {
+                PopulationPlan plan = PlanPopulation(200, 1.0f, LoadDensityScale(140, 100, 0.5f), 5000, 0.5f);
+                for (uint32 k = 0; k < 200; ++k)
+                    Consume(KeepSpreadPoint(k, 200, plan.Placed));
+            } } },
+        { "TierScaling", [&](uint64 n) {
+            float sum = 0.0f;
+            for (uint64 i = 0; i < n; ++i)
+                sum += TierScaling(inputs[i % INPUT_RING].Tier, 0.10f, 5, 1.15f);
+            Consume(static_cast<uint64>(sum)); } },
+        { "ScaleCreatureStats", [&](uint64 n) {
+            // Health and damage, the arithmetic of ApplyLevelAndStats
+            float lo = 0.0f, hi = 0.0f;
+            for (uint64 i = 0; i < n; ++i)
+            {
+                float mult = PartyScaling(1 + i % 5, 0.5f, 0.25f) * LinearTierScaling(inputs[i % INPUT_RING].Tier, 0.08f);
+                Consume(ScaleCreatureHealth(&stats, 0, mult));
+                ScaleCreatureDamage(stats, 2000, mult, lo, hi);
+                Consume(static_cast<uint64>(hi));
+            } } },
+    };
+
+    std::printf("%-28s %12s %12s %12s %12s\n", "Operation", "ns/op", "allocs/op", "bytes/op", "iterations");
+    for (const Benchmark& b : benchmarks)
+        if (opt.Filter.empty() || std::strstr(b.Name, opt.Filter.c_str()))
+            Run(b, std::max<uint32>(1, opt.MinTimeMs));
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * mod-dungeon-master — bench/shim/DatabaseEnv.h
+ * Stand-in for AzerothCore's DatabaseEnv.h: an in-memory dm_checkpoints table
+ * behind the CharacterDatabase calls DMCheckpoint.cpp makes. Async statements
+ * and transactions queue until RunPending, which can replay them out of order
+ * to model several async DB workers.
+ */
+
+#ifndef DM_BENCH_DATABASE_ENV_H
+#define DM_BENCH_DATABASE_ENV_H
+
+#include "Define.h"
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class Field
+{
+public:
+    explicit Field(std::string value) : _value(std::move(value)) { }
+
+    template <class T>
+    T Get() const
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            return _value;
+        else if constexpr (std::is_floating_point_v<T>)
+            return static_cast<T>(std::stod(_value));
+        else
+            return static_cast<T>(std::stoull(_value));
+    }
+
+private:
+    std::string _value;
+};
+
+class ResultSet
+{
+public:
+    explicit ResultSet(std::vector<std::vector<Field>> rows) : _rows(std::move(rows)) { }
+
+    Field* Fetch()   { return _rows[_row].data(); }
+    bool   NextRow() { return ++_row < _rows.size(); }
+
+private:
+    std::vector<std::vector<Field>> _rows;
+    size_t _row = 0;
+};
+
+using QueryResult = std::shared_ptr<ResultSet>;
+
+class Transaction
+{
+public:
+    void Append(const std::string& sql) { Statements.push_back(sql); }
+
+    std::vector<std::string> Statements;
+};
+
+using CharacterDatabaseTransaction = std::shared_ptr<Transaction>;
+
+// One table keyed on its first column, rows kept in column order. Queries
+// return every row, which is all CheckpointStore::Load asks for.
+class FakeDatabase
+{
+public:
+    void Execute(const std::string& sql) { _pending.push_back({ sql }); }
+
+    CharacterDatabaseTransaction BeginTransaction() { return std::make_shared<Transaction>(); }
+    void CommitTransaction(CharacterDatabaseTransaction trans) { _pending.push_back(trans->Statements); }
+
+    QueryResult Query(const std::string& /*sql*/)
+    {
+        if (Rows.empty())
+            return nullptr;
+        std::vector<std::vector<Field>> rows;
+        for (const auto& [key, columns] : Rows)
+        {
+            std::vector<Field> fields;
+            for (const std::string& c : columns)
+                fields.emplace_back(c);
+            rows.push_back(std::move(fields));
+        }
+        return std::make_shared<ResultSet>(std::move(rows));
+    }
+
+    // Runs the queued statements; `reverse` lets a later one overtake an earlier one
+    void RunPending(bool reverse = false)
+    {
+        if (reverse)
+            std::reverse(_pending.begin(), _pending.end());
+        for (const auto& batch : _pending)
+            for (const std::string& sql : batch)
+                Apply(sql);
+        _pending.clear();
+    }
+
+    std::map<uint64, std::vector<std::string>> Rows;
+
+private:
+    void Apply(const std::string& sql)
+    {
+        if (sql.rfind("REPLACE", 0) == 0)
+        {
+            size_t pos = sql.find(" VALUES ") + 8;
+            std::vector<std::string> columns;
+            std::string cur;
+            bool quoted = false;
+            for (; pos < sql.size(); ++pos)
+            {
+                char c = sql[pos];
+                if (c == '\'')
+                    quoted = !quoted;
+                else if (quoted)
+                    cur += c;
+                else if (c == '(')
+                {
+                    columns.clear();
+                    cur.clear();
+                }
+                else if (c == ',' || c == ')')
+                {
+                    columns.push_back(cur);
+                    cur.clear();
+                    if (c == ')')
+                        Rows[std::stoull(columns.front())] = columns;
+                }
+                else if (!std::isspace(static_cast<unsigned char>(c)))
+                    cur += c;
+            }
+        }
+        else if (sql.rfind("DELETE", 0) == 0)
+        {
+            size_t pos = sql.find("guid") + 4;
+            while (pos < sql.size())
+            {
+                if (!std::isdigit(static_cast<unsigned char>(sql[pos])))
+                {
+                    ++pos;
+                    continue;
+                }
+                size_t end = pos;
+                while (end < sql.size() && std::isdigit(static_cast<unsigned char>(sql[end])))
+                    ++end;
+                Rows.erase(std::stoull(sql.substr(pos, end - pos)));
+                pos = end;
+            }
+        }
+    }
+
+    std::deque<std::vector<std::string>> _pending;
+};
+
+inline FakeDatabase CharacterDatabase;
+
+#endif // DM_BENCH_DATABASE_ENV_H
@@ -0,0 +1,21 @@
+/*
+ * mod-dungeon-master — bench/shim/Define.h
+ * Stand-in for AzerothCore's Define.h: only the fixed-width integer types the
+ * pure module sources use, so they build without the core.
+ */
+
+#ifndef DM_BENCH_DEFINE_H
+#define DM_BENCH_DEFINE_H
+
+#include <cstdint>
+
+using int8   = std::int8_t;
+using int16  = std::int16_t;
+using int32  = std::int32_t;
+using int64  = std::int64_t;
+using uint8  = std::uint8_t;
+using uint16 = std::uint16_t;
+using uint32 = std::uint32_t;
+using uint64 = std::uint64_t;
+
+#endif // DM_BENCH_DEFINE_H
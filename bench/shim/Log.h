@@ -0,0 +1,14 @@
+/*
+ * mod-dungeon-master — bench/shim/Log.h
+ * Stand-in for AzerothCore's Log.h: the offline tools print their own output.
+ */
+
+#ifndef DM_BENCH_LOG_H
+#define DM_BENCH_LOG_H
+
+#define LOG_INFO(...)  ((void)0)
+#define LOG_WARN(...)  ((void)0)
+#define LOG_ERROR(...) ((void)0)
+#define LOG_DEBUG(...) ((void)0)
+
+#endif // DM_BENCH_LOG_H
@@ -0,0 +1,41 @@
+/*
+ * mod-dungeon-master — bench/shim/ObjectGuid.h
+ * Stand-in for AzerothCore's ObjectGuid: a raw 64-bit value with the
+ * comparisons and hash the module's containers need.
+ */
+
+#ifndef DM_BENCH_OBJECT_GUID_H
+#define DM_BENCH_OBJECT_GUID_H
+
+#include "Define.h"
+#include <functional>
+
+class ObjectGuid
+{
+public:
+    static const ObjectGuid Empty;
+
+    ObjectGuid() = default;
+    explicit ObjectGuid(uint64 raw) : _guid(raw) { }
+
+    uint64 GetRawValue() const { return _guid; }
+    uint32 GetCounter()  const { return static_cast<uint32>(_guid); }
+    bool   IsEmpty()     const { return _guid == 0; }
+
+    bool operator==(const ObjectGuid& o) const { return _guid == o._guid; }
+    bool operator!=(const ObjectGuid& o) const { return _guid != o._guid; }
+    bool operator< (const ObjectGuid& o) const { return _guid <  o._guid; }
+
+private:
+    uint64 _guid = 0;
+};
+
+inline const ObjectGuid ObjectGuid::Empty{};
+
+template <>
+struct std::hash<ObjectGuid>
+{
+    size_t operator()(const ObjectGuid& g) const noexcept { return std::hash<uint64>()(g.GetRawValue()); }
+};
+
+#endif // DM_BENCH_OBJECT_GUID_H
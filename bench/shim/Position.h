@@ -0,0 +1,35 @@
+/*
+ * mod-dungeon-master — bench/shim/Position.h
+ * Stand-in for AzerothCore's Position: coordinates, accessors and distance.
+ */
+
+#ifndef DM_BENCH_POSITION_H
+#define DM_BENCH_POSITION_H
+
+#include <cmath>
+
+struct Position
+{
+    Position(float x = 0.0f, float y = 0.0f, float z = 0.0f, float o = 0.0f)
+        : m_positionX(x), m_positionY(y), m_positionZ(z), m_orientation(o) { }
+
+    float GetPositionX()  const { return m_positionX; }
+    float GetPositionY()  const { return m_positionY; }
+    float GetPositionZ()  const { return m_positionZ; }
+    float GetOrientation() const { return m_orientation; }
+
+    float GetExactDist(const Position* o) const
+    {
+        float dx = m_positionX - o->m_positionX;
+        float dy = m_positionY - o->m_positionY;
+        float dz = m_positionZ - o->m_positionZ;
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    float m_positionX;
+    float m_positionY;
+    float m_positionZ;
+    float m_orientation;
+};
+
+#endif // DM_BENCH_POSITION_H
@@ -81,6 +81,36 @@ CREATE TABLE IF NOT EXISTS `dm_roguelike_leaderboard` (
     INDEX `idx_guid`   (`guid`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
 
+-- ---------------------------------------------------------------------------
+-- Run cooldowns (survive restarts; expired rows are removed on startup)
+-- ---------------------------------------------------------------------------
+CREATE TABLE IF NOT EXISTS `dm_cooldowns` (
+    `guid`       INT UNSIGNED    NOT NULL,
+    `expires_at` BIGINT UNSIGNED NOT NULL,  -- unix time
+    PRIMARY KEY (`guid`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- Crash recovery: one row per player in a live run, consumed on login after a restart
+CREATE TABLE IF NOT EXISTS `dm_checkpoints` (
+    `guid`          INT UNSIGNED    NOT NULL,
+    `leader_guid`   INT UNSIGNED    NOT NULL DEFAULT 0,
+    `map_id`        INT UNSIGNED    NOT NULL DEFAULT 0,
+    `instance_id`   INT UNSIGNED    NOT NULL DEFAULT 0,
+    `difficulty_id` INT UNSIGNED    NOT NULL DEFAULT 0,
+    `seed`          BIGINT UNSIGNED NOT NULL DEFAULT 0,
+    `creatures`     INT UNSIGNED    NOT NULL DEFAULT 0,
+    `dead_mask`     TEXT            NOT NULL,           -- hex, one bit per creature
+    `tier`          INT UNSIGNED    NOT NULL DEFAULT 0, -- 0 = standard mode
+    `buff_stacks`   INT UNSIGNED    NOT NULL DEFAULT 0,
+    `affixes`       VARCHAR(64)     NOT NULL DEFAULT '',
+    `return_map`    INT UNSIGNED    NOT NULL DEFAULT 0,
+    `return_x`      FLOAT           NOT NULL DEFAULT 0,
+    `return_y`      FLOAT           NOT NULL DEFAULT 0,
+    `return_z`      FLOAT           NOT NULL DEFAULT 0,
+    `return_o`      FLOAT           NOT NULL DEFAULT 0,
+    PRIMARY KEY (`guid`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
 -- ---------------------------------------------------------------------------
 -- MIGRATION: If upgrading from a previous version, this adds new columns
 -- to existing tables.  Safe to run on fresh installs (columns already exist).
@@ -8,6 +8,7 @@
 --   1. creature_template         - NPC template (entry 500000)
 --   2. creature_template_model   - Stormwind Guard display model
 --   3. creature                  - Spawn entries in every major city
+--   4. dm_boss_kit               - Boss ability kits per creature type
 --
 -- Spawn coordinates sourced from verified working NPC positions
 -- (cross-referenced with PortalMaster module and existing city NPCs).
@@ -315,3 +316,61 @@ INSERT INTO `npc_vendor` (`entry`, `slot`, `item`, `maxcount`, `incrtime`, `Exte
 (500001, 0, 43234,  0, 0, 0),   -- Wound Poison VI         (lvl 72)
 (500001, 0, 43235,  0, 0, 0),   -- Wound Poison VII        (lvl 78)
 (500001, 0, 21835,  0, 0, 0);   -- Anesthetic Poison       (lvl 68)
+
+
+-- =============================================
+-- Boss Ability Kits (dm_boss_kit)
+-- =============================================
+-- Read once at startup by DungeonMasterBossAI. One kit per creature type;
+-- creature_type 0 is the default kit for humanoids and any type without rows.
+--
+-- slot             = cast order within the kit (max 8 per type)
+-- cooldown_min/max = ms; first cast is staggered to [cooldown_min/2, cooldown_min]
+-- target           = 0 victim, 1 self (PBAoE / self buff), 2 random player
+-- health_below_pct = only cast at or below this HP%; 100 = whole fight
+-- =============================================
+CREATE TABLE IF NOT EXISTS `dm_boss_kit` (
+    `creature_type`    TINYINT UNSIGNED  NOT NULL,
+    `slot`             TINYINT UNSIGNED  NOT NULL,
+    `spell_id`         INT UNSIGNED      NOT NULL,
+    `cooldown_min`     INT UNSIGNED      NOT NULL,
+    `cooldown_max`     INT UNSIGNED      NOT NULL,
+    `target`           TINYINT UNSIGNED  NOT NULL DEFAULT 0,
+    `health_below_pct` TINYINT UNSIGNED  NOT NULL DEFAULT 100,
+    `comment`          VARCHAR(64)       NOT NULL DEFAULT '',
+    PRIMARY KEY (`creature_type`, `slot`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+DELETE FROM `dm_boss_kit`;
+
+INSERT INTO `dm_boss_kit` (
+    `creature_type`, `slot`, `spell_id`, `cooldown_min`, `cooldown_max`, `target`, `health_below_pct`, `comment`
+) VALUES
+-- Default / Humanoid
+(0, 0, 15284,  6000, 10000, 0, 100, 'Cleave'),
+(0, 1, 16856, 12000, 18000, 0, 100, 'Mortal Strike'),
+(0, 2, 19134, 22000, 30000, 1, 100, 'Frightening Shout (AoE)'),
+-- Beast (1)
+(1, 0,  8269, 15000, 22000, 1, 100, 'Frenzy (self)'),
+(1, 1, 22120, 12000, 18000, 0, 100, 'Charge'),
+(1, 2, 16509,  8000, 12000, 0, 100, 'Rend (bleed)'),
+-- Dragonkin (2)
+(2, 0,  9573,  8000, 12000, 0, 100, 'Flame Breath (cone)'),
+(2, 1, 15847, 15000, 20000, 0, 100, 'Tail Sweep'),
+(2, 2, 18500, 20000, 28000, 0, 100, 'Wing Buffet (knockback)'),
+-- Demon (3)
+(3, 0, 17228,  6000, 10000, 0, 100, 'Shadow Bolt Volley'),
+(3, 1, 19717, 18000, 25000, 0, 100, 'Rain of Fire'),
+(3, 2, 12542, 22000, 30000, 0, 100, 'Fear (single target)'),
+-- Elemental (4)
+(4, 0, 12058,  6000, 10000, 0, 100, 'Chain Lightning'),
+(4, 1, 15531, 16000, 22000, 1, 100, 'Frost Nova (PBAoE)'),
+(4, 2, 13281, 10000, 14000, 0, 100, 'Earth Shock'),
+-- Giant (5)
+(5, 0,  8078,  8000, 12000, 1, 100, 'Thunderclap (PBAoE slow)'),
+(5, 1, 15580, 14000, 20000, 0, 100, 'Knock Away'),
+(5, 2, 16727, 20000, 28000, 1, 100, 'War Stomp (AoE stun)'),
+-- Undead (6)
+(6, 0, 15232,  5000,  8000, 0, 100, 'Shadow Bolt'),
+(6, 1, 14868, 14000, 20000, 0, 100, 'Curse of Agony'),
+(6, 2, 15398, 18000, 25000, 1, 100, 'Shadow Nova (PBAoE)');
@@ -0,0 +1,537 @@
+/*
+ * mod-dungeon-master — DMAggro.cpp
+ * Spatial-grid aggro checks and the LOS cache for idle session creatures.
+ */
+
+#include "DMAggro.h"
+#include "DMConfig.h"
+#include "DMMemory.h"
+#include "DMPerf.h"
+#include "Creature.h"
+#include "CreatureAI.h"
+#include "GameTime.h"
+#include "Map.h"
+#include "Player.h"
+#include <algorithm>
+#include <cmath>
+
+namespace DungeonMaster
+{
+
+DMAggroScheduler* DMAggroScheduler::Instance()
+{
+    static DMAggroScheduler instance;
+    return &instance;
+}
+
+static int32 CellCoord(float v, float cellSize)
+{
+    return static_cast<int32>(std::floor(v / cellSize));
+}
+
+static uint64 PackCell(int32 cx, int32 cy)
+{
+    return (uint64(uint32(cx)) << 32) | uint32(cy);
+}
+
+uint64 DMAggroScheduler::CellKey(float x, float y, float cellSize)
+{
+    return PackCell(CellCoord(x, cellSize), CellCoord(y, cellSize));
+}
+
+// Caller holds _mutex
+void DMAggroScheduler::RemoveFromCell(std::unordered_map<uint64, std::vector<ObjectGuid>>& cells,
+                                      uint64 key, ObjectGuid guid)
+{
+    auto cell = cells.find(key);
+    if (cell == cells.end())
+        return;
+
+    auto& vec = cell->second;
+    auto pos = std::find(vec.begin(), vec.end(), guid);
+    if (pos != vec.end())
+    {
+        *pos = vec.back();
+        vec.pop_back();
+    }
+    if (vec.empty())
+        cells.erase(cell);
+}
+
+// Caller holds _mutex
+void DMAggroScheduler::Remove(InstanceGrid& grid, ObjectGuid guid)
+{
+    auto it = grid.CellOf.find(guid);
+    if (it == grid.CellOf.end())
+        return;
+
+    RemoveFromCell(grid.Cells, it->second, guid);
+    grid.CellOf.erase(it);
+    grid.LosRetryAt.erase(guid);
+}
+
+// Cell sizes are fixed when the grid is created
+void DMAggroScheduler::AddInstance(uint32 instanceId)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    InstanceGrid& grid = _grids[instanceId];
+    if (grid.CellSize <= 0.0f)
+    {
+        grid.CellSize    = sDMConfig->GetAggroRadius() + PATROL_SLACK;
+        grid.ActCellSize = std::max(grid.CellSize, sDMConfig->GetActivationRadius());
+    }
+}
+
+// Caller holds _mutex. Only AddInstance creates grids, so an evade after the
+// session's instance was released does not bring its grid back.
+DMAggroScheduler::InstanceGrid* DMAggroScheduler::FindGrid(uint32 instanceId)
+{
+    auto it = _grids.find(instanceId);
+    return it == _grids.end() ? nullptr : &it->second;
+}
+
+void DMAggroScheduler::Track(Creature* creature)
+{
+    if (!creature || !creature->IsAlive())
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    InstanceGrid* found = FindGrid(creature->GetInstanceId());
+    if (!found)
+        return;
+    InstanceGrid& grid = *found;
+
+    ObjectGuid guid = creature->GetGUID();
+    Remove(grid, guid);
+
+    // Bucket by home position; patrols stay within PATROL_SLACK of it
+    Position const& home = creature->GetHomePosition();
+    uint64 key = CellKey(home.GetPositionX(), home.GetPositionY(), grid.CellSize);
+    grid.Cells[key].push_back(guid);
+    grid.CellOf[guid] = key;
+}
+
+void DMAggroScheduler::Untrack(Creature* creature)
+{
+    if (!creature)
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _grids.find(creature->GetInstanceId());
+    if (it != _grids.end())
+        Remove(it->second, creature->GetGUID());
+}
+
+void DMAggroScheduler::ClearInstance(uint32 instanceId)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _grids.erase(instanceId);
+}
+
+uint32 DMAggroScheduler::GetTrackedCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t n = 0;
+    for (const auto& [id, grid] : _grids)
+        n += grid.CellOf.size();
+    return static_cast<uint32>(n);
+}
+
+uint32 DMAggroScheduler::GetActiveCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t n = 0;
+    for (const auto& [id, grid] : _grids)
+        n += grid.Active.size();
+    return static_cast<uint32>(n);
+}
+
+uint64 DMAggroScheduler::GetHeapBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint64 bytes = HeapBytes(_grids);
+    for (const auto& [id, grid] : _grids)
+    {
+        bytes += HeapBytes(grid.Cells) + HeapBytes(grid.CellOf) + HeapBytes(grid.LosRetryAt)
+               + HeapBytes(grid.ActCells) + HeapBytes(grid.ActCellOf) + HeapBytes(grid.Active);
+        for (const auto& [key, cell] : grid.Cells)
+            bytes += HeapBytes(cell);
+        for (const auto& [key, cell] : grid.ActCells)
+            bytes += HeapBytes(cell);
+    }
+
+    // The LOS caches live on the map threads; count their nodes and buckets
+    bytes += _losCacheEntries.load(std::memory_order_relaxed)
+           * (sizeof(std::pair<const LosKey, LosEntry>) + 3 * sizeof(void*));
+    return bytes;
+}
+
+// ---- Lazy activation ----
+
+void DMAggroScheduler::Register(Creature* creature)
+{
+    if (!creature || !creature->IsAlive())
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    InstanceGrid* found = FindGrid(creature->GetInstanceId());
+    if (!found)
+        return;
+    InstanceGrid& grid = *found;
+
+    ObjectGuid guid = creature->GetGUID();
+    Position const& home = creature->GetHomePosition();
+    uint64 key = CellKey(home.GetPositionX(), home.GetPositionY(), grid.ActCellSize);
+    if (grid.ActCellOf.emplace(guid, key).second)
+        grid.ActCells[key].push_back(guid);
+}
+
+// Caller holds _mutex; true if the creature had been woken by us
+bool DMAggroScheduler::Retire(InstanceGrid& grid, ObjectGuid guid)
+{
+    auto cellOf = grid.ActCellOf.find(guid);
+    if (cellOf == grid.ActCellOf.end())
+        return false;
+
+    RemoveFromCell(grid.ActCells, cellOf->second, guid);
+    grid.ActCellOf.erase(cellOf);
+    return grid.Active.erase(guid) > 0;
+}
+
+void DMAggroScheduler::Retire(Creature* creature)
+{
+    if (!creature)
+        return;
+
+    bool wasActive = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _grids.find(creature->GetInstanceId());
+        if (it == _grids.end())
+            return;
+        wasActive = Retire(it->second, creature->GetGUID());
+    }
+
+    // A cleared region lets its grids idle again
+    if (wasActive)
+        creature->setActive(false);
+}
+
+// Wakes creatures in the activation cells around players and sleeps the rest,
+// except those still fighting. Runs on the map thread; the lock is never held
+// across setActive.
+void DMAggroScheduler::UpdateActivation(Map* map, uint32 instanceId, const std::vector<Player*>& players)
+{
+    std::vector<ObjectGuid> wake;
+    std::vector<ObjectGuid> sleep;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _grids.find(instanceId);
+        if (it == _grids.end() || it->second.ActCellOf.empty())
+            return;
+
+        InstanceGrid& grid = it->second;
+        std::unordered_set<uint64> near;
+        for (Player* p : players)
+        {
+            int32 px = CellCoord(p->GetPositionX(), grid.ActCellSize);
+            int32 py = CellCoord(p->GetPositionY(), grid.ActCellSize);
+            for (int32 dx = -1; dx <= 1; ++dx)
+                for (int32 dy = -1; dy <= 1; ++dy)
+                    near.insert(PackCell(px + dx, py + dy));
+        }
+
+        for (uint64 key : near)
+        {
+            auto cell = grid.ActCells.find(key);
+            if (cell == grid.ActCells.end()) continue;
+            for (ObjectGuid guid : cell->second)
+                if (!grid.Active.count(guid))
+                    wake.push_back(guid);
+        }
+        for (ObjectGuid guid : grid.Active)
+            if (!near.count(grid.ActCellOf[guid]))
+                sleep.push_back(guid);
+    }
+
+    if (wake.empty() && sleep.empty())
+        return;
+
+    std::vector<ObjectGuid> woken;
+    std::vector<ObjectGuid> slept;
+    std::vector<ObjectGuid> gone;   // despawned or removed without a death hook
+    for (ObjectGuid guid : wake)
+    {
+        Creature* c = map->GetCreature(guid);
+        if (!c)
+        {
+            gone.push_back(guid);
+            continue;
+        }
+        c->setActive(true);
+        woken.push_back(guid);
+    }
+    for (ObjectGuid guid : sleep)
+    {
+        Creature* c = map->GetCreature(guid);
+        if (!c)
+        {
+            gone.push_back(guid);
+            continue;
+        }
+        if (c->IsInCombat())
+            continue;   // a chase or kite stays awake until it ends
+        c->setActive(false);
+        slept.push_back(guid);
+    }
+
+    if (sDMConfig->IsPerfEnabled())
+    {
+        sDMPerf->Count(HOOK_CREATURE_WAKES,  woken.size());
+        sDMPerf->Count(HOOK_CREATURE_SLEEPS, slept.size());
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _grids.find(instanceId);
+    if (it == _grids.end())
+        return;
+    for (ObjectGuid guid : woken)
+        if (it->second.ActCellOf.count(guid))
+            it->second.Active.insert(guid);
+    for (ObjectGuid guid : slept)
+        it->second.Active.erase(guid);
+    for (ObjectGuid guid : gone)
+        Retire(it->second, guid);
+}
+
+// 21 bits per axis covers the whole map range at LOS_CACHE_GRID yd
+static uint64 QuantizePoint(float x, float y, float z)
+{
+    auto q = [](float v) { return uint64(uint32(CellCoord(v, DMAggroScheduler::LOS_CACHE_GRID)) & 0x1FFFFF); };
+    return (q(x) << 42) | (q(y) << 21) | q(z);
+}
+
+DMAggroScheduler::LosCacheSet& DMAggroScheduler::ThreadLosCaches()
+{
+    static thread_local LosCacheSet caches;
+    return caches;
+}
+
+bool DMAggroScheduler::IsWithinLOS(Creature* creature, Player* player)
+{
+    LosKey key{ QuantizePoint(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ()),
+                QuantizePoint(player->GetPositionX(), player->GetPositionY(), player->GetPositionZ()) };
+    uint64 now = static_cast<uint64>(GameTime::GetGameTimeMS().count());
+    bool counting = sDMConfig->IsPerfEnabled();
+
+    LosCacheSet& caches = ThreadLosCaches();
+    if (now >= caches.NextPrune)
+    {
+        uint64 pruned = 0;
+        for (auto inst = caches.Instances.begin(); inst != caches.Instances.end(); )
+        {
+            LosCache& cache = inst->second;
+            for (auto e = cache.begin(); e != cache.end(); )
+            {
+                if (e->second.ExpiresAt > now)
+                {
+                    ++e;
+                    continue;
+                }
+                e = cache.erase(e);
+                ++pruned;
+            }
+            inst = cache.empty() ? caches.Instances.erase(inst) : std::next(inst);
+        }
+        _losCacheEntries.fetch_sub(pruned, std::memory_order_relaxed);
+        caches.NextPrune = now + LOS_CACHE_TTL_MS;
+    }
+
+    LosCache& cache = caches.Instances[creature->GetInstanceId()];
+    auto hit = cache.find(key);
+    if (hit != cache.end() && hit->second.ExpiresAt > now)
+    {
+        if (counting)
+            sDMPerf->Count(HOOK_LOS_CACHE_HIT);
+        return hit->second.Clear;
+    }
+
+    bool clear = creature->IsWithinLOSInMap(player);
+    if (counting)
+        sDMPerf->Count(HOOK_LOS_CACHE_MISS);
+
+    if (hit != cache.end())
+        hit->second = { clear, now + LOS_CACHE_TTL_MS };
+    else
+    {
+        cache.emplace(key, LosEntry{ clear, now + LOS_CACHE_TTL_MS });
+        _losCacheEntries.fetch_add(1, std::memory_order_relaxed);
+    }
+    return clear;
+}
+
+void DMAggroScheduler::Update(Map* map, uint32 diff)
+{
+    if (!map || !map->IsDungeon())
+        return;
+
+    uint32 instanceId = map->GetInstanceId();
+    uint32 interval   = sDMConfig->GetAggroScanInterval();
+
+    // ---- Timer, then the player set (a few players at most) ----
+    uint32 clock = 0;
+    float  cellSize = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _grids.find(instanceId);
+        if (it == _grids.end() || (it->second.CellOf.empty() && it->second.ActCellOf.empty()))
+            return;
+
+        InstanceGrid& grid = it->second;
+        grid.Timer += diff;
+        if (grid.Timer < interval)
+            return;
+        grid.Clock += grid.Timer;
+        grid.Timer  = 0;
+        clock    = grid.Clock;
+        cellSize = grid.CellSize;
+    }
+
+    std::vector<Player*> players;
+    for (auto const& itr : map->GetPlayers())
+    {
+        Player* p = itr.GetSource();
+        if (p && p->IsAlive() && !p->IsGameMaster())
+            players.push_back(p);
+    }
+    if (players.empty())
+        return;
+
+    PerfScope perfScope(PERF_AGGRO_SCAN);
+
+    UpdateActivation(map, instanceId, players);
+
+    // ---- Creatures in the cells around each player ----
+    std::vector<ObjectGuid> nearby;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _grids.find(instanceId);
+        if (it == _grids.end())
+            return;
+
+        InstanceGrid& grid = it->second;
+        for (Player* p : players)
+        {
+            int32 px = CellCoord(p->GetPositionX(), cellSize);
+            int32 py = CellCoord(p->GetPositionY(), cellSize);
+            for (int32 dx = -1; dx <= 1; ++dx)
+                for (int32 dy = -1; dy <= 1; ++dy)
+                {
+                    auto cell = grid.Cells.find(PackCell(px + dx, py + dy));
+                    if (cell == grid.Cells.end()) continue;
+                    for (ObjectGuid guid : cell->second)
+                    {
+                        auto retry = grid.LosRetryAt.find(guid);
+                        if (retry == grid.LosRetryAt.end() || retry->second <= clock)
+                            nearby.push_back(guid);
+                    }
+                }
+        }
+    }
+
+    if (players.size() > 1)
+    {
+        std::sort(nearby.begin(), nearby.end());
+        nearby.erase(std::unique(nearby.begin(), nearby.end()), nearby.end());
+    }
+
+    // ---- Range test, closest player per creature ----
+    struct Candidate
+    {
+        Creature* Mob;
+        Player*   Target;
+        float     Dist;
+    };
+
+    float aggroRange = sDMConfig->GetAggroRadius();
+    std::vector<Candidate>  candidates;
+    std::vector<ObjectGuid> stale;
+    for (ObjectGuid guid : nearby)
+    {
+        Creature* c = map->GetCreature(guid);
+        if (!c || !c->IsAlive() || !c->IsInWorld())
+        {
+            stale.push_back(guid);
+            continue;
+        }
+        if (c->IsInCombat() || c->HasReactState(REACT_PASSIVE))
+            continue;
+
+        Player* best = nullptr;
+        float   closest = aggroRange;
+        for (Player* p : players)
+        {
+            float dist = c->GetDistance(p);
+            if (dist < closest && c->IsHostileTo(p))
+            {
+                closest = dist;
+                best    = p;
+            }
+        }
+        if (best)
+            candidates.push_back({ c, best, closest });
+    }
+
+    // ---- Capped LOS, nearest first; the rest wait for the next scan ----
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return a.Dist < b.Dist; });
+
+    uint32 maxLos = sDMConfig->GetAggroMaxLosChecks();
+    size_t tested = std::min<size_t>(candidates.size(), maxLos);
+    std::vector<ObjectGuid> losFailed;
+    std::vector<Candidate>  pulls;
+    for (size_t i = 0; i < tested; ++i)
+    {
+        const Candidate& cand = candidates[i];
+        if (IsWithinLOS(cand.Mob, cand.Target))
+            pulls.push_back(cand);
+        else
+            losFailed.push_back(cand.Mob->GetGUID());
+    }
+
+    if (sDMConfig->IsPerfEnabled())
+    {
+        sDMPerf->Count(HOOK_AGGRO_CANDIDATES,   candidates.size());
+        sDMPerf->Count(HOOK_AGGRO_LOS_CHECKS,   tested);
+        sDMPerf->Count(HOOK_AGGRO_LOS_DEFERRED, candidates.size() - tested);
+        sDMPerf->Count(HOOK_AGGRO_PULLS,        pulls.size());
+    }
+
+    if (!stale.empty() || !losFailed.empty())
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _grids.find(instanceId);
+        if (it != _grids.end())
+        {
+            for (ObjectGuid guid : stale)
+                Remove(it->second, guid);
+            for (ObjectGuid guid : losFailed)
+                if (it->second.CellOf.count(guid))
+                    it->second.LosRetryAt[guid] = clock + LOS_RETRY_MS;
+        }
+    }
+
+    // Engaging untracks through the AI, so this runs with the lock released
+    for (const Candidate& cand : pulls)
+    {
+        if (cand.Mob->IsInCombat())
+            continue;
+        cand.Mob->SetInCombatWith(cand.Target);
+        cand.Target->SetInCombatWith(cand.Mob);
+        cand.Mob->AddThreat(cand.Target, 1.0f);
+        if (cand.Mob->AI())
+            cand.Mob->AI()->AttackStart(cand.Target);
+    }
+}
+
+} // namespace DungeonMaster
@@ -0,0 +1,137 @@
+/*
+ * mod-dungeon-master — DMAggro.h
+ * Per-instance aggro scheduler: idle session creatures are bucketed on a
+ * spatial grid and tested against nearby players from the map update. The
+ * same pass wakes creatures near players and puts cleared or distant ones back
+ * to sleep (setActive).
+ */
+
+#ifndef DM_AGGRO_H
+#define DM_AGGRO_H
+
+#include "Define.h"
+#include "ObjectGuid.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Creature;
+class Map;
+class Player;
+
+namespace DungeonMaster
+{
+
+// Replaces the per-creature 1 s player scans. Each scan only looks at the
+// 3x3 cells around each player; the closest candidates get LOS-tested first,
+// at most Dungeon.AggroMaxLosChecks per scan, and a creature that failed LOS
+// is not retested for a second.
+class DMAggroScheduler
+{
+    DMAggroScheduler() = default;
+
+public:
+    static DMAggroScheduler* Instance();
+
+    // PopulateDungeon opens an instance's grid and ClearInstance drops it;
+    // Track and Register ignore creatures of instances without one
+    void   AddInstance(uint32 instanceId);
+
+    // AIs track themselves while idle (spawn, evade) and untrack on engage / death
+    void   Track(Creature* creature);
+    void   Untrack(Creature* creature);
+    void   ClearInstance(uint32 instanceId);
+
+    // Lazy activation: every session creature is registered once at populate and
+    // kept inactive until a player comes within Dungeon.ActivationRadius of its
+    // cell; Retire on death puts it to sleep for good. AzerothCore only unloads
+    // grids together with the whole map, so a sleeping creature is never dropped.
+    void   Register(Creature* creature);
+    void   Retire(Creature* creature);
+
+    // Called from the map's own update thread
+    void   Update(Map* map, uint32 diff);
+
+    uint32 GetTrackedCount() const;
+    uint32 GetActiveCount() const;
+    uint64 GetHeapBytes() const;        // .dm mem
+
+    // IsWithinLOSInMap through a short-lived per-instance cache. Both ends are
+    // quantized to LOS_CACHE_GRID yd, so a party standing still costs one raycast
+    // per creature and player every LOS_CACHE_TTL_MS. Called from the creature's
+    // map thread only; takes no lock.
+    bool   IsWithinLOS(Creature* creature, Player* player);
+
+    static constexpr float  PATROL_SLACK     = 5.0f;    // trash wanders 5 yd from home
+    static constexpr uint32 LOS_RETRY_MS     = 1000;
+    static constexpr float  LOS_CACHE_GRID   = 2.0f;
+    static constexpr uint32 LOS_CACHE_TTL_MS = 2000;
+
+private:
+    struct LosKey
+    {
+        uint64 From;
+        uint64 To;
+        bool operator==(const LosKey& o) const { return From == o.From && To == o.To; }
+    };
+
+    struct LosKeyHash
+    {
+        size_t operator()(const LosKey& k) const { return std::hash<uint64>()(k.From ^ (k.To + 0x9E3779B97F4A7C15ULL + (k.From << 6) + (k.From >> 2))); }
+    };
+
+    struct LosEntry
+    {
+        bool   Clear     = false;
+        uint64 ExpiresAt = 0;       // game time ms
+    };
+
+    struct InstanceGrid
+    {
+        float  CellSize = 0.0f;     // aggro radius + patrol slack, fixed when the grid is created
+        float  ActCellSize = 0.0f;  // activation radius, at least CellSize
+        uint32 Timer    = 0;
+        uint32 Clock    = 0;        // ms of scans run, for LOS retry stamps
+        std::unordered_map<uint64, std::vector<ObjectGuid>> Cells;
+        std::unordered_map<ObjectGuid, uint64>              CellOf;
+        std::unordered_map<ObjectGuid, uint32>              LosRetryAt;
+
+        // Activation cells hold every live session creature, idle or not
+        std::unordered_map<uint64, std::vector<ObjectGuid>> ActCells;
+        std::unordered_map<ObjectGuid, uint64>              ActCellOf;
+        std::unordered_set<ObjectGuid>                      Active;     // woken by us
+    };
+
+    using LosCache = std::unordered_map<LosKey, LosEntry, LosKeyHash>;
+
+    // One set per map thread. An instance is updated by one thread at a time,
+    // so its entries are never shared; those of ended instances just expire.
+    struct LosCacheSet
+    {
+        std::unordered_map<uint32, LosCache> Instances;    // instanceId -> cache
+        uint64 NextPrune = 0;
+    };
+
+    static LosCacheSet& ThreadLosCaches();
+
+    static uint64 CellKey(float x, float y, float cellSize);
+    static void   Remove(InstanceGrid& grid, ObjectGuid guid);
+    static bool   Retire(InstanceGrid& grid, ObjectGuid guid);
+    static void   RemoveFromCell(std::unordered_map<uint64, std::vector<ObjectGuid>>& cells,
+                                 uint64 key, ObjectGuid guid);
+    InstanceGrid* FindGrid(uint32 instanceId);
+    void          UpdateActivation(Map* map, uint32 instanceId, const std::vector<Player*>& players);
+
+    std::unordered_map<uint32, InstanceGrid> _grids;    // instanceId -> grid
+    mutable std::mutex _mutex;
+    std::atomic<uint64> _losCacheEntries{0};            // across all map threads, for .dm mem
+};
+
+} // namespace DungeonMaster
+
+#define sDMAggro DungeonMaster::DMAggroScheduler::Instance()
+
+#endif // DM_AGGRO_H
@@ -0,0 +1,199 @@
+/*
+ * mod-dungeon-master — DMBossKits.cpp
+ * dm_boss_kit loader and the built-in kits used when the table is absent.
+ */
+
+#include "DMBossKits.h"
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "SharedDefines.h"
+#include "SpellMgr.h"
+#include <algorithm>
+#include <iterator>
+
+namespace DungeonMaster
+{
+
+DMBossKitStore* DMBossKitStore::Instance()
+{
+    static DMBossKitStore instance;
+    return &instance;
+}
+
+namespace
+{
+    struct KitRow
+    {
+        uint32      Type;
+        BossAbility Ability;
+    };
+
+    // The kits dm_setup.sql seeds, kept so bosses still fight on a world DB
+    // that has not been updated. Type 0 is the default (humanoid and unlisted types).
+    constexpr KitRow BuiltinKits[] =
+    {
+        { 0,                         { 15284, 6000,  10000, KIT_TARGET_VICTIM, 100 } },  // Cleave
+        { 0,                         { 16856, 12000, 18000, KIT_TARGET_VICTIM, 100 } },  // Mortal Strike
+        { 0,                         { 19134, 22000, 30000, KIT_TARGET_SELF,   100 } },  // Frightening Shout (AoE)
+        { CREATURE_TYPE_BEAST,       { 8269,  15000, 22000, KIT_TARGET_SELF,   100 } },  // Frenzy (self)
+        { CREATURE_TYPE_BEAST,       { 22120, 12000, 18000, KIT_TARGET_VICTIM, 100 } },  // Charge
+        { CREATURE_TYPE_BEAST,       { 16509, 8000,  12000, KIT_TARGET_VICTIM, 100 } },  // Rend (bleed)
+        { CREATURE_TYPE_DRAGONKIN,   { 9573,  8000,  12000, KIT_TARGET_VICTIM, 100 } },  // Flame Breath (cone)
+        { CREATURE_TYPE_DRAGONKIN,   { 15847, 15000, 20000, KIT_TARGET_VICTIM, 100 } },  // Tail Sweep
+        { CREATURE_TYPE_DRAGONKIN,   { 18500, 20000, 28000, KIT_TARGET_VICTIM, 100 } },  // Wing Buffet (knockback)
+        { CREATURE_TYPE_DEMON,       { 17228, 6000,  10000, KIT_TARGET_VICTIM, 100 } },  // Shadow Bolt Volley
+        { CREATURE_TYPE_DEMON,       { 19717, 18000, 25000, KIT_TARGET_VICTIM, 100 } },  // Rain of Fire
+        { CREATURE_TYPE_DEMON,       { 12542, 22000, 30000, KIT_TARGET_VICTIM, 100 } },  // Fear (single target)
+        { CREATURE_TYPE_ELEMENTAL,   { 12058, 6000,  10000, KIT_TARGET_VICTIM, 100 } },  // Chain Lightning
+        { CREATURE_TYPE_ELEMENTAL,   { 15531, 16000, 22000, KIT_TARGET_SELF,   100 } },  // Frost Nova (PBAoE)
+        { CREATURE_TYPE_ELEMENTAL,   { 13281, 10000, 14000, KIT_TARGET_VICTIM, 100 } },  // Earth Shock
+        { CREATURE_TYPE_GIANT,       { 8078,  8000,  12000, KIT_TARGET_SELF,   100 } },  // Thunderclap (PBAoE slow)
+        { CREATURE_TYPE_GIANT,       { 15580, 14000, 20000, KIT_TARGET_VICTIM, 100 } },  // Knock Away
+        { CREATURE_TYPE_GIANT,       { 16727, 20000, 28000, KIT_TARGET_SELF,   100 } },  // War Stomp (AoE stun)
+        { CREATURE_TYPE_UNDEAD,      { 15232, 5000,  8000,  KIT_TARGET_VICTIM, 100 } },  // Shadow Bolt
+        { CREATURE_TYPE_UNDEAD,      { 14868, 14000, 20000, KIT_TARGET_VICTIM, 100 } },  // Curse of Agony
+        { CREATURE_TYPE_UNDEAD,      { 15398, 18000, 25000, KIT_TARGET_SELF,   100 } },  // Shadow Nova (PBAoE)
+    };
+}
+
+// Rows arrive ordered by type, so each kit is one contiguous run of _abilities
+void DMBossKitStore::Load()
+{
+    if (_loaded)
+        return;
+
+    _abilities.clear();
+    _kits = {};
+
+    std::array<uint8, MAX_KIT_TYPES> counts{};
+    std::vector<KitRow> rows;
+
+    QueryResult result = WorldDatabase.Query(
+        "SELECT creature_type, spell_id, cooldown_min, cooldown_max, target, health_below_pct "
+        "FROM dm_boss_kit "
+        "ORDER BY creature_type, slot");
+
+    if (result)
+    {
+        do
+        {
+            Field* f = result->Fetch();
+            KitRow row;
+            row.Type                   = f[0].Get<uint8>();
+            row.Ability.SpellId        = f[1].Get<uint32>();
+            row.Ability.CooldownMin    = f[2].Get<uint32>();
+            row.Ability.CooldownMax    = std::max(row.Ability.CooldownMin, f[3].Get<uint32>());
+            row.Ability.Target         = f[4].Get<uint8>();
+            row.Ability.HealthBelowPct = std::min<uint8>(100, f[5].Get<uint8>());
+
+            if (row.Type >= MAX_KIT_TYPES || row.Ability.Target >= MAX_KIT_TARGETS
+                || row.Ability.CooldownMin == 0 || !sSpellMgr->GetSpellInfo(row.Ability.SpellId))
+            {
+                LOG_ERROR("module", "DungeonMaster: dm_boss_kit row (type {}, spell {}) is invalid, skipped.",
+                    row.Type, row.Ability.SpellId);
+                continue;
+            }
+            if (counts[row.Type] >= MAX_KIT_ABILITIES)
+            {
+                LOG_ERROR("module", "DungeonMaster: dm_boss_kit type {} has more than {} abilities, spell {} skipped.",
+                    row.Type, MAX_KIT_ABILITIES, row.Ability.SpellId);
+                continue;
+            }
+            ++counts[row.Type];
+            rows.push_back(row);
+        } while (result->NextRow());
+    }
+
+    if (rows.empty())
+    {
+        LOG_WARN("module", "DungeonMaster: dm_boss_kit is missing or empty — using built-in boss kits. "
+                 "Run data/sql/db-world/base/dm_setup.sql to make them editable.");
+        LoadBuiltinKits();
+        return;
+    }
+
+    _abilities.reserve(rows.size());
+    for (const KitRow& row : rows)
+        _abilities.push_back(row.Ability);
+
+    BindKits(counts);
+
+    if (!counts[0])
+        LOG_WARN("module", "DungeonMaster: dm_boss_kit has no type 0 (default) kit — bosses of unlisted types will only melee.");
+
+    LOG_INFO("module", "DungeonMaster: {} boss kits, {} abilities loaded from dm_boss_kit.",
+        GetKitCount(), GetAbilityCount());
+}
+
+void DMBossKitStore::LoadBuiltinKits()
+{
+    std::array<uint8, MAX_KIT_TYPES> counts{};
+    _abilities.reserve(std::size(BuiltinKits));
+    for (const KitRow& row : BuiltinKits)
+    {
+        _abilities.push_back(row.Ability);
+        ++counts[row.Type];
+    }
+    BindKits(counts);
+}
+
+// Pointers are taken only once the array has stopped growing
+void DMBossKitStore::BindKits(const std::array<uint8, MAX_KIT_TYPES>& counts)
+{
+    size_t offset = 0;
+    for (uint32 type = 0; type < MAX_KIT_TYPES; ++type)
+    {
+        _kits[type] = { _abilities.data() + offset, counts[type] };
+        offset += counts[type];
+    }
+    _loaded = true;
+}
+
+const BossKit& DMBossKitStore::GetKit(uint32 creatureType) const
+{
+    if (creatureType < MAX_KIT_TYPES && _kits[creatureType].Count)
+        return _kits[creatureType];
+    return _kits[0];
+}
+
+uint32 DMBossKitStore::GetKitCount() const
+{
+    return static_cast<uint32>(std::count_if(_kits.begin(), _kits.end(),
+        [](const BossKit& k) { return k.Count > 0; }));
+}
+
+// ---- BossRotation ----
+
+bool BossRotation::DueLater(const Entry& a, const Entry& b)
+{
+    return a.DueAt > b.DueAt || (a.DueAt == b.DueAt && a.Index > b.Index);
+}
+
+void BossRotation::Start(const BossKit& kit, uint32 now)
+{
+    _size = 0;
+    for (uint8 i = 0; i < kit.Count; ++i)
+        Schedule(i, now + ThreadRng().Range<uint32>(kit.Abilities[i].CooldownMin / 2, kit.Abilities[i].CooldownMin));
+}
+
+bool BossRotation::PopDue(uint32 now, uint8& index)
+{
+    if (!_size || _heap[0].DueAt > now)
+        return false;
+
+    index = _heap[0].Index;
+    std::pop_heap(_heap.begin(), _heap.begin() + _size, DueLater);
+    --_size;
+    return true;
+}
+
+void BossRotation::Schedule(uint8 index, uint32 dueAt)
+{
+    if (_size >= _heap.size())
+        return;
+
+    _heap[_size++] = { dueAt, index };
+    std::push_heap(_heap.begin(), _heap.begin() + _size, DueLater);
+}
+
+} // namespace DungeonMaster
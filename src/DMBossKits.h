@@ -0,0 +1,106 @@
+/*
+ * mod-dungeon-master — DMBossKits.h
+ * Boss ability kits from the world DB table dm_boss_kit, loaded once into a
+ * contiguous array that DungeonMasterBossAI references by pointer.
+ */
+
+#ifndef DM_BOSS_KITS_H
+#define DM_BOSS_KITS_H
+
+#include "Define.h"
+#include "DMRandom.h"
+#include <array>
+#include <vector>
+
+namespace DungeonMaster
+{
+
+enum BossKitTarget : uint8
+{
+    KIT_TARGET_VICTIM = 0,      // current victim
+    KIT_TARGET_SELF   = 1,      // caster (PBAoE, self buffs)
+    KIT_TARGET_RANDOM = 2,      // random player on the threat list
+    MAX_KIT_TARGETS
+};
+
+struct BossAbility
+{
+    uint32 SpellId        = 0;
+    uint32 CooldownMin    = 0;  // ms
+    uint32 CooldownMax    = 0;  // ms
+    uint8  Target         = KIT_TARGET_VICTIM;
+    uint8  HealthBelowPct = 100;  // only cast at or below this HP%; 100 = whole fight
+};
+
+// View into the shared ability array; never owns or copies the abilities
+struct BossKit
+{
+    const BossAbility* Abilities = nullptr;
+    uint8              Count     = 0;
+
+    const BossAbility* begin() const { return Abilities; }
+    const BossAbility* end()   const { return Abilities + Count; }
+};
+
+class DMBossKitStore
+{
+    DMBossKitStore() = default;
+
+public:
+    static DMBossKitStore* Instance();
+
+    // Startup only: bosses keep pointers into the array, so it is never rebuilt
+    void Load();
+
+    // Kit for a creature type; types without rows get the type-0 default kit
+    const BossKit& GetKit(uint32 creatureType) const;
+
+    uint32 GetKitCount()     const;
+    uint32 GetAbilityCount() const { return static_cast<uint32>(_abilities.size()); }
+
+    static constexpr uint32 MAX_KIT_ABILITIES = 8;    // per-boss rotation slots
+    static constexpr uint32 MAX_KIT_TYPES     = 16;   // creature types 0..15
+
+private:
+    void LoadBuiltinKits();
+    void BindKits(const std::array<uint8, MAX_KIT_TYPES>& counts);
+
+    std::vector<BossAbility>                 _abilities;   // grouped by creature type
+    std::array<BossKit, MAX_KIT_TYPES>       _kits{};
+    bool                                     _loaded = false;
+};
+
+// Per-boss min-heap of ability due times on the boss's fight clock. UpdateAI
+// only looks at the top entry; abilities that come due during a cast or the
+// global cooldown stay queued and go out one per tick in due order.
+class BossRotation
+{
+public:
+    // Stagger first casts to [CooldownMin/2, CooldownMin] so a kit does not open all at once
+    void   Start(const BossKit& kit, uint32 now);
+
+    // Removes and returns the earliest ability due by `now`; caller reschedules it
+    bool   PopDue(uint32 now, uint8& index);
+    void   Schedule(uint8 index, uint32 dueAt);
+
+    uint8  GetQueued() const { return _size; }
+
+private:
+    struct Entry
+    {
+        uint32 DueAt;
+        uint8  Index;
+    };
+
+    // Heap order: earliest due on top, lower slot first on ties
+    static bool DueLater(const Entry& a, const Entry& b);
+
+    std::array<Entry, DMBossKitStore::MAX_KIT_ABILITIES> _heap{};
+    uint8 _size = 0;
+};
+
+} // namespace DungeonMaster
+
+#define sDMBossKits DungeonMaster::DMBossKitStore::Instance()
+
+#endif // DM_BOSS_KITS_H
@@ -0,0 +1,85 @@
+/*
+ * mod-dungeon-master — DMChat.cpp
+ * Prebuilt SMSG_MESSAGECHAT packets for party announcements.
+ */
+
+#include "DMChat.h"
+#include "Chat.h"
+#include "Player.h"
+#include "WorldSession.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+namespace DungeonMaster
+{
+
+void ChatBroadcast::Set(std::string_view text)
+{
+    _packets.clear();
+    while (!text.empty())
+    {
+        size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+
+        _packets.emplace_back();
+        ChatHandler::BuildChatPacket(_packets.back(), CHAT_MSG_SYSTEM, LANG_UNIVERSAL,
+            ObjectGuid::Empty, ObjectGuid::Empty, line, 0);
+
+        if (eol == std::string_view::npos)
+            break;
+        text.remove_prefix(eol + 1);
+    }
+}
+
+void ChatBroadcast::SendTo(Player* player) const
+{
+    if (!player)
+        return;
+    if (WorldSession* session = player->GetSession())
+        for (const WorldPacket& packet : _packets)
+            session->SendPacket(&packet);
+}
+
+void ChatBroadcast::SendTo(const std::vector<Player*>& players) const
+{
+    for (Player* p : players)
+        SendTo(p);
+}
+
+const ChatBroadcast& ChatBroadcast::Get(DMMessageId id)
+{
+    static const std::array<ChatBroadcast, MAX_DM_MESSAGES> messages =
+    {
+        ChatBroadcast("|cFF00FF00[Dungeon Master]|r Preparing the challenge..."),
+        ChatBroadcast("|cFFFF8000[Dungeon Master]|r The boss enters a new phase!"),
+        ChatBroadcast("|cFFFF0000[Dungeon Master]|r Time's up! Challenge failed."),
+        ChatBroadcast("|cFF00FF00[Dungeon Master]|r Revived at entrance. Get back in there!"),
+        ChatBroadcast("|cFFFFFF00[Dungeon Master]|r You have fallen! "
+                      "You will be revived when your group leaves combat."),
+        ChatBroadcast("|cFFFF0000[Dungeon Master]|r Total party wipe! Challenge failed."),
+        ChatBroadcast("|cFF00FF00[Dungeon Master]|r Challenge complete! Distributing rewards..."),
+        ChatBroadcast("|cFFFF0000[Dungeon Master]|r Challenge ended. No rewards given."),
+    };
+    return messages[id];
+}
+
+const ChatBroadcast& ChatBroadcast::Countdown(uint32 seconds)
+{
+    static const std::array<ChatBroadcast, MAX_COUNTDOWN + 1> countdown = []
+    {
+        std::array<ChatBroadcast, MAX_COUNTDOWN + 1> all;
+        char buf[128];
+        for (uint32 sec = 0; sec <= MAX_COUNTDOWN; ++sec)
+        {
+            snprintf(buf, sizeof(buf),
+                "|cFF00FFFF[Roguelike]|r Next dungeon in |cFFFFFFFF%u|r second%s...",
+                sec, sec != 1 ? "s" : "");
+            all[sec].Set(buf);
+        }
+        return all;
+    }();
+    return countdown[std::min(seconds, MAX_COUNTDOWN)];
+}
+
+} // namespace DungeonMaster
@@ -0,0 +1,62 @@
+/*
+ * mod-dungeon-master — DMChat.h
+ * Party announcements: a system message is formatted once per event and
+ * serialized into SMSG_MESSAGECHAT once, then the same packet goes to every
+ * member, the way Group::BroadcastPacket does. Fixed texts are built on first use.
+ */
+
+#ifndef DM_CHAT_H
+#define DM_CHAT_H
+
+#include "Define.h"
+#include "WorldPacket.h"
+#include <string_view>
+#include <vector>
+
+class Player;
+
+namespace DungeonMaster
+{
+
+// Announcements with no variable part, serialized once per process
+enum DMMessageId : uint8
+{
+    MSG_PREPARING = 0,          // populate started
+    MSG_BOSS_NEW_PHASE,
+    MSG_TIME_UP,
+    MSG_REVIVED,                // auto-rez at the entrance
+    MSG_PLAYER_FALLEN,
+    MSG_PARTY_WIPED,
+    MSG_CHALLENGE_COMPLETE,
+    MSG_CHALLENGE_ENDED,
+    MAX_DM_MESSAGES
+};
+
+class ChatBroadcast
+{
+public:
+    ChatBroadcast() = default;
+    explicit ChatBroadcast(std::string_view text) { Set(text); }
+
+    // One packet per line, as ChatHandler::SendSysMessage splits them
+    void Set(std::string_view text);
+    bool IsEmpty() const { return _packets.empty(); }
+
+    // Null and sessionless players are skipped
+    void SendTo(Player* player) const;
+    void SendTo(const std::vector<Player*>& players) const;
+
+    static const ChatBroadcast& Get(DMMessageId id);
+
+    // "[Roguelike] Next dungeon in N second(s)...", for N up to MAX_COUNTDOWN
+    static const ChatBroadcast& Countdown(uint32 seconds);
+
+    static constexpr uint32 MAX_COUNTDOWN = 30;
+
+private:
+    std::vector<WorldPacket> _packets;
+};
+
+} // namespace DungeonMaster
+
+#endif // DM_CHAT_H
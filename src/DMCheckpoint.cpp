@@ -0,0 +1,198 @@
+/*
+ * mod-dungeon-master — DMCheckpoint.cpp
+ * dm_checkpoints encoding, diffed writes and startup recovery.
+ */
+
+#include "DMCheckpoint.h"
+#include "DMTypes.h"
+#include "DMMemory.h"
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include <bit>
+#include <cstdio>
+
+namespace DungeonMaster
+{
+
+uint32 PlayerCheckpoint::CountDead() const
+{
+    uint32 dead = 0;
+    for (char c : DeadMask)
+    {
+        uint32 nibble = (c >= 'a') ? uint32(c - 'a' + 10) : (c >= 'A') ? uint32(c - 'A' + 10) : uint32(c - '0');
+        dead += std::popcount(nibble & 0xF);
+    }
+    return dead;
+}
+
+std::string CheckpointStore::EncodeDeadMask(const SpawnRoster& roster)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string mask;
+    mask.reserve((roster.size() + 7) / 8 * 2);
+    for (uint32 i = 0; i < roster.size(); i += 8)
+    {
+        uint8 byte = 0;
+        for (uint32 b = 0; b < 8 && i + b < roster.size(); ++b)
+            if (roster.Has(i + b, SPAWN_DEAD))
+                byte |= uint8(1u << b);
+        mask += hex[byte >> 4];
+        mask += hex[byte & 0xF];
+    }
+    return mask;
+}
+
+// Every field is numeric or hex / digit lists, so nothing needs escaping.
+// The dead mask grows with the roster, so it is appended rather than formatted.
+std::string CheckpointStore::RowValues(const PlayerCheckpoint& cp)
+{
+    char head[128];
+    snprintf(head, sizeof(head), "(%u,%u,%u,%u,%u,%llu,%u,'",
+        cp.Guid, cp.LeaderGuid, cp.MapId, cp.InstanceId, cp.DifficultyId,
+        static_cast<unsigned long long>(cp.Seed), cp.Creatures);
+
+    char tail[192];
+    snprintf(tail, sizeof(tail), "',%u,%u,'%s',%u,%.2f,%.2f,%.2f,%.3f)",
+        cp.Tier, cp.BuffStacks, cp.Affixes.c_str(), cp.ReturnMapId,
+        cp.ReturnPos.GetPositionX(), cp.ReturnPos.GetPositionY(),
+        cp.ReturnPos.GetPositionZ(), cp.ReturnPos.GetOrientation());
+
+    return head + cp.DeadMask + tail;
+}
+
+void CheckpointStore::Load()
+{
+    QueryResult result = CharacterDatabase.Query(
+        "SELECT guid, leader_guid, map_id, instance_id, difficulty_id, seed, creatures, dead_mask, "
+        "tier, buff_stacks, affixes, return_map, return_x, return_y, return_z, return_o FROM dm_checkpoints");
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _recoveries.clear();
+    _written.clear();
+    if (!result)
+        return;
+
+    do
+    {
+        Field* f = result->Fetch();
+        PlayerCheckpoint cp;
+        cp.Guid         = f[0].Get<uint32>();
+        cp.LeaderGuid   = f[1].Get<uint32>();
+        cp.MapId        = f[2].Get<uint32>();
+        cp.InstanceId   = f[3].Get<uint32>();
+        cp.DifficultyId = f[4].Get<uint32>();
+        cp.Seed         = f[5].Get<uint64>();
+        cp.Creatures    = f[6].Get<uint32>();
+        cp.DeadMask     = f[7].Get<std::string>();
+        cp.Tier         = f[8].Get<uint32>();
+        cp.BuffStacks   = f[9].Get<uint32>();
+        cp.Affixes      = f[10].Get<std::string>();
+        cp.ReturnMapId  = f[11].Get<uint32>();
+        cp.ReturnPos    = { f[12].Get<float>(), f[13].Get<float>(), f[14].Get<float>(), f[15].Get<float>() };
+        _recoveries[cp.Guid] = std::move(cp);
+    } while (result->NextRow());
+
+    LOG_INFO("module", "DungeonMaster: {} player(s) have runs interrupted by the last shutdown; "
+        "they are returned on login.", _recoveries.size());
+}
+
+void CheckpointStore::Write(const std::vector<PlayerCheckpoint>& rows)
+{
+    std::string replace;
+    std::string remove;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::unordered_map<uint32, std::string> written;
+        written.reserve(rows.size());
+        for (const PlayerCheckpoint& cp : rows)
+        {
+            std::string values = RowValues(cp);
+            auto it = _written.find(cp.Guid);
+            if (it == _written.end() || it->second != values)
+            {
+                replace += replace.empty()
+                    ? "REPLACE INTO dm_checkpoints (guid, leader_guid, map_id, instance_id, difficulty_id, "
+                      "seed, creatures, dead_mask, tier, buff_stacks, affixes, return_map, "
+                      "return_x, return_y, return_z, return_o) VALUES "
+                    : ",";
+                replace += values;
+            }
+            written.emplace(cp.Guid, std::move(values));
+        }
+
+        for (const auto& [guidLow, values] : _written)
+        {
+            if (written.count(guidLow))
+                continue;
+            remove += remove.empty() ? "DELETE FROM dm_checkpoints WHERE guid IN (" : ",";
+            remove += std::to_string(guidLow);
+        }
+        _written.swap(written);
+    }
+
+    if (replace.empty() && remove.empty())
+        return;
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    if (!replace.empty())
+        trans->Append(replace);
+    if (!remove.empty())
+        trans->Append(remove + ")");
+    CharacterDatabase.CommitTransaction(trans);
+}
+
+// The row is deleted at once, so a crash before the next Write cannot bring a
+// finished run back as an interrupted one. That delete may still run on another
+// async worker ahead of an earlier REPLACE, so the row is also closed: an empty
+// tuple never matches, and the next Write deletes it again in its own
+// transaction, or rewrites it if the player is in a session again.
+void CheckpointStore::Forget(uint32 guidLow)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _written.find(guidLow);
+        if (it == _written.end())
+            return;
+        it->second.clear();
+    }
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    trans->Append("DELETE FROM dm_checkpoints WHERE guid = " + std::to_string(guidLow));
+    CharacterDatabase.CommitTransaction(trans);
+}
+
+// This process has not written the row yet (the player was in no session
+// before this login), so deleting it straight away cannot overtake a REPLACE
+bool CheckpointStore::TakeRecovery(uint32 guidLow, PlayerCheckpoint& out)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _recoveries.find(guidLow);
+        if (it == _recoveries.end())
+            return false;
+        out = std::move(it->second);
+        _recoveries.erase(it);
+    }
+    CharacterDatabase.Execute("DELETE FROM dm_checkpoints WHERE guid = " + std::to_string(guidLow));
+    return true;
+}
+
+uint32 CheckpointStore::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<uint32>(_recoveries.size());
+}
+
+uint64 CheckpointStore::GetHeapBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint64 bytes = HeapBytes(_recoveries) + HeapBytes(_written);
+    for (const auto& [guidLow, cp] : _recoveries)
+        bytes += HeapBytes(cp.DeadMask) + HeapBytes(cp.Affixes);
+    for (const auto& [guidLow, values] : _written)
+        bytes += HeapBytes(values);
+    return bytes;
+}
+
+} // namespace DungeonMaster
@@ -0,0 +1,75 @@
+/*
+ * mod-dungeon-master — DMCheckpoint.h
+ * Crash recovery: every player in a live session or roguelike run has a
+ * compact dm_checkpoints row, rewritten asynchronously when it changes. Rows
+ * left behind by a restart are loaded at startup and consumed on login.
+ */
+
+#ifndef DM_CHECKPOINT_H
+#define DM_CHECKPOINT_H
+
+#include "Define.h"
+#include "Position.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DungeonMaster
+{
+
+class SpawnRoster;
+
+// One dm_checkpoints row
+struct PlayerCheckpoint
+{
+    uint32      Guid         = 0;       // player guid low, primary key
+    uint32      LeaderGuid   = 0;
+    uint32      MapId        = 0;
+    uint32      InstanceId   = 0;
+    uint32      DifficultyId = 0;
+    uint64      Seed         = 0;       // population seed, handed back for a replay
+    uint32      Creatures    = 0;       // roster size the dead mask covers
+    std::string DeadMask;               // hex, one bit per roster slot
+    uint32      RunId        = 0;       // in-memory only; 0 = standalone
+    uint32      Tier         = 0;       // roguelike tier; 0 = standalone
+    uint32      BuffStacks   = 0;
+    std::string Affixes;                // affix ids, comma-separated
+    uint32      ReturnMapId  = 0;
+    Position    ReturnPos;
+
+    uint32 CountDead() const;
+};
+
+class CheckpointStore
+{
+public:
+    static std::string EncodeDeadMask(const SpawnRoster& roster);
+
+    // Startup: every row the last process left becomes a pending recovery
+    void   Load();
+
+    // Rows for every player currently in a session. Unchanged rows are skipped;
+    // players written before but absent now are deleted. One async transaction.
+    void   Write(const std::vector<PlayerCheckpoint>& rows);
+
+    // Session ended normally; the row is deleted now and again by the next Write
+    void   Forget(uint32 guidLow);
+
+    // Login: hands out and deletes the player's recovery, if any
+    bool   TakeRecovery(uint32 guidLow, PlayerCheckpoint& out);
+
+    uint32 GetPendingCount() const;
+    uint64 GetHeapBytes() const;        // .dm mem
+
+private:
+    static std::string RowValues(const PlayerCheckpoint& cp);
+
+    std::unordered_map<uint32, PlayerCheckpoint> _recoveries;    // guid low -> row from before the restart
+    std::unordered_map<uint32, std::string>      _written;       // guid low -> VALUES tuple last written; empty = closed
+    mutable std::mutex _mutex;
+};
+
+} // namespace DungeonMaster
+
+#endif // DM_CHECKPOINT_H
@@ -78,7 +78,17 @@ void DMConfig::LoadConfig(bool reload)
     _bossCount       = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.BossCount",      1);
     _eliteChance     = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.EliteChance",    20);
     _aggroRadius     = sConfigMgr->GetOption<float> ("DungeonMaster.Dungeon.AggroRadius",    15.0f);
+    _aggroScanInterval = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.AggroScanInterval", 250);
+    _aggroMaxLosChecks = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.AggroMaxLosChecks", 16);
+    _activationRadius  = sConfigMgr->GetOption<float> ("DungeonMaster.Dungeon.ActivationRadius", 60.0f);
+    _bossSpellGCD      = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.BossSpellGCD", 1500);
+    _packRadius      = sConfigMgr->GetOption<float> ("DungeonMaster.Dungeon.PackRadius",     8.0f);
+    _packMaxSize     = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.PackMaxSize",    5);
+    _streamAhead     = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.StreamAhead",    150);
     _rareSpawnChance = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.RareSpawnChance", 5);
+    _liveCreatureBudget = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.LiveCreatureBudget", 5000);
+    _loadTargetDiff     = sConfigMgr->GetOption<uint32>("DungeonMaster.Dungeon.LoadTargetDiff", 100);
+    _minDensity         = sConfigMgr->GetOption<float> ("DungeonMaster.Dungeon.MinDensity", 0.5f);
     _rareHealthMult  = sConfigMgr->GetOption<float> ("DungeonMaster.Scaling.RareHealthMult",  4.0f);
     _rareDamageMult  = sConfigMgr->GetOption<float> ("DungeonMaster.Scaling.RareDamageMult",  2.0f);
 
@@ -96,6 +106,14 @@ void DMConfig::LoadConfig(bool reload)
     _completionTeleportDelay = sConfigMgr->GetOption<uint32>("DungeonMaster.Completion.TeleportDelay", 30);
     _announceCompletion      = sConfigMgr->GetOption<bool>  ("DungeonMaster.Completion.Announcement",  true);
 
+    // Statistics
+    _statsCacheSize     = sConfigMgr->GetOption<uint32>("DungeonMaster.Stats.CacheSize",     1000);
+    _statsFlushInterval = sConfigMgr->GetOption<uint32>("DungeonMaster.Stats.FlushInterval", 30);
+    _checkpointInterval = sConfigMgr->GetOption<uint32>("DungeonMaster.Checkpoint.Interval", 15);
+
+    // Diagnostics
+    _perfEnabled = sConfigMgr->GetOption<bool>("DungeonMaster.Perf.Enable", true);
+
     // Roguelike
     _roguelikeEnabled         = sConfigMgr->GetOption<bool>  ("DungeonMaster.Roguelike.Enable",            true);
     _roguelikeTransitionDelay = sConfigMgr->GetOption<uint32>("DungeonMaster.Roguelike.TransitionDelay",   30);
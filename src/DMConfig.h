@@ -69,7 +69,17 @@ public:
     uint32 GetBossCount()       const { return _bossCount; }
     uint32 GetEliteChance()     const { return _eliteChance; }
     float  GetAggroRadius()     const { return _aggroRadius; }
+    uint32 GetAggroScanInterval()  const { return _aggroScanInterval; }
+    uint32 GetAggroMaxLosChecks()  const { return _aggroMaxLosChecks; }
+    float  GetActivationRadius()   const { return _activationRadius; }
+    uint32 GetBossSpellGCD()       const { return _bossSpellGCD; }
+    float  GetPackRadius()      const { return _packRadius; }
+    uint32 GetPackMaxSize()     const { return _packMaxSize; }
+    uint32 GetStreamAhead()     const { return _streamAhead; }
     uint32 GetRareSpawnChance() const { return _rareSpawnChance; }
+    uint32 GetLiveCreatureBudget() const { return _liveCreatureBudget; }
+    uint32 GetLoadTargetDiff()     const { return _loadTargetDiff; }
+    float  GetMinDensity()         const { return _minDensity; }
     float  GetRareHealthMult()  const { return _rareHealthMult; }
     float  GetRareDamageMult()  const { return _rareDamageMult; }
 
@@ -87,6 +97,14 @@ public:
     uint32 GetCompletionTeleportDelay() const { return _completionTeleportDelay; }
     bool   ShouldAnnounceCompletion()   const { return _announceCompletion; }
 
+    // --- Statistics ---
+    uint32 GetStatsCacheSize()     const { return _statsCacheSize; }
+    uint32 GetStatsFlushInterval() const { return _statsFlushInterval; }
+    uint32 GetCheckpointInterval() const { return _checkpointInterval; }
+
+    // --- Diagnostics ---
+    bool   IsPerfEnabled()         const { return _perfEnabled; }
+
     // --- Roguelike Mode ---
     bool   IsRoguelikeEnabled()             const { return _roguelikeEnabled; }
     uint32 GetRoguelikeTransitionDelay()    const { return _roguelikeTransitionDelay; }
@@ -144,7 +162,17 @@ private:
     uint32 _bossCount       = 1;
     uint32 _eliteChance     = 20;
     float  _aggroRadius     = 15.0f;
+    uint32 _aggroScanInterval = 250;
+    uint32 _aggroMaxLosChecks = 16;
+    float  _activationRadius  = 60.0f;
+    uint32 _bossSpellGCD      = 1500;
+    float  _packRadius      = 8.0f;
+    uint32 _packMaxSize     = 5;
+    uint32 _streamAhead     = 150;
     uint32 _rareSpawnChance = 5;
+    uint32 _liveCreatureBudget = 5000;
+    uint32 _loadTargetDiff     = 100;
+    float  _minDensity         = 0.5f;
     float  _rareHealthMult  = 4.0f;
     float  _rareDamageMult  = 2.0f;
 
@@ -162,6 +190,14 @@ private:
     uint32 _completionTeleportDelay = 30;
     bool   _announceCompletion      = true;
 
+    // Statistics
+    uint32 _statsCacheSize     = 1000;
+    uint32 _statsFlushInterval = 30;
+    uint32 _checkpointInterval = 15;
+
+    // Diagnostics
+    bool   _perfEnabled        = true;
+
     // Roguelike
     bool   _roguelikeVendorEnabled = true;
     bool   _roguelikeEnabled          = true;
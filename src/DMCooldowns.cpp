@@ -0,0 +1,151 @@
+/*
+ * mod-dungeon-master — DMCooldowns.cpp
+ * Cooldown lookup, heap-ordered expiry and dm_cooldowns persistence.
+ */
+
+#include "DMCooldowns.h"
+#include "DMMemory.h"
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include <algorithm>
+#include <string>
+
+namespace DungeonMaster
+{
+
+bool CooldownStore::IsActive(ObjectGuid guid, uint64 now) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _expiresAt.find(guid);
+    return it != _expiresAt.end() && now < it->second;
+}
+
+uint32 CooldownStore::GetRemaining(ObjectGuid guid, uint64 now) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _expiresAt.find(guid);
+    if (it == _expiresAt.end() || now >= it->second)
+        return 0;
+    return static_cast<uint32>(it->second - now);
+}
+
+void CooldownStore::Push(ObjectGuid guid, uint64 expiresAt)
+{
+    _expiresAt[guid] = expiresAt;
+    _heap.push_back({ expiresAt, guid });
+    std::push_heap(_heap.begin(), _heap.end(), ExpiresLater);
+}
+
+void CooldownStore::Set(ObjectGuid guid, uint64 expiresAt)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Push(guid, expiresAt);
+    _dirty[guid.GetCounter()] = expiresAt;
+}
+
+void CooldownStore::Clear(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_expiresAt.erase(guid))
+        _dirty[guid.GetCounter()] = 0;
+}
+
+uint32 CooldownStore::Purge(uint64 now)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint32 ended = 0;
+    while (!_heap.empty() && _heap.front().ExpiresAt <= now)
+    {
+        HeapEntry top = _heap.front();
+        std::pop_heap(_heap.begin(), _heap.end(), ExpiresLater);
+        _heap.pop_back();
+
+        // Stale if the cooldown was cleared or set again since this entry was pushed
+        auto it = _expiresAt.find(top.Guid);
+        if (it != _expiresAt.end() && it->second == top.ExpiresAt)
+        {
+            _expiresAt.erase(it);
+            ++ended;
+        }
+    }
+
+    // Cleared cooldowns can leave the heap mostly stale; rebuild before it gets lopsided
+    if (_heap.size() > 64 && _heap.size() > 2 * _expiresAt.size())
+    {
+        _heap.clear();
+        for (const auto& [guid, expiresAt] : _expiresAt)
+            _heap.push_back({ expiresAt, guid });
+        std::make_heap(_heap.begin(), _heap.end(), ExpiresLater);
+    }
+    return ended;
+}
+
+void CooldownStore::Load(uint64 now)
+{
+    CharacterDatabase.Execute("DELETE FROM dm_cooldowns WHERE expires_at <= " + std::to_string(now));
+
+    QueryResult result = CharacterDatabase.Query(
+        "SELECT guid, expires_at FROM dm_cooldowns WHERE expires_at > " + std::to_string(now));
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _expiresAt.clear();
+    _heap.clear();
+    _dirty.clear();
+    if (!result)
+        return;
+
+    do
+    {
+        Field* f = result->Fetch();
+        Push(ObjectGuid::Create<HighGuid::Player>(f[0].Get<uint32>()), f[1].Get<uint64>());
+    } while (result->NextRow());
+
+    LOG_INFO("module", "DungeonMaster: Restored {} running cooldowns.", _expiresAt.size());
+}
+
+void CooldownStore::Flush()
+{
+    std::string replace;
+    std::string remove;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& [guidLow, expiresAt] : _dirty)
+        {
+            if (expiresAt)
+            {
+                replace += replace.empty() ? "REPLACE INTO dm_cooldowns (guid, expires_at) VALUES " : ",";
+                replace += "(" + std::to_string(guidLow) + "," + std::to_string(expiresAt) + ")";
+            }
+            else
+            {
+                remove += remove.empty() ? "DELETE FROM dm_cooldowns WHERE guid IN (" : ",";
+                remove += std::to_string(guidLow);
+            }
+        }
+        _dirty.clear();
+    }
+
+    if (replace.empty() && remove.empty())
+        return;
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    if (!replace.empty())
+        trans->Append(replace);
+    if (!remove.empty())
+        trans->Append(remove + ")");
+    CharacterDatabase.CommitTransaction(trans);
+}
+
+uint32 CooldownStore::GetCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<uint32>(_expiresAt.size());
+}
+
+uint64 CooldownStore::GetHeapBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return HeapBytes(_expiresAt) + HeapBytes(_heap) + HeapBytes(_dirty);
+}
+
+} // namespace DungeonMaster
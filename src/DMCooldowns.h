@@ -0,0 +1,60 @@
+/*
+ * mod-dungeon-master — DMCooldowns.h
+ * Per-character run cooldowns: a lookup map for gossip checks beside an
+ * expiry-ordered min-heap for purging, persisted to dm_cooldowns in batches.
+ */
+
+#ifndef DM_COOLDOWNS_H
+#define DM_COOLDOWNS_H
+
+#include "Define.h"
+#include "ObjectGuid.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace DungeonMaster
+{
+
+// Times are unix seconds (GameTime). The heap is lazily pruned: a Clear or a
+// re-Set leaves the old heap entry behind, and Purge drops it once it surfaces
+// without matching the map. Purge therefore only touches entries that are due.
+class CooldownStore
+{
+public:
+    bool   IsActive(ObjectGuid guid, uint64 now) const;
+    uint32 GetRemaining(ObjectGuid guid, uint64 now) const;
+    void   Set(ObjectGuid guid, uint64 expiresAt);
+    void   Clear(ObjectGuid guid);
+    uint32 Purge(uint64 now);           // returns cooldowns that ended
+
+    // Startup: rows still running; expired rows are deleted
+    void   Load(uint64 now);
+
+    // Every Set / Clear since the last flush as one REPLACE and one DELETE
+    void   Flush();
+
+    uint32 GetCount() const;
+    uint64 GetHeapBytes() const;        // .dm mem
+
+private:
+    struct HeapEntry
+    {
+        uint64     ExpiresAt;
+        ObjectGuid Guid;
+    };
+
+    // std::push_heap keeps the greatest on top; invert for earliest expiry
+    static bool ExpiresLater(const HeapEntry& a, const HeapEntry& b) { return a.ExpiresAt > b.ExpiresAt; }
+
+    void Push(ObjectGuid guid, uint64 expiresAt);
+
+    std::unordered_map<ObjectGuid, uint64> _expiresAt;
+    std::vector<HeapEntry>                 _heap;
+    std::unordered_map<uint32, uint64>     _dirty;      // guid low -> expiry; 0 = delete the row
+    mutable std::mutex _mutex;
+};
+
+} // namespace DungeonMaster
+
+#endif // DM_COOLDOWNS_H
@@ -0,0 +1,57 @@
+/*
+ * mod-dungeon-master — DMMemory.h
+ * Heap estimates for .dm mem: container capacity times element size, plus
+ * node and bucket overhead for hashed and ordered containers. Elements that
+ * own further heap (strings, nested vectors) are counted by the caller.
+ */
+
+#ifndef DM_MEMORY_H
+#define DM_MEMORY_H
+
+#include "Define.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace DungeonMaster
+{
+
+template <class T, class A>
+uint64 HeapBytes(const std::vector<T, A>& v)
+{
+    return static_cast<uint64>(v.capacity()) * sizeof(T);
+}
+
+// One node per element (value + next pointer + cached hash) and one pointer per bucket
+template <class K, class V, class H, class E, class A>
+uint64 HeapBytes(const std::unordered_map<K, V, H, E, A>& m)
+{
+    return static_cast<uint64>(m.size()) * (sizeof(std::pair<const K, V>) + 2 * sizeof(void*))
+         + static_cast<uint64>(m.bucket_count()) * sizeof(void*);
+}
+
+template <class K, class H, class E, class A>
+uint64 HeapBytes(const std::unordered_set<K, H, E, A>& s)
+{
+    return static_cast<uint64>(s.size()) * (sizeof(K) + 2 * sizeof(void*))
+         + static_cast<uint64>(s.bucket_count()) * sizeof(void*);
+}
+
+// Red-black node: value, three links and a colour word
+template <class K, class V, class C, class A>
+uint64 HeapBytes(const std::map<K, V, C, A>& m)
+{
+    return static_cast<uint64>(m.size()) * (sizeof(std::pair<const K, V>) + 4 * sizeof(void*));
+}
+
+// Heap beyond the small-string buffer only
+inline uint64 HeapBytes(const std::string& s)
+{
+    return s.capacity() > 15 ? static_cast<uint64>(s.capacity()) + 1 : 0;
+}
+
+} // namespace DungeonMaster
+
+#endif // DM_MEMORY_H
@@ -0,0 +1,202 @@
+/*
+ * mod-dungeon-master — DMPerf.cpp
+ * Rolling timing windows for the update loops.
+ */
+
+#include "DMPerf.h"
+#include "DMConfig.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace DungeonMaster
+{
+
+DMPerf* DMPerf::Instance()
+{
+    static DMPerf instance;
+    return &instance;
+}
+
+void DMPerf::Record(PerfPhase phase, uint32 micros)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Window& w = _windows[phase];
+    w.Samples[w.Next] = micros;
+    w.Next = (w.Next + 1) % WINDOW_SIZE;
+    ++w.Count;
+}
+
+PerfSnapshot DMPerf::GetSnapshot(PerfPhase phase) const
+{
+    Window w;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        w = _windows[phase];
+    }
+    return Summarize(w);
+}
+
+// Sorts a copy; callers snapshot the window under the lock first
+PerfSnapshot DMPerf::Summarize(const Window& w)
+{
+    PerfSnapshot snap;
+    snap.Count = w.Count;
+
+    size_t n = static_cast<size_t>(std::min<uint64>(snap.Count, WINDOW_SIZE));
+    if (n == 0)
+        return snap;
+
+    // Before the window first wraps, only the first n slots hold samples
+    std::array<uint32, WINDOW_SIZE> sorted = w.Samples;
+    std::sort(sorted.begin(), sorted.begin() + n);
+    snap.P50 = sorted[(n - 1) * 50 / 100];
+    snap.P99 = sorted[(n - 1) * 99 / 100];
+    snap.Max = sorted[n - 1];
+    return snap;
+}
+
+void DMPerf::RecordLoad(uint32 sessions, uint32 creatures, uint64 stateBytes, uint32 micros)
+{
+    uint32 band = std::min(sessions / LOAD_BAND_WIDTH, LOAD_BANDS - 1);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    LoadBand& b = _loadBands[band];
+    b.Ticks.Samples[b.Ticks.Next] = micros;
+    b.Ticks.Next = (b.Ticks.Next + 1) % WINDOW_SIZE;
+    ++b.Ticks.Count;
+    b.SessionSum  += sessions;
+    b.CreatureSum += creatures;
+
+    _peakSessions   = std::max(_peakSessions, sessions);
+    _peakStateBytes = std::max(_peakStateBytes, stateBytes);
+}
+
+LoadBandSnapshot DMPerf::GetLoadSnapshot(uint32 band) const
+{
+    LoadBandSnapshot snap;
+    if (band >= LOAD_BANDS)
+        return snap;
+
+    snap.MinSessions = band * LOAD_BAND_WIDTH;
+    snap.MaxSessions = (band == LOAD_BANDS - 1) ? UINT32_MAX : snap.MinSessions + LOAD_BAND_WIDTH - 1;
+
+    LoadBand b;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        b = _loadBands[band];
+    }
+    snap.Tick = Summarize(b.Ticks);
+    if (b.SessionSum)
+        snap.CreaturesPerSession = static_cast<float>(b.CreatureSum) / static_cast<float>(b.SessionSum);
+    return snap;
+}
+
+uint32 DMPerf::GetPeakSessions() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _peakSessions;
+}
+
+uint64 DMPerf::GetPeakStateBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _peakStateBytes;
+}
+
+void DMPerf::Reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& w : _windows)
+        w = Window{};
+    for (auto& b : _loadBands)
+        b = LoadBand{};
+    _peakSessions   = 0;
+    _peakStateBytes = 0;
+    for (auto& c : _counters)
+        c.Value.store(0, std::memory_order_relaxed);
+}
+
+const char* DMPerf::GetPhaseName(PerfPhase phase)
+{
+    switch (phase)
+    {
+        case PERF_UPDATE_TOTAL:     return "Update (total)";
+        case PERF_DEATH_POLL:       return "Death poll";
+        case PERF_STREAM:           return "Streaming";
+        case PERF_PHASE_CHECKS:     return "Phase checks";
+        case PERF_STRAY_SWEEP:      return "Stray sweep";
+        case PERF_AUTO_REZ:         return "Auto-rez";
+        case PERF_TIME_LIMIT:       return "Time limit";
+        case PERF_COOLDOWN_PURGE:   return "Cooldown purge";
+        case PERF_ROGUELIKE_UPDATE: return "Roguelike update";
+        case PERF_POPULATE:         return "PopulateDungeon";
+        case PERF_DAMAGE_HOOK:      return "Damage hook";
+        case PERF_AGGRO_SCAN:       return "Aggro scan";
+        default:                    return "?";
+    }
+}
+
+const char* DMPerf::GetCounterName(HookCounter counter)
+{
+    switch (counter)
+    {
+        case HOOK_DAMAGE_CALLS:           return "Damage calls";
+        case HOOK_DAMAGE_EARLY_OUT:       return "  early out";
+        case HOOK_DAMAGE_FAST_REJECT:     return "  fast reject";
+        case HOOK_DAMAGE_SESSION_MISS:    return "  filter miss";
+        case HOOK_DAMAGE_SESSION_HIT:     return "  session hit";
+        case HOOK_DAMAGE_CREATURE_SCALED: return "  creature scaled";
+        case HOOK_DAMAGE_ENV_SCALED:      return "  env scaled";
+        case HOOK_DEATH_CALLS:            return "Death calls";
+        case HOOK_DEATH_FAST_REJECT:      return "  fast reject";
+        case HOOK_DEATH_SESSION_HIT:      return "  session hit";
+        case HOOK_AGGRO_CANDIDATES:       return "Aggro candidates";
+        case HOOK_AGGRO_LOS_CHECKS:       return "  LOS checks";
+        case HOOK_AGGRO_LOS_DEFERRED:     return "  LOS deferred";
+        case HOOK_AGGRO_PULLS:            return "  pulls";
+        case HOOK_LOS_CACHE_HIT:          return "LOS cache hits";
+        case HOOK_LOS_CACHE_MISS:         return "LOS cache misses";
+        case HOOK_CREATURE_WAKES:         return "Creature wakes";
+        case HOOK_CREATURE_SLEEPS:        return "Creature sleeps";
+        case HOOK_PARTY_LOOKUPS:          return "Party lookups";
+        case HOOK_PARTY_LOOKUPS_SAVED:    return "  saved by reuse";
+        default:                          return "?";
+    }
+}
+
+void PerfTickAccumulator::Commit()
+{
+    for (uint8 i = 0; i < MAX_PERF_PHASES; ++i)
+        if (_ran[i])
+            sDMPerf->Record(static_cast<PerfPhase>(i), _micros[i]);
+}
+
+PerfScope::PerfScope(PerfPhase phase, PerfTickAccumulator* acc)
+    : _phase(phase), _acc(acc), _active(sDMConfig->IsPerfEnabled())
+{
+    if (_active)
+        _start = std::chrono::steady_clock::now();
+}
+
+uint32 PerfScope::ElapsedMicros() const
+{
+    if (!_active)
+        return 0;
+
+    return static_cast<uint32>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _start).count());
+}
+
+PerfScope::~PerfScope()
+{
+    if (!_active)
+        return;
+
+    uint32 micros = ElapsedMicros();
+    if (_acc)
+        _acc->Add(_phase, micros);
+    else
+        sDMPerf->Record(_phase, micros);
+}
+
+} // namespace DungeonMaster
@@ -0,0 +1,179 @@
+/*
+ * mod-dungeon-master — DMPerf.h
+ * Lightweight per-phase timing for the update loops (read via .dm perf).
+ */
+
+#ifndef DM_PERF_H
+#define DM_PERF_H
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace DungeonMaster
+{
+
+enum PerfPhase : uint8
+{
+    PERF_UPDATE_TOTAL = 0,      // whole DungeonMasterMgr::Update tick
+    PERF_DEATH_POLL,
+    PERF_STREAM,                // StreamPopulation from the Update tick
+    PERF_PHASE_CHECKS,
+    PERF_STRAY_SWEEP,
+    PERF_AUTO_REZ,
+    PERF_TIME_LIMIT,
+    PERF_COOLDOWN_PURGE,
+    PERF_ROGUELIKE_UPDATE,
+    PERF_POPULATE,
+    PERF_DAMAGE_HOOK,           // dm_unit_script damage scaling, past the fast reject
+    PERF_AGGRO_SCAN,            // one instance's aggro scheduler pass
+    MAX_PERF_PHASES
+};
+
+// Invocation counters for the world-wide unit hooks and the aggro scheduler (.dm perf hooks)
+enum HookCounter : uint8
+{
+    HOOK_DAMAGE_CALLS = 0,      // every damage hook invocation
+    HOOK_DAMAGE_EARLY_OUT,      // disabled, zero damage, non-player target, PvP
+    HOOK_DAMAGE_FAST_REJECT,    // filtered by the lock-free session membership check
+    HOOK_DAMAGE_SESSION_MISS,   // passed the filter but not in a session (filter collision)
+    HOOK_DAMAGE_SESSION_HIT,
+    HOOK_DAMAGE_CREATURE_SCALED,
+    HOOK_DAMAGE_ENV_SCALED,
+    HOOK_DEATH_CALLS,
+    HOOK_DEATH_FAST_REJECT,
+    HOOK_DEATH_SESSION_HIT,
+    HOOK_AGGRO_CANDIDATES,      // idle creature within aggro range of a player
+    HOOK_AGGRO_LOS_CHECKS,
+    HOOK_AGGRO_LOS_DEFERRED,    // over the per-scan LOS cap, retried next scan
+    HOOK_AGGRO_PULLS,
+    HOOK_LOS_CACHE_HIT,         // aggro LOS answered from the per-instance cache
+    HOOK_LOS_CACHE_MISS,        // raycast performed
+    HOOK_CREATURE_WAKES,        // setActive(true) as players approach
+    HOOK_CREATURE_SLEEPS,       // setActive(false) once players move away
+    HOOK_PARTY_LOOKUPS,         // FindPlayer calls made resolving a session's party
+    HOOK_PARTY_LOOKUPS_SAVED,   // member lookups answered from the resolved party instead
+    MAX_HOOK_COUNTERS
+};
+
+struct PerfSnapshot
+{
+    uint64 Count = 0;           // samples recorded since start / reset
+    uint32 P50   = 0;           // microseconds, over the rolling window
+    uint32 P99   = 0;
+    uint32 Max   = 0;
+};
+
+// Update tick cost at one concurrency level (.dm perf load)
+struct LoadBandSnapshot
+{
+    PerfSnapshot Tick;
+    uint32 MinSessions      = 0;
+    uint32 MaxSessions      = 0;    // inclusive; UINT32_MAX for the open-ended last band
+    float  CreaturesPerSession = 0.0f;
+};
+
+class DMPerf
+{
+    DMPerf() = default;
+
+public:
+    static DMPerf* Instance();
+
+    void         Record(PerfPhase phase, uint32 micros);
+    PerfSnapshot GetSnapshot(PerfPhase phase) const;
+    void         Reset();
+
+    // Update ticks bucketed by concurrent session count, for sizing MaxConcurrentRuns
+    void             RecordLoad(uint32 sessions, uint32 creatures, uint64 stateBytes, uint32 micros);
+    LoadBandSnapshot GetLoadSnapshot(uint32 band) const;
+    uint32           GetPeakSessions()   const;
+    uint64           GetPeakStateBytes() const;
+
+    static const char* GetPhaseName(PerfPhase phase);
+    static const char* GetCounterName(HookCounter counter);
+
+    // Relaxed and cache-line padded: hooks fire from every map thread
+    void   Count(HookCounter counter, uint64 n = 1)
+    {
+        _counters[counter].Value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64 GetCount(HookCounter counter) const
+    {
+        return _counters[counter].Value.load(std::memory_order_relaxed);
+    }
+
+    // Rolling window per phase; percentiles are only computed when read
+    static constexpr uint32 WINDOW_SIZE = 512;
+
+    static constexpr uint32 LOAD_BAND_WIDTH = 10;   // sessions per band
+    static constexpr uint32 LOAD_BANDS      = 16;   // last band is open-ended (150+)
+
+private:
+    struct Window
+    {
+        std::array<uint32, WINDOW_SIZE> Samples{};
+        uint32 Next  = 0;
+        uint64 Count = 0;
+    };
+
+    struct alignas(64) PaddedCounter
+    {
+        std::atomic<uint64> Value{0};
+    };
+
+    struct LoadBand
+    {
+        Window Ticks;
+        uint64 SessionSum  = 0;
+        uint64 CreatureSum = 0;
+    };
+
+    static PerfSnapshot Summarize(const Window& w);
+
+    std::array<Window, MAX_PERF_PHASES> _windows;
+    std::array<LoadBand, LOAD_BANDS> _loadBands;
+    uint32 _peakSessions   = 0;
+    uint64 _peakStateBytes = 0;
+    std::array<PaddedCounter, MAX_HOOK_COUNTERS> _counters;
+    mutable std::mutex _mutex;
+};
+
+// Sums a phase across every session in one tick so each tick is one sample
+class PerfTickAccumulator
+{
+public:
+    void Add(PerfPhase phase, uint32 micros) { _micros[phase] += micros; _ran[phase] = true; }
+    void Commit();
+
+private:
+    std::array<uint32, MAX_PERF_PHASES> _micros{};
+    std::array<bool,   MAX_PERF_PHASES> _ran{};
+};
+
+// Times its own scope; a no-op when DungeonMaster.Perf.Enable = 0
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfPhase phase, PerfTickAccumulator* acc = nullptr);
+    ~PerfScope();
+
+    uint32 ElapsedMicros() const;   // 0 when timing is disabled
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    PerfPhase             _phase;
+    PerfTickAccumulator*  _acc;
+    bool                  _active;
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace DungeonMaster
+
+#define sDMPerf DungeonMaster::DMPerf::Instance()
+
+#endif // DM_PERF_H
@@ -0,0 +1,24 @@
+/*
+ * mod-dungeon-master — DMRandom.cpp
+ * Seed source and per-thread fallback stream.
+ */
+
+#include "DMRandom.h"
+#include <random>
+
+namespace DungeonMaster
+{
+
+uint64 NewRandomSeed()
+{
+    std::random_device rd;
+    return (uint64(rd()) << 32) ^ uint64(rd());
+}
+
+DMRng& ThreadRng()
+{
+    static thread_local DMRng rng{ NewRandomSeed() };
+    return rng;
+}
+
+} // namespace DungeonMaster
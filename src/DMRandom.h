@@ -0,0 +1,111 @@
+/*
+ * mod-dungeon-master — DMRandom.h
+ * Seedable xoshiro256** generator. Each session owns a stream seeded at
+ * CreateSession so a dungeon layout can be replayed from its seed.
+ */
+
+#ifndef DM_RANDOM_H
+#define DM_RANDOM_H
+
+#include "Define.h"
+#include <cstdint>
+#include <type_traits>
+
+namespace DungeonMaster
+{
+
+class DMRng
+{
+public:
+    using result_type = uint64;
+
+    explicit DMRng(uint64 seed = 0) { Seed(seed); }
+
+    // Expands the seed through splitmix64 so nearby seeds give unrelated streams
+    void Seed(uint64 seed)
+    {
+        _seed = seed;
+        uint64 x = seed;
+        for (uint64& s : _state)
+        {
+            x += 0x9E3779B97F4A7C15ULL;
+            uint64 z = x;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    uint64 GetSeed() const { return _seed; }
+
+    uint64 Next()
+    {
+        uint64 result = Rotl(_state[1] * 5, 7) * 9;
+        uint64 t = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = Rotl(_state[3], 45);
+        return result;
+    }
+
+    // [0, bound) without modulo bias (Lemire's multiply-shift); bound must be > 0
+    uint32 Below(uint32 bound)
+    {
+        uint64 m = uint64(uint32(Next() >> 32)) * bound;
+        uint32 low = uint32(m);
+        if (low < bound)
+        {
+            uint32 threshold = uint32(-bound) % bound;
+            while (low < threshold)
+            {
+                m   = uint64(uint32(Next() >> 32)) * bound;
+                low = uint32(m);
+            }
+        }
+        return uint32(m >> 32);
+    }
+
+    // Inclusive [lo, hi]
+    template<typename T>
+    T Range(T lo, T hi)
+    {
+        static_assert(std::is_unsigned_v<T>, "DMRng::Range expects an unsigned type");
+        uint64 span = uint64(hi) - uint64(lo);
+        if (span < UINT32_MAX)
+            return lo + static_cast<T>(Below(uint32(span + 1)));
+        return lo + static_cast<T>(span == UINT64_MAX ? Next() : Next() % (span + 1));
+    }
+
+    float Float(float lo, float hi)
+    {
+        return lo + (hi - lo) * (float(Next() >> 40) * (1.0f / 16777216.0f));
+    }
+
+    // Percent roll: true with probability pct / 100
+    bool Chance(uint32 pct) { return Below(100) < pct; }
+
+    // UniformRandomBitGenerator, for std::shuffle
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()() { return Next(); }
+
+private:
+    static uint64 Rotl(uint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64 _state[4];
+    uint64 _seed = 0;
+};
+
+// Fresh seed from std::random_device
+uint64 NewRandomSeed();
+
+// Per-thread stream for rolls that are not part of a session's layout
+// (loot, rewards, boss spell timers, dungeon/theme picks)
+DMRng& ThreadRng();
+
+} // namespace DungeonMaster
+
+#endif // DM_RANDOM_H
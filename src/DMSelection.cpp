@@ -0,0 +1,402 @@
+/*
+ * mod-dungeon-master — DMSelection.cpp
+ * Pure selection and scaling math shared by DungeonMasterMgr and RoguelikeMgr.
+ */
+
+#include "DMSelection.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace DungeonMaster
+{
+
+// ---- Class helpers ----
+
+uint8 GetMaxArmorSubclass(uint32 playerClass)
+{
+    switch (playerClass)
+    {
+        case 5: case 8: case 9:              return 1;  // cloth: Priest, Mage, Warlock
+        case 4: case 11:                     return 2;  // leather: Rogue, Druid
+        case 3: case 7:                      return 3;  // mail: Hunter, Shaman
+        case 1: case 2: case 6:              return 4;  // plate: Warrior, Paladin, DK
+        default:                             return 4;
+    }
+}
+
+uint32 GetClassBitmask(uint32 playerClass)
+{
+    if (playerClass == 0 || playerClass > 11) return 0x7FF;  // all classes
+    return 1 << (playerClass - 1);
+}
+
+uint32 GetPrimaryStatForClass(uint32 playerClass)
+{
+    switch (playerClass)
+    {
+        case 1:  return 4;  // Warrior  -> STR
+        case 2:  return 4;  // Paladin  -> STR
+        case 3:  return 3;  // Hunter   -> AGI
+        case 4:  return 3;  // Rogue    -> AGI
+        case 5:  return 5;  // Priest   -> INT
+        case 6:  return 4;  // DK       -> STR
+        case 7:  return 5;  // Shaman   -> INT
+        case 8:  return 5;  // Mage     -> INT
+        case 9:  return 5;  // Warlock  -> INT
+        case 11: return 3;  // Druid    -> AGI
+        default: return 4;
+    }
+}
+
+void AddItemStat(ItemStatProfile& profile, uint32 statType, int32 statValue)
+{
+    if (statValue <= 0) return;
+
+    float v = static_cast<float>(statValue);
+    profile.Total += v;
+    switch (statType)
+    {
+        case 3: profile.Agility   += v; break;
+        case 4: profile.Strength  += v; break;
+        case 5: profile.Intellect += v; break;
+        default: break;
+    }
+}
+
+float ScoreItemForClass(const ItemStatProfile& profile, uint32 playerClass)
+{
+    if (profile.Total <= 0.0f) return 0.5f;  // No stats (trinket, etc.) = neutral
+
+    float primary;
+    switch (GetPrimaryStatForClass(playerClass))
+    {
+        case 3:  primary = profile.Agility;   break;
+        case 5:  primary = profile.Intellect; break;
+        default: primary = profile.Strength;  break;
+    }
+    return primary / profile.Total;
+}
+
+// ---- Selection ----
+
+bool MatchesAnyType(const std::vector<uint32>& types)
+{
+    return std::find(types.begin(), types.end(), uint32(-1)) != types.end();
+}
+
+uint32 PickPoolEntry(const CreaturePool& pool, const std::vector<uint32>* types,
+                     DMRng& rng, uint32* outCandidates)
+{
+    // Themes list a handful of types, so a linear scan beats a set lookup
+    bool anyType = !types || MatchesAnyType(*types);
+    auto typeMatch = [&](uint32 cType) -> bool
+    {
+        return anyType || std::find(types->begin(), types->end(), cType) != types->end();
+    };
+
+    uint32 total = 0;
+    for (const auto& [type, vec] : pool)
+        if (typeMatch(type))
+            total += static_cast<uint32>(vec.size());
+
+    if (outCandidates)
+        *outCandidates = total;
+    if (!total)
+        return 0;
+
+    uint32 pick = rng.Below(total);
+    for (const auto& [type, vec] : pool)
+    {
+        if (!typeMatch(type)) continue;
+        if (pick < vec.size())
+            return vec[pick].Entry;
+        pick -= static_cast<uint32>(vec.size());
+    }
+    return 0;
+}
+
+// 75% of the time (when enough candidates exist) pick from the top third by class
+// score, otherwise uniformly. nth_element keeps the biased path linear.
+template<typename Item>
+static uint32 PickWeightedForClass(std::vector<const Item*>& cands, uint32 playerClass,
+                                   bool biasAllowed, DMRng& rng)
+{
+    if (biasAllowed && cands.size() > 3 && playerClass > 0 && rng.Chance(75))
+    {
+        size_t topN = std::max<size_t>(3, cands.size() / 3);
+        std::nth_element(cands.begin(), cands.begin() + (topN - 1), cands.end(),
+            [playerClass](const Item* a, const Item* b)
+            {
+                return ScoreItemForClass(a->Stats, playerClass) > ScoreItemForClass(b->Stats, playerClass);
+            });
+        return cands[rng.Below(static_cast<uint32>(topN))]->Entry;
+    }
+
+    return cands[rng.Below(static_cast<uint32>(cands.size()))]->Entry;
+}
+
+ItemPick PickRewardItem(const std::vector<RewardItem>& pool, uint8 level, uint8 quality,
+                        uint32 playerClass, DMRng& rng)
+{
+    uint8  maxArmor   = GetMaxArmorSubclass(playerClass);
+    uint32 classMask  = GetClassBitmask(playerClass);
+
+    // Progressively wider level windows, never above player level
+    static constexpr uint8 windows[] = { 3, 8, 15, 25, 80 };
+
+    ItemPick pick;
+    std::vector<const RewardItem*> cands;
+    for (uint8 below : windows)
+    {
+        cands.clear();
+        uint8 lo = (level > below) ? (level - below) : 1;
+        uint8 hi = level;
+
+        for (const auto& ri : pool)
+        {
+            if (ri.Quality != quality) continue;
+            if (ri.MinLevel < lo || ri.MinLevel > hi) continue;
+
+            // Class restriction: AllowableClass bitmask check
+            if (ri.AllowableClass != -1 && !(ri.AllowableClass & classMask))
+                continue;
+
+            // Armor subclass: player can only wear their class's max armor or lower
+            if (ri.Class == 4 && ri.SubClass > 0 && ri.SubClass <= 4 && ri.SubClass > maxArmor)
+                continue;
+
+            cands.push_back(&ri);
+        }
+
+        if (!cands.empty())
+        {
+            pick.Candidates = static_cast<uint32>(cands.size());
+            pick.Lo         = lo;
+            pick.Hi         = hi;
+            pick.Entry      = PickWeightedForClass(cands, playerClass, true, rng);
+            return pick;
+        }
+    }
+
+    return pick;
+}
+
+ItemPick PickLootItem(const std::vector<LootPoolItem>& pool, uint8 level, uint8 minQuality,
+                      uint8 maxQuality, bool equipmentOnly, uint32 playerClass, DMRng& rng)
+{
+    // Expected ItemLevel range for this level
+    uint16 expectedMaxIlvl = static_cast<uint16>(level) * 2 + 10;
+
+    uint8  maxArmor  = playerClass ? GetMaxArmorSubclass(playerClass) : 4;
+    uint32 classMask = playerClass ? GetClassBitmask(playerClass) : 0x7FF;
+
+    // Progressively widen level windows, always preferring items closer to player level
+    static constexpr struct { uint8 below; uint8 above; } windows[] = {
+        { 3, 1 },   // strict: RequiredLevel in [level-3, level+1]
+        { 5, 2 },   // medium
+        { 8, 3 },   // wide
+        { 15, 5 },  // very wide
+        { 25, 8 },  // extremely wide (last resort)
+    };
+
+    ItemPick pick;
+    std::vector<const LootPoolItem*> cands;
+    for (const auto& win : windows)
+    {
+        cands.clear();
+        uint8 lo = (level > win.below) ? (level - win.below) : 0;
+        uint8 hi = static_cast<uint8>(std::min<uint16>(level + win.above, 83));
+
+        for (const auto& li : pool)
+        {
+            if (li.Quality < minQuality || li.Quality > maxQuality) continue;
+            bool isGear = li.ItemClass == 2 || li.ItemClass == 4;
+            if (equipmentOnly && !isGear) continue;
+
+            // Level filter for items with RequiredLevel > 0, ItemLevel sanity check otherwise
+            if (li.MinLevel > 0)
+            {
+                if (li.MinLevel < lo || li.MinLevel > hi) continue;
+            }
+            else if (li.ItemLevel > expectedMaxIlvl)
+                continue;
+
+            if (isGear)
+            {
+                if (li.AllowableClass != -1 && !(li.AllowableClass & classMask))
+                    continue;
+
+                // Armor subclass check (only for armor, not weapons)
+                if (li.ItemClass == 4 && li.SubClass > 0 && li.SubClass <= 4 && li.SubClass > maxArmor)
+                    continue;
+            }
+
+            cands.push_back(&li);
+        }
+
+        if (!cands.empty())
+        {
+            pick.Candidates = static_cast<uint32>(cands.size());
+            pick.Lo         = lo;
+            pick.Hi         = hi;
+            pick.Entry      = PickWeightedForClass(cands, playerClass, equipmentOnly, rng);
+            return pick;
+        }
+    }
+
+    return pick;
+}
+
+// ---- Spawn packs ----
+
+uint32 ClusterPacks(const std::vector<PackPoint>& points, float radius, uint32 maxSize,
+                    std::vector<uint32>& outPack)
+{
+    constexpr uint32 UNASSIGNED = UINT32_MAX;
+    outPack.assign(points.size(), UNASSIGNED);
+    if (points.empty())
+        return 0;
+
+    // No clustering: one pack per point
+    if (radius <= 0.0f || maxSize <= 1)
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+            outPack[i] = static_cast<uint32>(i);
+        return static_cast<uint32>(points.size());
+    }
+
+    auto cellOf = [radius](float v) { return static_cast<int32>(std::floor(v / radius)); };
+    auto pack   = [](int32 cx, int32 cy) { return (uint64(uint32(cx)) << 32) | uint32(cy); };
+
+    std::unordered_map<uint64, std::vector<uint32>> cells;
+    cells.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        cells[pack(cellOf(points[i].X), cellOf(points[i].Y))].push_back(static_cast<uint32>(i));
+
+    float radiusSq = radius * radius;
+    uint32 packs = 0;
+    std::vector<uint32> frontier;
+    for (size_t seed = 0; seed < points.size(); ++seed)
+    {
+        if (outPack[seed] != UNASSIGNED)
+            continue;
+
+        uint32 id   = packs++;
+        uint32 size = 1;
+        outPack[seed] = id;
+        frontier.assign(1, static_cast<uint32>(seed));
+
+        // Breadth-first expansion through the 3x3 cells around each member
+        for (size_t f = 0; f < frontier.size() && size < maxSize; ++f)
+        {
+            const PackPoint& p = points[frontier[f]];
+            int32 cx = cellOf(p.X), cy = cellOf(p.Y);
+            for (int32 dx = -1; dx <= 1 && size < maxSize; ++dx)
+                for (int32 dy = -1; dy <= 1 && size < maxSize; ++dy)
+                {
+                    auto cell = cells.find(pack(cx + dx, cy + dy));
+                    if (cell == cells.end()) continue;
+                    for (uint32 j : cell->second)
+                    {
+                        if (outPack[j] != UNASSIGNED) continue;
+                        float ddx = points[j].X - p.X, ddy = points[j].Y - p.Y, ddz = points[j].Z - p.Z;
+                        if (ddx * ddx + ddy * ddy + ddz * ddz > radiusSq) continue;
+                        outPack[j] = id;
+                        frontier.push_back(j);
+                        if (++size >= maxSize) break;
+                    }
+                }
+        }
+    }
+    return packs;
+}
+
+// ---- Population budget ----
+
+float LoadDensityScale(uint32 worldDiffMs, uint32 targetDiffMs, float minDensity)
+{
+    if (!targetDiffMs || worldDiffMs <= targetDiffMs)
+        return 1.0f;
+    return std::max(minDensity, static_cast<float>(targetDiffMs) / static_cast<float>(worldDiffMs));
+}
+
+PopulationPlan PlanPopulation(uint32 trashPoints, float mobCountMult, float loadScale,
+                              uint32 budgetLeft, float minDensity)
+{
+    PopulationPlan plan;
+    if (!trashPoints)
+        return plan;
+
+    minDensity = std::clamp(minDensity, 0.05f, 1.0f);
+
+    // One creature per point at most; the multiplier only thins
+    float wanted = std::round(trashPoints * std::max(0.0f, mobCountMult));
+    plan.Wanted  = std::clamp<uint32>(static_cast<uint32>(wanted), 1, trashPoints);
+
+    uint32 scaled = static_cast<uint32>(std::round(plan.Wanted * std::clamp(loadScale, 0.0f, 1.0f)));
+    uint32 minimum = std::max<uint32>(1, static_cast<uint32>(std::ceil(plan.Wanted * minDensity)));
+    plan.Placed    = std::clamp(std::min(scaled, budgetLeft), minimum, plan.Wanted);
+
+    plan.Toughness = std::min(static_cast<float>(plan.Wanted) / plan.Placed, 1.0f / minDensity);
+    return plan;
+}
+
+bool KeepSpreadPoint(uint32 k, uint32 total, uint32 keep)
+{
+    if (keep >= total)
+        return true;
+    return (uint64(k + 1) * keep) / total > (uint64(k) * keep) / total;
+}
+
+// ---- Scaling curves ----
+
+float PartyScaling(uint32 partySize, float soloMult, float perPlayerMult)
+{
+    if (partySize <= 1) return soloMult;
+    return 1.0f + (partySize - 1) * perPlayerMult;
+}
+
+float TierScaling(uint32 tier, float baseScale, uint32 expThreshold, float expFactor)
+{
+    if (tier <= 1) return 1.0f;
+    if (tier <= expThreshold)
+        return 1.0f + (tier - 1) * baseScale;
+
+    // Exponential scaling past threshold
+    float linearPart = (expThreshold - 1) * baseScale;
+    float expPart    = 0.0f;
+    float step       = baseScale;
+    for (uint32 t = expThreshold; t < tier; ++t)
+    {
+        step    *= expFactor;
+        expPart += step;
+    }
+
+    return 1.0f + linearPart + expPart;
+}
+
+float LinearTierScaling(uint32 tier, float baseScale)
+{
+    if (tier <= 1) return 1.0f;
+    return 1.0f + (tier - 1) * baseScale;
+}
+
+uint32 ScaleCreatureHealth(const ClassLevelStatEntry* base, uint32 templateMaxHealth, float hpMult)
+{
+    float finalHP = static_cast<float>(base ? base->BaseHP : templateMaxHealth) * hpMult;
+    return std::max(1u, static_cast<uint32>(finalHP));
+}
+
+void ScaleCreatureDamage(const ClassLevelStatEntry& base, uint32 baseAttackTimeMs, float dmgMult,
+                         float& outMin, float& outMax)
+{
+    float apBonus = static_cast<float>(base.AttackPower) / 14.0f;
+    float atkTime = static_cast<float>(baseAttackTimeMs) / 1000.0f;
+    if (atkTime <= 0.0f) atkTime = 2.0f;
+
+    outMin = std::max(1.0f, (base.BaseDamage + apBonus) * atkTime * dmgMult);
+    outMax = std::max(outMin, ((base.BaseDamage * 1.15f) + apBonus) * atkTime * dmgMult);
+}
+
+} // namespace DungeonMaster
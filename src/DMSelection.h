@@ -0,0 +1,164 @@
+/*
+ * mod-dungeon-master — DMSelection.h
+ * Pure creature / item selection, spawn clustering and scaling math. Depends only on Define.h
+ * and DMRandom.h so it can be driven outside a worldserver with synthetic pools.
+ */
+
+#ifndef DM_SELECTION_H
+#define DM_SELECTION_H
+
+#include "Define.h"
+#include "DMRandom.h"
+#include <unordered_map>
+#include <vector>
+
+namespace DungeonMaster
+{
+
+// ---- Pool data ----
+
+struct CreaturePoolEntry
+{
+    uint32 Entry    = 0;
+    uint32 Type     = 0;
+    uint8  MinLevel = 1;
+    uint8  MaxLevel = 80;
+};
+
+using CreaturePool = std::unordered_map<uint32, std::vector<CreaturePoolEntry>>;  // creature type -> entries
+
+struct ClassLevelStatEntry
+{
+    uint32 BaseHP         = 1;
+    float  BaseDamage     = 1.0f;
+    uint32 BaseArmor      = 0;
+    uint32 AttackPower    = 0;
+};
+
+// Positive stat totals captured from the ItemTemplate when the pool is loaded
+struct ItemStatProfile
+{
+    float Total     = 0.0f;
+    float Agility   = 0.0f;
+    float Strength  = 0.0f;
+    float Intellect = 0.0f;
+};
+
+struct RewardItem
+{
+    uint32 Entry         = 0;
+    uint32 MinLevel      = 1;
+    uint32 MaxLevel      = 80;
+    uint16 ItemLevel     = 0;
+    uint8  Quality       = 0;       // 0=Poor .. 4=Epic
+    uint32 InventoryType = 0;
+    uint32 Class         = 0;       // 2=Weapon, 4=Armor
+    uint32 SubClass      = 0;
+    int32  AllowableClass = -1;
+    ItemStatProfile Stats;
+};
+
+struct LootPoolItem
+{
+    uint32 Entry          = 0;
+    uint8  MinLevel       = 0;
+    uint16 ItemLevel      = 0;
+    uint8  Quality        = 0;
+    uint8  ItemClass      = 0;
+    uint8  SubClass       = 0;
+    int32  AllowableClass = -1;
+    ItemStatProfile Stats;
+};
+
+// Result of a windowed item pick; Lo/Hi describe the window that produced it
+struct ItemPick
+{
+    uint32 Entry      = 0;
+    uint32 Candidates = 0;
+    uint8  Lo         = 0;
+    uint8  Hi         = 0;
+};
+
+// ---- Class helpers ----
+
+uint8  GetMaxArmorSubclass(uint32 playerClass);
+uint32 GetClassBitmask(uint32 playerClass);
+uint32 GetPrimaryStatForClass(uint32 playerClass);      // ITEM_MOD_AGILITY(3) / STRENGTH(4) / INTELLECT(5)
+
+// Folds one ItemTemplate stat slot into a profile (call once per slot at load)
+void   AddItemStat(ItemStatProfile& profile, uint32 statType, int32 statValue);
+
+// Share of an item's stats on the class's primary stat (0.0 = bad, 1.0 = perfect, 0.5 = no stats)
+float  ScoreItemForClass(const ItemStatProfile& profile, uint32 playerClass);
+
+// ---- Selection ----
+
+// Uniform pick over every entry whose type is listed in `types`; nullptr or a
+// uint32(-1) entry matches any type. Walks the pool twice instead of building a
+// candidate list. Returns 0 when nothing matches; outCandidates gets the match count.
+uint32 PickPoolEntry(const CreaturePool& pool, const std::vector<uint32>* types,
+                     DMRng& rng, uint32* outCandidates = nullptr);
+
+bool   MatchesAnyType(const std::vector<uint32>& types);
+
+ItemPick PickRewardItem(const std::vector<RewardItem>& pool, uint8 level, uint8 quality,
+                        uint32 playerClass, DMRng& rng);
+ItemPick PickLootItem(const std::vector<LootPoolItem>& pool, uint8 level, uint8 minQuality,
+                      uint8 maxQuality, bool equipmentOnly, uint32 playerClass, DMRng& rng);
+
+// ---- Spawn packs ----
+
+struct PackPoint
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+};
+
+// Grid-bucketed DBSCAN with a minimum cluster size of one: points within
+// `radius` (3D) of a pack member join its pack until it holds maxSize points.
+// Every point ends up in exactly one pack; packs are numbered in the order of
+// their first (seed) point, so callers that pass points near-to-far get the
+// nearest member as pack[0]. Returns the pack count.
+uint32 ClusterPacks(const std::vector<PackPoint>& points, float radius, uint32 maxSize,
+                    std::vector<uint32>& outPack);
+
+// ---- Population budget ----
+
+struct PopulationPlan
+{
+    uint32 Wanted    = 0;       // trash the difficulty asks for (MobCountMultiplier)
+    uint32 Placed    = 0;       // after the load and server budget cuts
+    float  Toughness = 1.0f;    // extra trash HP so a cut run keeps roughly its total HP
+};
+
+// 1.0 while the smoothed world diff is at or under target, then target / diff,
+// never below minDensity. targetDiffMs 0 disables the load cut.
+float LoadDensityScale(uint32 worldDiffMs, uint32 targetDiffMs, float minDensity);
+
+// budgetLeft is the server-wide live-creature headroom (UINT32_MAX = no cap).
+// Placed never drops below wanted * minDensity, so the server budget is soft
+// there; Toughness is capped at 1 / minDensity.
+PopulationPlan PlanPopulation(uint32 trashPoints, float mobCountMult, float loadScale,
+                              uint32 budgetLeft, float minDensity);
+
+// Spreads `keep` picks evenly over `total` near-to-far points; true for the k-th point kept
+bool   KeepSpreadPoint(uint32 k, uint32 total, uint32 keep);
+
+// ---- Scaling curves ----
+
+// Party-size scaling applied on top of a difficulty multiplier
+float PartyScaling(uint32 partySize, float soloMult, float perPlayerMult);
+
+// Roguelike tier curve: linear up to expThreshold, compounding past it
+float TierScaling(uint32 tier, float baseScale, uint32 expThreshold, float expFactor);
+float LinearTierScaling(uint32 tier, float baseScale);
+
+// Creature stats at the target level (the math behind PopulateDungeon's applyLevelAndStats)
+uint32 ScaleCreatureHealth(const ClassLevelStatEntry* base, uint32 templateMaxHealth, float hpMult);
+void   ScaleCreatureDamage(const ClassLevelStatEntry& base, uint32 baseAttackTimeMs, float dmgMult,
+                           float& outMin, float& outMax);
+
+} // namespace DungeonMaster
+
+#endif // DM_SELECTION_H
@@ -0,0 +1,58 @@
+/*
+ * mod-dungeon-master — DMTypes.cpp
+ * Session bookkeeping helpers. Kept apart from DungeonMasterMgr so the offline
+ * load simulator (bench/) links the same code.
+ */
+
+#include "DMTypes.h"
+
+namespace DungeonMaster
+{
+
+// Moves one member between the presence counters; the dead and offline are
+// never counted as in combat
+void Session::UpdatePresence(PlayerSessionData& pd, bool online, bool alive, bool inCombat)
+{
+    alive    = online && alive;
+    inCombat = alive && inCombat;
+
+    OnlinePlayers   += uint32(online)   - uint32(pd.Online);
+    AlivePlayers    += uint32(alive)    - uint32(pd.Alive);
+    InCombatPlayers += uint32(inCombat) - uint32(pd.InCombat);
+
+    pd.Online   = online;
+    pd.Alive    = alive;
+    pd.InCombat = inCombat;
+}
+
+void Session::CreditMobKill()
+{
+    ++MobsKilled;
+    ++PendingMobKills;
+    for (auto& pd : Players)
+        ++pd.MobsKilled;
+    PartyMobKills += static_cast<uint32>(Players.size());
+}
+
+void Session::CreditBossKill()
+{
+    ++BossesKilled;
+    for (auto& pd : Players)
+        ++pd.BossesKilled;
+    PartyBossKills += static_cast<uint32>(Players.size());
+}
+
+// Credits one member who was eligible when the kill happened
+void Session::QueueKillXP(PlayerSessionData& pd, uint32 xp)
+{
+    pd.PendingKillXP += xp;
+    PendingKillXP    += xp;
+}
+
+void Session::CreditDeath(PlayerSessionData& pd)
+{
+    ++pd.Deaths;
+    ++PartyDeaths;
+}
+
+} // namespace DungeonMaster
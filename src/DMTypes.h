@@ -7,8 +7,14 @@
 #define DM_TYPES_H
 
 #include "Define.h"
+#include "DMMemory.h"
+#include "DMRandom.h"
+#include "DMSelection.h"
 #include "ObjectGuid.h"
 #include "Position.h"
+#include <bit>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -73,24 +79,129 @@ struct DungeonInfo
     bool        IsAvailable = true;
 };
 
+// Immutable once built; every session on a map shares the same list. Which
+// points a session uses and how they pack is decided locally at populate.
 struct SpawnPoint
 {
     Position    Pos;
     float       DistanceFromEntrance = 0.0f;
     bool        IsBossPosition       = false;
-    bool        IsUsed               = false;
 };
 
-struct SpawnedCreature
+using SpawnPointList = std::shared_ptr<const std::vector<SpawnPoint>>;   // sorted near -> far
+
+// Trash spawned from one cluster of points. Only the leader sits in the aggro
+// grid; pulling any member pulls the rest. Shared by the members' AIs and only
+// touched from the instance's map thread.
+struct SpawnPack
+{
+    ObjectGuid              Leader;
+    std::vector<ObjectGuid> Members;            // includes the leader
+    bool                    LeaderDown = false; // members scout for themselves after this
+};
+
+enum SpawnFlag : uint8
+{
+    SPAWN_ELITE         = 0x01,
+    SPAWN_BOSS          = 0x02,
+    SPAWN_RARE          = 0x04,
+    SPAWN_DEAD          = 0x08,
+    SPAWN_LOOT_FILLED   = 0x10,     // FillCreatureLoot has run post-death
+    SPAWN_KILL_CREDITED = 0x20,     // kill XP/count has been awarded
+
+    SPAWN_PROCESSED     = SPAWN_DEAD | SPAWN_LOOT_FILLED | SPAWN_KILL_CREDITED
+};
+
+// A session's creatures as parallel columns. GUID lookups walk only the GUID
+// array and the death poll only the flag bytes, so 300 creatures' state is
+// five cache lines. Indices are stable: creatures are only ever appended.
+class SpawnRoster
 {
-    ObjectGuid  Guid;
+public:
+    static constexpr uint32 NOT_FOUND = uint32(-1);
+
+    uint32 Add(ObjectGuid guid, uint32 entry, uint8 flags, uint16 packId = 0)
+    {
+        _guids.push_back(guid);
+        _entries.push_back(entry);
+        _packIds.push_back(packId);     // spawn points per map stay well under 64k
+        _flags.push_back(flags);
+        return static_cast<uint32>(_guids.size() - 1);
+    }
+
+    size_t size()  const { return _guids.size(); }
+    bool   empty() const { return _guids.empty(); }
+
+    ObjectGuid GetGuid(uint32 i)   const { return _guids[i]; }
+    uint32     GetEntry(uint32 i)  const { return _entries[i]; }
+    uint16     GetPackId(uint32 i) const { return _packIds[i]; }
+    bool       Has(uint32 i, uint8 flag) const { return (_flags[i] & flag) != 0; }
+
+    // Sets `flag`; true if it was clear, for steps that must run once
+    bool Claim(uint32 i, uint8 flag)
+    {
+        if (_flags[i] & flag)
+            return false;
+        _flags[i] |= flag;
+        return true;
+    }
+
+    const std::vector<ObjectGuid>& GetGuids() const { return _guids; }
+
+    uint32 Find(ObjectGuid guid) const
+    {
+        for (size_t i = 0; i < _guids.size(); ++i)
+            if (_guids[i] == guid)
+                return static_cast<uint32>(i);
+        return NOT_FOUND;
+    }
+
+    // First index at or after `from` still missing a SPAWN_PROCESSED bit, or
+    // size(). Tests eight flag bytes per step.
+    uint32 NextUnprocessed(uint32 from) const
+    {
+        uint32 n = static_cast<uint32>(_flags.size());
+        uint32 i = from;
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            constexpr uint64 lanes = 0x0101010101010101ULL * SPAWN_PROCESSED;
+            for (; i + 8 <= n; i += 8)
+            {
+                uint64 word;
+                std::memcpy(&word, _flags.data() + i, sizeof(word));
+                if (uint64 pending = (word & lanes) ^ lanes)     // non-zero byte = step missing
+                    return i + static_cast<uint32>(std::countr_zero(pending) / 8);
+            }
+        }
+        for (; i < n; ++i)
+            if ((_flags[i] & SPAWN_PROCESSED) != SPAWN_PROCESSED)
+                return i;
+        return n;
+    }
+
+    uint64 GetHeapBytes() const
+    {
+        return HeapBytes(_guids) + HeapBytes(_entries) + HeapBytes(_packIds) + HeapBytes(_flags);
+    }
+
+private:
+    std::vector<ObjectGuid> _guids;
+    std::vector<uint32>     _entries;
+    std::vector<uint16>     _packIds;
+    std::vector<uint8>      _flags;     // SpawnFlag bits
+};
+
+// One trash mob rolled at populate time but summoned only once the party's
+// frontier reaches its pack (Dungeon.StreamAhead)
+struct PlannedSpawn
+{
+    uint32      PointIndex = 0;       // into Session::SpawnPoints
     uint32      Entry      = 0;
+    uint32      PackId     = 0;
+    float       Distance   = 0.0f;    // pack leader's distance from the entrance
+    float       HpMult     = 1.0f;    // elite, affix and toughness, before level scaling
+    float       DmgMult    = 1.0f;
     bool        IsElite    = false;
-    bool        IsBoss     = false;
-    bool        IsRare     = false;
-    bool        IsDead     = false;
-    bool        LootFilled = false;   // true once FillCreatureLoot has run post-death
-    bool        KillCredited = false; // true once kill XP/count has been awarded
 };
 
 struct PendingPhaseCheck
@@ -109,6 +220,12 @@ struct PlayerSessionData
     uint32      MobsKilled   = 0;
     uint32      BossesKilled = 0;
     uint32      Deaths       = 0;
+    uint32      PendingKillXP = 0;  // kill XP earned since the last flush
+
+    // Last state reported by the player hooks (Session::UpdatePresence)
+    bool        Online       = false;
+    bool        Alive        = false;
+    bool        InCombat     = false;
 };
 
 struct Session
@@ -133,23 +250,50 @@ struct Session
     uint32  TimeLimit = 0;
 
     std::vector<PlayerSessionData>  Players;
-    std::vector<SpawnedCreature>    SpawnedCreatures;
-    std::vector<SpawnPoint>         SpawnPoints;
+    SpawnRoster                     SpawnedCreatures;
+    SpawnPointList                  SpawnPoints;    // shared per map, see GetSpawnPointsForMap
     std::vector<PendingPhaseCheck>  PendingPhaseChecks;
 
+    // Trash plan in pack-leader distance order; [0, NextPlanned) has been summoned
+    std::vector<PlannedSpawn>       SpawnPlan;
+    uint32  NextPlanned    = 0;
+    float   StreamFrontier = 0.0f;    // yd from the entrance spawned so far
+
+    // Difficulty multipliers fixed at populate, reused for streamed spawns
+    float   HealthMult     = 1.0f;
+    float   DamageMult     = 1.0f;
+    float   BossDamageMult = 1.0f;
+
     uint32  TotalMobs   = 0;
+    uint32  TotalPacks  = 0;
+    uint32  BudgetCharge = 0;     // creatures counted against Dungeon.LiveCreatureBudget
     uint32  MobsKilled  = 0;
     uint32  TotalBosses = 0;
     uint32  BossesKilled = 0;
     uint32  Wipes       = 0;
 
+    // Kept current by UpdatePresence and the Credit* helpers, so ticks and
+    // death checks read them without resolving players
+    uint32  OnlinePlayers   = 0;
+    uint32  AlivePlayers    = 0;    // online and alive
+    uint32  InCombatPlayers = 0;    // online, alive and in combat
+    uint32  PartyMobKills   = 0;    // sums of the per-player counters
+    uint32  PartyBossKills  = 0;
+    uint32  PartyDeaths     = 0;
+
+    // Kill credit gathered between ticks, paid out once per player by FlushKillCredit
+    uint32  PendingKillXP   = 0;    // sum of the members' pending XP
+    uint32  PendingMobKills = 0;    // trash kills not yet announced
+
     Position EntrancePos;
 
+    // Population stream; the same seed, dungeon and party level give the same layout
+    uint64  Seed = 0;
+    DMRng   Rng;
+
     bool IsSessionCreature(ObjectGuid guid) const
     {
-        for (const auto& sc : SpawnedCreatures)
-            if (sc.Guid == guid) return true;
-        return false;
+        return SpawnedCreatures.Find(guid) != SpawnRoster::NOT_FOUND;
     }
 
     bool IsActive() const
@@ -175,49 +319,16 @@ struct Session
         return nullptr;
     }
 
-    uint32 GetAlivePlayerCount() const;
-    bool   IsPartyWiped() const;
-    bool   IsGroupInCombat() const;
-};
-
-struct CreaturePoolEntry
-{
-    uint32 Entry    = 0;
-    uint32 Type     = 0;
-    uint8  MinLevel = 1;
-    uint8  MaxLevel = 80;
-};
-
-struct ClassLevelStatEntry
-{
-    uint32 BaseHP         = 1;
-    float  BaseDamage     = 1.0f;
-    uint32 BaseArmor      = 0;
-    uint32 AttackPower    = 0;
-};
-
-struct RewardItem
-{
-    uint32 Entry         = 0;
-    uint32 MinLevel      = 1;
-    uint32 MaxLevel      = 80;
-    uint16 ItemLevel     = 0;
-    uint8  Quality       = 0;       // 0=Poor .. 4=Epic
-    uint32 InventoryType = 0;
-    uint32 Class         = 0;       // 2=Weapon, 4=Armor
-    uint32 SubClass      = 0;
-    int32  AllowableClass = -1;
-};
+    uint32 GetAlivePlayerCount() const { return AlivePlayers; }
+    bool   IsPartyWiped()        const { return AlivePlayers == 0; }
+    bool   IsGroupInCombat()     const { return InCombatPlayers != 0; }
+    bool   HasDeadPlayers()      const { return AlivePlayers < OnlinePlayers; }
 
-struct LootPoolItem
-{
-    uint32 Entry          = 0;
-    uint8  MinLevel       = 0;
-    uint16 ItemLevel      = 0;
-    uint8  Quality        = 0;
-    uint8  ItemClass      = 0;
-    uint8  SubClass       = 0;
-    int32  AllowableClass = -1;
+    void   UpdatePresence(PlayerSessionData& pd, bool online, bool alive, bool inCombat);
+    void   CreditMobKill();
+    void   QueueKillXP(PlayerSessionData& pd, uint32 xp);
+    void   CreditBossKill();
+    void   CreditDeath(PlayerSessionData& pd);
 };
 
 struct PlayerStats
@@ -248,6 +359,16 @@ struct LeaderboardEntry
     uint32      Deaths        = 0;
 };
 
+// A player's best clear on one (map, difficulty) board and where it ranks
+struct PersonalBest
+{
+    uint32 MapId        = 0;
+    uint32 DifficultyId = 0;
+    uint32 ClearTime    = 0;
+    uint32 Rank         = 0;   // 1-based; ties share a rank
+    uint32 BoardSize    = 0;
+};
+
 } // namespace DungeonMaster
 
 #endif // DM_TYPES_H
@@ -6,6 +6,13 @@
 #include "DungeonMasterMgr.h"
 #include "RoguelikeMgr.h"
 #include "DMConfig.h"
+#include "DMPerf.h"
+#include "DMSelection.h"
+#include "DMRandom.h"
+#include "DMAggro.h"
+#include "DMBossKits.h"
+#include "DMMemory.h"
+#include "DMChat.h"
 #include "Player.h"
 #include "Group.h"
 #include "Creature.h"
@@ -30,8 +37,9 @@
 #include "CellImpl.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
-#include <random>
 #include <algorithm>
+#include <limits>
+#include <memory>
 #include <set>
 #include <cstdio>
 #include <cmath>
@@ -39,20 +47,29 @@
 namespace DungeonMaster
 {
 
-// RNG helpers (thread-local for safety)
-static thread_local std::mt19937 tRng{ std::random_device{}() };
-
+// RNG helpers for rolls outside a session's population stream
 template<typename T>
-static T RandInt(T lo, T hi) { return std::uniform_int_distribution<T>(lo, hi)(tRng); }
-
-static float RandFloat(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(tRng); }
+static T RandInt(T lo, T hi) { return ThreadRng().Range<T>(lo, hi); }
 
-// Aggressive AI for DM-spawned creatures; patrols 5 yd radius, active aggro, hooks JustDied for loot
+// Aggressive AI for DM-spawned creatures; patrols 5 yd radius, active aggro, hooks JustDied for loot.
+// While idle the creature sits in the instance's aggro grid (DMAggro.h); pack
+// members leave the aggro checks to their leader and are pulled with it.
 class DungeonMasterCreatureAI : public CreatureAI
 {
 public:
     explicit DungeonMasterCreatureAI(Creature* creature)
-        : CreatureAI(creature), _patrolStarted(false), _aggroScanTimer(0) {}
+        : CreatureAI(creature), _patrolStarted(false)
+    {
+        sDMAggro->Track(me);
+    }
+
+    // Called once at populate, after every member of the pack has spawned
+    void SetPack(std::shared_ptr<SpawnPack> pack)
+    {
+        _pack = std::move(pack);
+        if (!IsScout())
+            sDMAggro->Untrack(me);
+    }
 
     // Active aggro detection — overrides the default which has many silent skips
     void MoveInLineOfSight(Unit* who) override
@@ -60,7 +77,7 @@ public:
         if (!who || !me->IsAlive() || me->IsInCombat() || me->HasReactState(REACT_PASSIVE))
             return;
 
-        if (who->GetTypeId() != TYPEID_PLAYER)
+        if (who->GetTypeId() != TYPEID_PLAYER || !IsScout())
             return;
 
         Player* player = who->ToPlayer();
@@ -70,7 +87,7 @@ public:
         float aggroRange = sDMConfig->GetAggroRadius();
         if (me->IsWithinDistInMap(player, aggroRange)
             && me->IsHostileTo(player)
-            && me->IsWithinLOSInMap(player))
+            && sDMAggro->IsWithinLOS(me, player))
         {
             me->SetInCombatWith(player);
             player->SetInCombatWith(me);
@@ -79,7 +96,7 @@ public:
         }
     }
 
-    void UpdateAI(uint32 diff) override
+    void UpdateAI(uint32 /*diff*/) override
     {
         if (!UpdateVictim())
         {
@@ -90,55 +107,34 @@ public:
                 _patrolStarted = true;
             }
 
-            // Fallback aggro scan every 1 second for cases where MoveInLineOfSight
-            // doesn't fire (inactive grids, summoned creature edge cases)
-            _aggroScanTimer += diff;
-            if (_aggroScanTimer >= 1000 && me->IsAlive())
-            {
-                _aggroScanTimer = 0;
-                float aggroRange = sDMConfig->GetAggroRadius();
-
-                Map::PlayerList const& players = me->GetMap()->GetPlayers();
-                float closest = aggroRange;
-                Player* target = nullptr;
-
-                for (auto const& itr : players)
-                {
-                    Player* p = itr.GetSource();
-                    if (!p || !p->IsAlive() || p->IsGameMaster())
-                        continue;
-
-                    float dist = me->GetDistance(p);
-                    if (dist < closest
-                        && me->IsHostileTo(p)
-                        && me->IsWithinLOSInMap(p))
-                    {
-                        closest = dist;
-                        target = p;
-                    }
-                }
-
-                if (target)
-                {
-                    me->SetInCombatWith(target);
-                    target->SetInCombatWith(me);
-                    me->AddThreat(target, 1.0f);
-                    AttackStart(target);
-                }
-            }
+            // Fallback aggro for cases where MoveInLineOfSight doesn't fire
+            // (inactive grids, summoned creature edge cases) is driven by the
+            // instance's aggro scheduler from the map update
             return;
         }
         DoMeleeAttackIfReady();
     }
 
+    void JustEngagedWith(Unit* who) override
+    {
+        sDMAggro->Untrack(me);
+        PullPack(who);
+    }
+
     void EnterEvadeMode(EvadeReason /*why*/) override
     {
         _patrolStarted = false;
         CreatureAI::EnterEvadeMode();
+        if (IsScout())
+            sDMAggro->Track(me);
     }
 
     void JustDied(Unit* killer) override
     {
+        sDMAggro->Untrack(me);
+        sDMAggro->Retire(me);
+        if (_pack && _pack->Leader == me->GetGUID())
+            _pack->LeaderDown = true;
         CreatureAI::JustDied(killer);
         // NOTE: Do NOT call FillCreatureLoot here.  JustDied fires inside
         // setDeathState / Unit::Kill, and the core will clear creature->loot
@@ -149,8 +145,39 @@ public:
     }
 
 private:
+    // Solo mobs, pack leaders, and everyone once the leader is dead run their own aggro
+    bool IsScout() const
+    {
+        return !_pack || _pack->LeaderDown || _pack->Leader == me->GetGUID();
+    }
+
+    // Each member's JustEngagedWith lands here again, but finds the others
+    // already in combat, so the link stops after one pass
+    void PullPack(Unit* who)
+    {
+        if (!_pack)
+            return;
+        if (!who)
+            who = me->GetVictim();
+        if (!who)
+            return;
+
+        for (ObjectGuid guid : _pack->Members)
+        {
+            if (guid == me->GetGUID())
+                continue;
+            Creature* member = ObjectAccessor::GetCreature(*me, guid);
+            if (!member || !member->IsAlive() || member->IsInCombat() || !member->AI())
+                continue;
+            member->SetInCombatWith(who);
+            who->SetInCombatWith(member);
+            member->AddThreat(who, 1.0f);
+            member->AI()->AttackStart(who);
+        }
+    }
+
     bool   _patrolStarted;
-    uint32 _aggroScanTimer;
+    std::shared_ptr<SpawnPack> _pack;
 };
 
 // ---------------------------------------------------------------------------
@@ -168,74 +195,12 @@ class DungeonMasterBossAI : public CreatureAI
 {
 public:
     explicit DungeonMasterBossAI(Creature* creature)
-        : CreatureAI(creature), _enraged(false)
+        : CreatureAI(creature),
+          _kit(&sDMBossKits->GetKit(creature->GetCreatureTemplate()->type)),
+          _enraged(false)
     {
-        // Pick a themed spell kit based on the creature type
-        uint32 cType = me->GetCreatureTemplate()->type;
-        switch (cType)
-        {
-            case CREATURE_TYPE_DRAGONKIN:
-                // Flame Breath (frontal cone) + Tail Sweep + Wing Buffet
-                _spells = {
-                    { 9573,  8000, 12000, false },   // Flame Breath  (cone)
-                    { 15847, 15000, 20000, false },   // Tail Sweep    (PBAoE)
-                    { 18500, 20000, 28000, false },   // Wing Buffet   (knockback)
-                };
-                break;
-            case CREATURE_TYPE_DEMON:
-                // Shadow Bolt Volley + Rain of Fire (small) + Fear
-                _spells = {
-                    { 17228, 6000,  10000, false },   // Shadow Bolt Volley
-                    { 19717, 18000, 25000, false },   // Rain of Fire
-                    { 12542, 22000, 30000, false },   // Fear (single target)
-                };
-                break;
-            case CREATURE_TYPE_UNDEAD:
-                // Shadow Bolt + Curse of Agony + Shadow Nova
-                _spells = {
-                    { 15232, 5000,  8000,  false },   // Shadow Bolt
-                    { 14868, 14000, 20000, false },   // Curse of Agony
-                    { 15398, 18000, 25000, true  },   // Shadow Nova (PBAoE)
-                };
-                break;
-            case CREATURE_TYPE_ELEMENTAL:
-                // Chain Lightning + Frost Nova + Shock
-                _spells = {
-                    { 12058, 6000,  10000, false },   // Chain Lightning
-                    { 15531, 16000, 22000, true  },   // Frost Nova (PBAoE)
-                    { 13281, 10000, 14000, false },   // Earth Shock
-                };
-                break;
-            case CREATURE_TYPE_BEAST:
-                // Frenzy + Charge + Rend
-                _spells = {
-                    { 8269,  15000, 22000, true  },   // Frenzy (self)
-                    { 22120, 12000, 18000, false },   // Charge
-                    { 16509, 8000,  12000, false },   // Rend (bleed)
-                };
-                break;
-            case CREATURE_TYPE_GIANT:
-                // Thunderclap + Knock Away + War Stomp
-                _spells = {
-                    { 8078,  8000,  12000, true  },   // Thunderclap (PBAoE slow)
-                    { 15580, 14000, 20000, false },   // Knock Away
-                    { 16727, 20000, 28000, true  },   // War Stomp (AoE stun)
-                };
-                break;
-            case CREATURE_TYPE_HUMANOID:
-            default:
-                // Cleave + Mortal Strike + Intimidating Shout
-                _spells = {
-                    { 15284, 6000,  10000, false },   // Cleave
-                    { 16856, 12000, 18000, false },   // Mortal Strike
-                    { 19134, 22000, 30000, true  },   // Frightening Shout (AoE)
-                };
-                break;
-        }
-
-        // Initialise cooldown timers
-        for (auto& s : _spells)
-            s.timer = RandInt<uint32>(s.cdMin / 2, s.cdMin);   // stagger first casts
+        ResetRotation();
+        sDMAggro->Track(me);
     }
 
     // ---- Aggro (same logic as trash AI) ----
@@ -250,7 +215,7 @@ public:
         float aggroRange = sDMConfig->GetAggroRadius();
         if (me->IsWithinDistInMap(player, aggroRange)
             && me->IsHostileTo(player)
-            && me->IsWithinLOSInMap(player))
+            && sDMAggro->IsWithinLOS(me, player))
         {
             me->SetInCombatWith(player);
             player->SetInCombatWith(me);
@@ -261,43 +226,15 @@ public:
 
     void JustEngagedWith(Unit* /*who*/) override
     {
-        // Reset all spell timers on pull
-        for (auto& s : _spells)
-            s.timer = RandInt<uint32>(s.cdMin / 2, s.cdMin);
+        ResetRotation();
         _enraged = false;
+        sDMAggro->Untrack(me);
     }
 
     void UpdateAI(uint32 diff) override
     {
         if (!UpdateVictim())
-        {
-            // Idle aggro scan (same as trash AI)
-            _aggroTimer += diff;
-            if (_aggroTimer >= 1000 && me->IsAlive())
-            {
-                _aggroTimer = 0;
-                float aggroRange = sDMConfig->GetAggroRadius();
-                Map::PlayerList const& players = me->GetMap()->GetPlayers();
-                float closest = aggroRange;
-                Player* target = nullptr;
-                for (auto const& itr : players)
-                {
-                    Player* p = itr.GetSource();
-                    if (!p || !p->IsAlive() || p->IsGameMaster()) continue;
-                    float dist = me->GetDistance(p);
-                    if (dist < closest && me->IsHostileTo(p) && me->IsWithinLOSInMap(p))
-                    { closest = dist; target = p; }
-                }
-                if (target)
-                {
-                    me->SetInCombatWith(target);
-                    target->SetInCombatWith(me);
-                    me->AddThreat(target, 1.0f);
-                    AttackStart(target);
-                }
-            }
-            return;
-        }
+            return;     // idle aggro comes from the instance's aggro scheduler
 
         // Enrage at 30% HP (once per fight)
         if (!_enraged && me->HealthBelowPct(30))
@@ -306,18 +243,26 @@ public:
             me->CastSpell(me, 8599, true);   // Enrage (+40% damage, visual)
         }
 
-        // Spell rotation
-        for (auto& s : _spells)
+        // Spell rotation: only the next-due ability is looked at. Anything due
+        // while casting or on the global cooldown waits its turn in the heap.
+        _clock += diff;
+        uint8 slot;
+        if (_clock >= _gcdEndsAt && !me->HasUnitState(UNIT_STATE_CASTING)
+            && _rotation.PopDue(_clock, slot))
         {
-            if (s.timer <= diff)
+            const BossAbility& a = _kit->Abilities[slot];
+            Unit* castTarget = nullptr;
+            if (a.HealthBelowPct >= 100 || !me->HealthAbovePct(a.HealthBelowPct))
+                castTarget = SelectKitTarget(a.Target);
+
+            if (castTarget)
             {
-                Unit* castTarget = s.pbAoE ? me : me->GetVictim();
-                if (castTarget)
-                    me->CastSpell(castTarget, s.spellId, false);
-                s.timer = RandInt<uint32>(s.cdMin, s.cdMax);
+                me->CastSpell(castTarget, a.SpellId, false);
+                _gcdEndsAt = _clock + sDMConfig->GetBossSpellGCD();
+                _rotation.Schedule(slot, _clock + RandInt<uint32>(a.CooldownMin, a.CooldownMax));
             }
             else
-                s.timer -= diff;
+                _rotation.Schedule(slot, _clock + KIT_RETRY_MS);  // HP gate or no target yet
         }
 
         DoMeleeAttackIfReady();
@@ -327,53 +272,72 @@ public:
     {
         _enraged = false;
         CreatureAI::EnterEvadeMode();
+        sDMAggro->Track(me);
     }
 
     void JustDied(Unit* killer) override
     {
+        sDMAggro->Untrack(me);
+        sDMAggro->Retire(me);
         CreatureAI::JustDied(killer);
         // Same note as trash: do NOT fill loot here — handled by OnUnitDeath hook.
         sDungeonMasterMgr->OnCreatureDeathHook(me);
     }
 
 private:
-    struct SpellEntry
+    void ResetRotation()
     {
-        uint32 spellId;
-        uint32 cdMin;       // min cooldown ms
-        uint32 cdMax;       // max cooldown ms
-        bool   pbAoE;       // true = cast on self (PBAoE), false = cast on victim
-        uint32 timer = 0;   // current countdown
-    };
+        _clock     = 0;
+        _gcdEndsAt = 0;
+        _rotation.Start(*_kit, _clock);
+    }
+
+    Unit* SelectKitTarget(uint8 target)
+    {
+        switch (target)
+        {
+            case KIT_TARGET_SELF:   return me;
+            case KIT_TARGET_RANDOM: return SelectTarget(SelectTargetMethod::Random, 0, 0.0f, true);
+            default:                return me->GetVictim();
+        }
+    }
 
-    std::vector<SpellEntry> _spells;
+    static constexpr uint32 KIT_RETRY_MS = 500;
+
+    const BossKit* _kit;        // shared, owned by sDMBossKits
+    BossRotation   _rotation;
+    uint32 _clock     = 0;      // fight time, ms
+    uint32 _gcdEndsAt = 0;
     bool   _enraged;
-    uint32 _aggroTimer = 0;
 };
 
-// Session helper implementations (declared in DMTypes.h)
-uint32 Session::GetAlivePlayerCount() const
+void PartyView::Resolve(const Session& session)
 {
-    uint32 n = 0;
-    for (const auto& pd : Players)
+    _players.clear();
+    _ref        = nullptr;
+    _refLookups = 0;
+    _demand     = 0;
+    for (const auto& pd : session.Players)
     {
         Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
-        if (p && p->IsAlive()) ++n;
+        _players.push_back(p);
+        if (_ref)
+            continue;
+        ++_refLookups;
+        if (p && p->GetMapId() == session.MapId)
+            _ref = p;
     }
-    return n;
 }
 
-bool Session::IsPartyWiped()    const { return GetAlivePlayerCount() == 0; }
-
-bool Session::IsGroupInCombat() const
+// Saved = what the readers would have looked up themselves, less the lookups
+// Resolve made for them. A view read once (or not at all) saves nothing.
+void PartyView::CommitCounters() const
 {
-    for (const auto& pd : Players)
-    {
-        Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
-        if (p && p->IsAlive() && p->IsInCombat())
-            return true;
-    }
-    return false;
+    if (!sDMConfig->IsPerfEnabled())
+        return;
+    sDMPerf->Count(HOOK_PARTY_LOOKUPS, _players.size());
+    if (_demand > _players.size())
+        sDMPerf->Count(HOOK_PARTY_LOOKUPS_SAVED, _demand - _players.size());
 }
 
 // Singleton
@@ -397,12 +361,17 @@ void DungeonMasterMgr::Initialize()
 
 void DungeonMasterMgr::LoadFromDB()
 {
+    LoadDungeonEntrances();
     LoadCreaturePools();
     LoadDungeonBossPool();
     LoadClassLevelStats();
+    sDMBossKits->Load();
     LoadRewardItems();
     LoadLootPool();
-    LoadAllPlayerStats();
+    LoadLeaderboards();
+    _cooldowns.Load(GameTime::GetGameTime().count());
+    _checkpoints.Load();
+    _playerStats.SetCapacity(sDMConfig->GetStatsCacheSize());
 }
 
 // Load creature pools from world DB, split into trash (rank 0) and boss (rank 1/2/4)
@@ -635,6 +604,16 @@ const ClassLevelStatEntry* DungeonMasterMgr::GetBaseStatsForLevel(
     return nullptr;
 }
 
+// Stat totals used for class scoring, captured once so selection never touches ItemTemplate
+static ItemStatProfile BuildItemStatProfile(uint32 itemEntry)
+{
+    ItemStatProfile profile;
+    if (const ItemTemplate* proto = sObjectMgr->GetItemTemplate(itemEntry))
+        for (uint8 i = 0; i < MAX_ITEM_PROTO_STATS; ++i)
+            AddItemStat(profile, proto->ItemStat[i].ItemStatType, proto->ItemStat[i].ItemStatValue);
+    return profile;
+}
+
 // Cache equippable reward items (green/blue/purple)
 void DungeonMasterMgr::LoadRewardItems()
 {
@@ -675,6 +654,7 @@ void DungeonMasterMgr::LoadRewardItems()
             ri.SubClass      = f[5].Get<uint32>();
             ri.AllowableClass = f[6].Get<int32>();
             ri.ItemLevel     = f[7].Get<uint16>();
+            ri.Stats         = BuildItemStatProfile(ri.Entry);
             _rewardItems.push_back(ri);
         } while (result->NextRow());
     }
@@ -722,6 +702,7 @@ void DungeonMasterMgr::LoadLootPool()
             li.SubClass       = f[4].Get<uint8>();
             li.AllowableClass = f[5].Get<int32>();
             li.ItemLevel      = f[6].Get<uint16>();
+            li.Stats          = BuildItemStatProfile(li.Entry);
             _lootPool.push_back(li);
         } while (result->NextRow());
     }
@@ -766,6 +747,12 @@ uint8 DungeonMasterMgr::ComputeEffectiveLevel(Player* leader) const
 
 // SESSION LIFECYCLE
 
+void DungeonMasterMgr::SetReplaySeed(ObjectGuid leaderGuid, uint64 seed)
+{
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+    _replaySeeds[leaderGuid] = seed;
+}
+
 Session* DungeonMasterMgr::CreateSession(Player* leader, uint32 difficultyId,
                                           uint32 themeId, uint32 mapId,
                                           bool scaleToParty)
@@ -792,6 +779,17 @@ Session* DungeonMasterMgr::CreateSession(Player* leader, uint32 difficultyId,
     s.ScaleToParty = scaleToParty;
     s.StartTime    = GameTime::GetGameTime().count();
 
+    auto replay = _replaySeeds.find(s.LeaderGuid);
+    if (replay != _replaySeeds.end())
+    {
+        s.Seed = replay->second;
+        _replaySeeds.erase(replay);
+        LOG_INFO("module", "DungeonMaster: Session {} replaying seed {}", s.SessionId, s.Seed);
+    }
+    else
+        s.Seed = NewRandomSeed();
+    s.Rng.Seed(s.Seed);
+
     if (sDMConfig->IsTimeLimitEnabled())
         s.TimeLimit = sDMConfig->GetTimeLimitMinutes() * 60;
 
@@ -830,6 +828,7 @@ Session* DungeonMasterMgr::CreateSession(Player* leader, uint32 difficultyId,
     ld.ReturnPosition = { leader->GetPositionX(), leader->GetPositionY(),
                           leader->GetPositionZ(), leader->GetOrientation() };
     s.Players.push_back(ld);
+    s.UpdatePresence(s.Players.back(), true, leader->IsAlive(), leader->IsInCombat());
 
 
     if (Group* g = leader->GetGroup())
@@ -845,13 +844,17 @@ Session* DungeonMasterMgr::CreateSession(Player* leader, uint32 difficultyId,
                 md.ReturnPosition = { m->GetPositionX(), m->GetPositionY(),
                                       m->GetPositionZ(), m->GetOrientation() };
                 s.Players.push_back(md);
+                s.UpdatePresence(s.Players.back(), true, m->IsAlive(), m->IsInCombat());
             }
         }
     }
 
     _activeSessions[s.SessionId] = s;
     for (const auto& pd : s.Players)
-        _playerToSession[pd.PlayerGuid] = s.SessionId;
+    {
+        TrackSessionPlayer(pd.PlayerGuid, s.SessionId);
+        _playerStats.Load(pd.PlayerGuid.GetCounter());  // no-op if already resident
+    }
 
     LOG_INFO("module", "DungeonMaster: Session {} — leader {}, party {}, diff {}, level band {}-{}, scale={}",
         s.SessionId, leader->GetName(), s.Players.size(),
@@ -917,6 +920,24 @@ bool DungeonMasterMgr::TeleportPartyIn(Session* session)
     Position ent = session->EntrancePos;
     uint32 ok = 0;
 
+    // Formatted once; only members whose teleport was queued receive them
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+        "|cFF00FF00[Dungeon Master]|r Welcome to |cFFFFFFFF%s|r! "
+        "Defeat the boss to claim your reward.",
+        dg->Name.c_str());
+    ChatBroadcast welcome(buf);
+
+    ChatBroadcast affixes;
+    if (session->RoguelikeRunId != 0 && sRoguelikeMgr->HasActiveAffixes(session->RoguelikeRunId))
+    {
+        std::string affixNames = sRoguelikeMgr->GetActiveAffixNames(session->RoguelikeRunId);
+        char affixBuf[512];
+        snprintf(affixBuf, sizeof(affixBuf),
+            "|cFF00FFFF[Roguelike]|r Active affixes: %s", affixNames.c_str());
+        affixes.Set(affixBuf);
+    }
+
     for (auto& pd : session->Players)
     {
         Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
@@ -940,21 +961,8 @@ bool DungeonMasterMgr::TeleportPartyIn(Session* session)
             ++ok;
             LOG_INFO("module", "DungeonMaster: TeleportTo queued for {} → map {} ({:.1f}, {:.1f}, {:.1f})",
                 p->GetName(), session->MapId, ent.GetPositionX(), ent.GetPositionY(), ent.GetPositionZ());
-            char buf[256];
-            snprintf(buf, sizeof(buf),
-                "|cFF00FF00[Dungeon Master]|r Welcome to |cFFFFFFFF%s|r! "
-                "Defeat the boss to claim your reward.",
-                dg->Name.c_str());
-            ChatHandler(p->GetSession()).SendSysMessage(buf);
-
-            if (session->RoguelikeRunId != 0 && sRoguelikeMgr->HasActiveAffixes(session->RoguelikeRunId))
-            {
-                std::string affixNames = sRoguelikeMgr->GetActiveAffixNames(session->RoguelikeRunId);
-                char affixBuf[512];
-                snprintf(affixBuf, sizeof(affixBuf),
-                    "|cFF00FFFF[Roguelike]|r Active affixes: %s", affixNames.c_str());
-                ChatHandler(p->GetSession()).SendSysMessage(affixBuf);
-            }
+            welcome.SendTo(p);
+            affixes.SendTo(p);
         }
         else
         {
@@ -991,23 +999,80 @@ void DungeonMasterMgr::TeleportPartyOut(Session* session)
 }
 
 // Dungeon entrance lookup from areatrigger_teleport
-Position DungeonMasterMgr::GetDungeonEntrance(uint32 mapId)
+// Entrances come from areatrigger_teleport once at startup so that starting
+// a challenge or a roguelike floor never waits on a world DB round trip.
+void DungeonMasterMgr::LoadDungeonEntrances()
 {
-    char q[256];
-    snprintf(q, sizeof(q),
-        "SELECT target_position_x, target_position_y, target_position_z, target_orientation "
-        "FROM areatrigger_teleport WHERE target_map = %u LIMIT 1", mapId);
-    if (QueryResult r = WorldDatabase.Query(q))
+    _dungeonEntrances.clear();
+
+    QueryResult result = WorldDatabase.Query(
+        "SELECT target_map, target_position_x, target_position_y, target_position_z, target_orientation "
+        "FROM areatrigger_teleport ORDER BY ID");
+    if (!result)
+    {
+        LOG_WARN("module", "DungeonMaster: areatrigger_teleport is empty — no dungeon entrances.");
+        return;
+    }
+
+    do
+    {
+        Field* f = result->Fetch();
+        uint32 mapId = f[0].Get<uint32>();
+        // First trigger per map wins, matching the old per-map LIMIT 1 lookup
+        _dungeonEntrances.emplace(mapId,
+            Position(f[1].Get<float>(), f[2].Get<float>(), f[3].Get<float>(), f[4].Get<float>()));
+    } while (result->NextRow());
+
+    uint32 missing = 0;
+    for (const auto& dg : sDMConfig->GetDungeons())
     {
-        Field* f = r->Fetch();
-        return { f[0].Get<float>(), f[1].Get<float>(), f[2].Get<float>(), f[3].Get<float>() };
+        if (_dungeonEntrances.count(dg.MapId))
+            continue;
+        LOG_WARN("module", "DungeonMaster: No areatrigger_teleport for map {} ({})", dg.MapId, dg.Name);
+        ++missing;
     }
-    LOG_WARN("module", "DungeonMaster: No areatrigger_teleport for map {}", mapId);
+
+    LOG_INFO("module", "DungeonMaster: Cached {} dungeon entrances ({} configured dungeons without one).",
+        _dungeonEntrances.size(), missing);
+}
+
+Position DungeonMasterMgr::GetDungeonEntrance(uint32 mapId) const
+{
+    auto it = _dungeonEntrances.find(mapId);
+    if (it != _dungeonEntrances.end())
+        return it->second;
     return { 0, 0, 0, 0 };
 }
 
 // Spawn-point collection
-std::vector<SpawnPoint> DungeonMasterMgr::GetSpawnPointsForMap(uint32 mapId)
+// Built once per map from two world DB queries and shared read-only by every
+// session on that map; a session keeps its list alive until it ends.
+SpawnPointList DungeonMasterMgr::GetSpawnPointsForMap(uint32 mapId)
+{
+    {
+        std::lock_guard<std::mutex> lock(_spawnPointMutex);
+        auto it = _spawnPointCache.find(mapId);
+        if (it != _spawnPointCache.end())
+            return it->second;
+    }
+
+    // Loaded outside the lock; two sessions racing on a cold map both query, one result wins
+    auto pts = std::make_shared<const std::vector<SpawnPoint>>(LoadSpawnPointsForMap(mapId));
+    if (pts->empty())
+        return pts;
+
+    std::lock_guard<std::mutex> lock(_spawnPointMutex);
+    return _spawnPointCache.emplace(mapId, std::move(pts)).first->second;
+}
+
+// Boss positions depend on Dungeon.BossCount, so a config reload drops the cache
+void DungeonMasterMgr::ClearSpawnPointCache()
+{
+    std::lock_guard<std::mutex> lock(_spawnPointMutex);
+    _spawnPointCache.clear();
+}
+
+std::vector<SpawnPoint> DungeonMasterMgr::LoadSpawnPointsForMap(uint32 mapId)
 {
     std::vector<SpawnPoint> pts;
 
@@ -1140,6 +1205,7 @@ void DungeonMasterMgr::ClearDungeonCreatures(InstanceMap* map)
 
     // Phase 1: despawn our tracked creatures
     uint32 instanceId = map->GetInstanceId();
+    sDMAggro->ClearInstance(instanceId);
     auto guidIt = _instanceCreatureGuids.find(instanceId);
     if (guidIt != _instanceCreatureGuids.end())
     {
@@ -1223,11 +1289,180 @@ void DungeonMasterMgr::OpenAllDoors(InstanceMap* map)
     LOG_DEBUG("module", "DungeonMaster: Removed {} doors from instance.", doors.size());
 }
 
+// Level, stats, movement and AI for a freshly summoned session creature.
+// Multipliers come from the session, fixed when it was populated.
+void DungeonMasterMgr::ApplyLevelAndStats(Session* session, Creature* c, float extraHpMult,
+                                          float extraDmgMult, bool isBoss)
+{
+    uint8 targetLevel     = session->EffectiveLevel;
+    float hpMult          = session->HealthMult;
+    float dmgMult         = session->DamageMult;
+    float bossOnlyDmgMult = session->BossDamageMult;
+    auto& guidList        = _instanceCreatureGuids[c->GetInstanceId()];
+
+    c->SetLevel(targetLevel);
+
+    if (isBoss)
+    {
+        c->SetByteValue(UNIT_FIELD_BYTES_0, 2, 1);  // Elite rank → gold dragon frame
+        c->SetObjectScale(1.3f);                      // 30% larger than normal
+    }
+
+    uint8 unitClass = c->GetCreatureTemplate()->unit_class;
+    const ClassLevelStatEntry* baseStats = GetBaseStatsForLevel(unitClass, targetLevel);
+
+    uint32 hp = ScaleCreatureHealth(baseStats, c->GetMaxHealth(), hpMult * extraHpMult);
+    c->SetMaxHealth(hp);
+    c->SetHealth(hp);
+
+    // For bosses, use party-only scaling (bossOnlyDmgMult) instead of the full
+    // tier+party dmgMult to prevent double-stacking tier DamageMultiplier with BossDamageMult
+    float effectiveDmgMult = isBoss ? bossOnlyDmgMult : dmgMult;
+
+    if (baseStats)
+    {
+        float minDmg, maxDmg;
+        ScaleCreatureDamage(*baseStats, c->GetCreatureTemplate()->BaseAttackTime,
+            effectiveDmgMult * extraDmgMult, minDmg, maxDmg);
+
+        c->SetBaseWeaponDamage(BASE_ATTACK, MINDAMAGE, minDmg);
+        c->SetBaseWeaponDamage(BASE_ATTACK, MAXDAMAGE, maxDmg);
+        c->UpdateDamagePhysical(BASE_ATTACK);
+    }
+
+    // --- Armor (from classlevelstats for the TARGET level) ---
+    if (baseStats && baseStats->BaseArmor > 0)
+        c->SetArmor(baseStats->BaseArmor);
+
+    // --- Roguelike: additional armor scaling from tier progression ---
+    if (session->RoguelikeRunId != 0)
+    {
+        float armorMult = sRoguelikeMgr->GetTierArmorMultiplier(session->RoguelikeRunId);
+        if (armorMult > 1.0f)
+            c->SetArmor(static_cast<uint32>(c->GetArmor() * armorMult));
+    }
+
+    // --- Clear ALL spell resistances (original template values are for original level) ---
+    for (uint8 school = SPELL_SCHOOL_HOLY; school < MAX_SPELL_SCHOOL; ++school)
+        c->SetResistance(SpellSchools(school), 0);
+
+    // --- Clear mechanic immunities ---
+    for (uint32 mech = 1; mech < MAX_MECHANIC; ++mech)
+        c->ApplySpellImmune(0, IMMUNITY_MECHANIC, mech, false);
+
+    // --- Clear spell immunities that might come from the template ---
+    c->ApplySpellImmune(0, IMMUNITY_SCHOOL, SPELL_SCHOOL_MASK_ALL, false);
+
+    // --- Movement ---
+    if (isBoss)
+    {
+        // Bosses stay at their spawn point until engaged.
+        c->SetWanderDistance(0.0f);
+        c->SetDefaultMovementType(IDLE_MOTION_TYPE);
+    }
+    else
+    {
+        // Trash mobs patrol a 5 yd radius around their spawn point
+        c->SetWanderDistance(5.0f);
+        c->SetDefaultMovementType(RANDOM_MOTION_TYPE);
+        c->GetMotionMaster()->MoveRandom(5.0f);
+    }
+
+    // --- Install custom AI ---
+    // Both trash and bosses get custom AI.  Boss creatures are pulled from
+    // the dungeon-boss pool (ScriptName != ''), but their native C++ AI
+    // depends on their home dungeon's InstanceScript (encounter states,
+    // phase tracking, add management) and will silently fail or crash
+    // when spawned in a foreign instance — leaving bosses with nothing
+    // but auto-attacks.  DungeonMasterBossAI gives every boss a themed
+    // spell rotation; spell damage is scaled by dm_unit_script.
+    if (isBoss)
+        c->SetAI(new DungeonMasterBossAI(c));
+    else
+        c->SetAI(new DungeonMasterCreatureAI(c));
+
+    // Force visibility refresh or client won't see the creature
+    c->UpdateObjectVisibility(true);
+
+    // Track this GUID for future cleanup
+    guidList.push_back(c->GetGUID());
+}
+
+// Summons planned trash whose pack leader lies within `progress` + Dungeon.StreamAhead
+// yards of the entrance (straight-line, the same metric the points are sorted by).
+// Anything within StreamAhead of a player is therefore already spawned. Returns
+// the number summoned; caller holds _sessionMutex or owns the session.
+uint32 DungeonMasterMgr::StreamPopulation(Session* session, InstanceMap* map, float progress)
+{
+    uint32 ahead = sDMConfig->GetStreamAhead();
+    float frontier = ahead ? progress + static_cast<float>(ahead) : std::numeric_limits<float>::max();
+    if (frontier <= session->StreamFrontier)
+        return 0;               // frontier only moves forward
+    session->StreamFrontier = frontier;
+
+    std::unordered_map<uint32, std::vector<Creature*>> packMembers;
+    uint32 spawned = 0;
+    while (session->NextPlanned < session->SpawnPlan.size())
+    {
+        const PlannedSpawn& ps = session->SpawnPlan[session->NextPlanned];
+        if (ps.Distance > session->StreamFrontier)
+            break;
+        ++session->NextPlanned;
+
+        const SpawnPoint& sp = (*session->SpawnPoints)[ps.PointIndex];
+        Creature* c = map->SummonCreature(ps.Entry, sp.Pos);
+        if (!c) continue;
+
+        c->SetFaction(14);               // hostile to all
+        c->SetReactState(REACT_AGGRESSIVE);
+        c->SetObjectScale(1.0f);
+        c->SetCorpseDelay(300);          // 5 min corpse before despawn
+        c->RemoveFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NON_ATTACKABLE | UNIT_FLAG_IMMUNE_TO_PC
+                                        | UNIT_FLAG_IMMUNE_TO_NPC | UNIT_FLAG_PACIFIED
+                                        | UNIT_FLAG_STUNNED | UNIT_FLAG_FLEEING
+                                        | UNIT_FLAG_NOT_SELECTABLE);
+        c->SetUInt32Value(UNIT_FIELD_FLAGS_2, 0);
+        c->SetImmuneToPC(false);
+        c->SetImmuneToNPC(false);
+        sDMAggro->Register(c);          // woken into the grid update cycle as players approach
+
+        ApplyLevelAndStats(session, c, ps.HpMult, ps.DmgMult, false);
+
+        session->SpawnedCreatures.Add(c->GetGUID(), ps.Entry, ps.IsElite ? SPAWN_ELITE : 0,
+            static_cast<uint16>(ps.PackId));
+        packMembers[ps.PackId].push_back(c);
+        ++spawned;
+    }
+
+    // Link packs; a lone mob keeps its own aggro checks and needs no pack
+    for (const auto& [packId, members] : packMembers)
+    {
+        if (members.size() < 2) continue;
+
+        auto pack = std::make_shared<SpawnPack>();
+        pack->Leader = members.front()->GetGUID();
+        pack->Members.reserve(members.size());
+        for (Creature* m : members)
+            pack->Members.push_back(m->GetGUID());
+        for (Creature* m : members)
+            if (auto* ai = dynamic_cast<DungeonMasterCreatureAI*>(m->AI()))
+                ai->SetPack(pack);
+    }
+
+    if (spawned && session->NextPlanned < session->SpawnPlan.size())
+        LOG_DEBUG("module", "DungeonMaster: Session {} — streamed {} trash, frontier {:.0f} yd, {}/{} planned spawned",
+            session->SessionId, spawned, session->StreamFrontier,
+            session->NextPlanned, session->SpawnPlan.size());
+    return spawned;
+}
+
 // Populate dungeon with themed creatures and bosses
 void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
 {
     if (!session || !map) return;
 
+    PerfScope perfScope(PERF_POPULATE);
+
     LOG_INFO("module", "DungeonMaster: PopulateDungeon ENTRY — session {} map {} instId {} mobs {} bosses {}",
         session->SessionId, session->MapId, map->GetInstanceId(),
         session->TotalMobs, session->TotalBosses);
@@ -1236,6 +1471,9 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
     const Theme*          theme = sDMConfig->GetTheme(session->ThemeId);
     if (!diff || !theme) return;
 
+    // Restart the stream so a retried populate rolls the same layout
+    session->Rng.Seed(session->Seed);
+
     ClearDungeonCreatures(map);
     OpenAllDoors(map);
 
@@ -1287,7 +1525,7 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
     }
 
     session->SpawnPoints = GetSpawnPointsForMap(session->MapId);
-    if (session->SpawnPoints.empty())
+    if (!session->SpawnPoints || session->SpawnPoints->empty())
     {
         LOG_ERROR("module", "DungeonMaster: No spawn points for map {}", session->MapId);
         return;
@@ -1304,154 +1542,97 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
     uint32 instanceId = map->GetInstanceId();
     auto& guidList = _instanceCreatureGuids[instanceId];
     guidList.clear();
+    sDMAggro->AddInstance(instanceId);     // before any creature below registers or tracks
 
-    LOG_INFO("module", "DungeonMaster: Populating session {} — theme '{}', band {}-{}, target lvl {}, HP x{:.2f}, DMG x{:.2f}",
-        session->SessionId, theme->Name, bandMin, bandMax, targetLevel, hpMult, dmgMult);
+    LOG_INFO("module", "DungeonMaster: Populating session {} — theme '{}', band {}-{}, target lvl {}, HP x{:.2f}, DMG x{:.2f}, seed {}",
+        session->SessionId, theme->Name, bandMin, bandMax, targetLevel, hpMult, dmgMult, session->Seed);
 
     // Force-scale creature to target level
     // Compute a boss-specific damage multiplier that only includes party scaling,
     // NOT the difficulty tier's DamageMultiplier (to avoid double-stacking).
-    float bossOnlyDmgMult;
-    {
-        uint32 n = session->Players.size();
-        if (n <= 1) bossOnlyDmgMult = sDMConfig->GetSoloMultiplier();
-        else        bossOnlyDmgMult = 1.0f + (n - 1) * sDMConfig->GetPerPlayerDamageMult();
-        if (session->RoguelikeRunId != 0)
-            bossOnlyDmgMult *= sRoguelikeMgr->GetTierDamageMultiplier(session->RoguelikeRunId);
-    }
-
-    auto applyLevelAndStats = [&](Creature* c, float extraHpMult, float extraDmgMult, bool isBoss)
-    {
-    
-        c->SetLevel(targetLevel);
-
-    
-        if (isBoss)
-        {
-            c->SetByteValue(UNIT_FIELD_BYTES_0, 2, 1);  // Elite rank → gold dragon frame
-            c->SetObjectScale(1.3f);                      // 30% larger than normal
-        }
-
-        uint8 unitClass = c->GetCreatureTemplate()->unit_class;
-        const ClassLevelStatEntry* baseStats = GetBaseStatsForLevel(unitClass, targetLevel);
-
-    
-        float finalHP;
-        if (baseStats)
-            finalHP = static_cast<float>(baseStats->BaseHP) * hpMult * extraHpMult;
-        else
-            finalHP = c->GetMaxHealth() * hpMult * extraHpMult;
-
-        uint32 hp = std::max(1u, static_cast<uint32>(finalHP));
-        c->SetMaxHealth(hp);
-        c->SetHealth(hp);
-
-        // For bosses, use party-only scaling (bossOnlyDmgMult) instead of the full
-        // tier+party dmgMult to prevent double-stacking tier DamageMultiplier with BossDamageMult
-        float effectiveDmgMult = isBoss ? bossOnlyDmgMult : dmgMult;
-
-        if (baseStats)
-        {
-            float dmgBase  = baseStats->BaseDamage;
-            float apBonus  = static_cast<float>(baseStats->AttackPower) / 14.0f;
-            float atkTime  = static_cast<float>(c->GetCreatureTemplate()->BaseAttackTime) / 1000.0f;
-            if (atkTime <= 0.0f) atkTime = 2.0f;
-
-            float minDmg = (dmgBase + apBonus) * atkTime * effectiveDmgMult * extraDmgMult;
-            float maxDmg = ((dmgBase * 1.15f) + apBonus) * atkTime * effectiveDmgMult * extraDmgMult;
-
-            minDmg = std::max(1.0f, minDmg);
-            maxDmg = std::max(minDmg, maxDmg);
-
-            c->SetBaseWeaponDamage(BASE_ATTACK, MINDAMAGE, minDmg);
-            c->SetBaseWeaponDamage(BASE_ATTACK, MAXDAMAGE, maxDmg);
-            c->UpdateDamagePhysical(BASE_ATTACK);
-        }
-
-        // --- Armor (from classlevelstats for the TARGET level) ---
-        if (baseStats && baseStats->BaseArmor > 0)
-            c->SetArmor(baseStats->BaseArmor);
-
-        // --- Roguelike: additional armor scaling from tier progression ---
-        if (session->RoguelikeRunId != 0)
-        {
-            float armorMult = sRoguelikeMgr->GetTierArmorMultiplier(session->RoguelikeRunId);
-            if (armorMult > 1.0f)
-                c->SetArmor(static_cast<uint32>(c->GetArmor() * armorMult));
+    float bossOnlyDmgMult = PartyScaling(static_cast<uint32>(session->Players.size()),
+        sDMConfig->GetSoloMultiplier(), sDMConfig->GetPerPlayerDamageMult());
+    if (session->RoguelikeRunId != 0)
+        bossOnlyDmgMult *= sRoguelikeMgr->GetTierDamageMultiplier(session->RoguelikeRunId);
+
+    session->HealthMult     = hpMult;
+    session->DamageMult     = dmgMult;
+    session->BossDamageMult = bossOnlyDmgMult;
+
+
+    // ---- Population budget: difficulty count, then world load and server headroom ----
+    // A repopulate gives back its earlier charge first
+    ReleaseCreatureBudget(*session);
+
+    // Points are shared by every session on the map; per-session choices live in local bitsets
+    const std::vector<SpawnPoint>& points = *session->SpawnPoints;
+    uint32 trashPoints = 0;
+    for (const auto& sp : points)
+        if (!sp.IsBossPosition) ++trashPoints;
+
+    uint32 budgetCap  = sDMConfig->GetLiveCreatureBudget();
+    uint32 budgetUsed = _liveBudgetUsed.load(std::memory_order_relaxed);
+    uint32 budgetLeft = budgetCap ? (budgetCap > budgetUsed ? budgetCap - budgetUsed : 0) : UINT32_MAX;
+    float  loadScale  = LoadDensityScale(GetSmoothedWorldDiff(), sDMConfig->GetLoadTargetDiff(),
+                                         sDMConfig->GetMinDensity());
+    PopulationPlan plan = PlanPopulation(trashPoints, diff->MobCountMultiplier, loadScale,
+                                         budgetLeft, sDMConfig->GetMinDensity());
+
+    // Kept points are spread evenly from entrance to boss
+    std::vector<bool> used(points.size(), false);
+    uint32 trashIndex = 0;
+    for (size_t i = 0; i < points.size(); ++i)
+        if (!points[i].IsBossPosition)
+            used[i] = KeepSpreadPoint(trashIndex++, trashPoints, plan.Placed);
+
+    if (plan.Placed < plan.Wanted || plan.Wanted < trashPoints)
+        LOG_INFO("module", "DungeonMaster: Session {} — trash {} of {} points (wanted {}, load x{:.2f}, world diff {} ms, budget {}/{}), HP x{:.2f}",
+            session->SessionId, plan.Placed, trashPoints, plan.Wanted, loadScale,
+            GetSmoothedWorldDiff(), budgetUsed, budgetCap, plan.Toughness);
+
+    // Cluster trash points into packs; points are sorted near -> far, so each
+    // pack's first point (its leader) is the one players reach first
+    uint32 packCount = 0;
+    std::vector<uint32> pointPack(points.size(), 0);
+    std::vector<float>  packDistance;
+    {
+        std::vector<PackPoint> packPoints;
+        std::vector<size_t>    packIndex;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            const SpawnPoint& sp = points[i];
+            if (sp.IsBossPosition || !used[i]) continue;
+            packPoints.push_back({ sp.Pos.GetPositionX(), sp.Pos.GetPositionY(), sp.Pos.GetPositionZ() });
+            packIndex.push_back(i);
         }
 
-        // --- Clear ALL spell resistances (original template values are for original level) ---
-        for (uint8 school = SPELL_SCHOOL_HOLY; school < MAX_SPELL_SCHOOL; ++school)
-            c->SetResistance(SpellSchools(school), 0);
-
-        // --- Clear mechanic immunities ---
-        for (uint32 mech = 1; mech < MAX_MECHANIC; ++mech)
-            c->ApplySpellImmune(0, IMMUNITY_MECHANIC, mech, false);
-
-        // --- Clear spell immunities that might come from the template ---
-        c->ApplySpellImmune(0, IMMUNITY_SCHOOL, SPELL_SCHOOL_MASK_ALL, false);
-
-        // --- Movement ---
-        if (isBoss)
-        {
-            // Bosses stay at their spawn point until engaged.
-            c->SetWanderDistance(0.0f);
-            c->SetDefaultMovementType(IDLE_MOTION_TYPE);
-        }
-        else
+        std::vector<uint32> packOf;
+        packCount = ClusterPacks(packPoints, sDMConfig->GetPackRadius(), sDMConfig->GetPackMaxSize(), packOf);
+        packDistance.assign(packCount, -1.0f);
+        for (size_t i = 0; i < packIndex.size(); ++i)
         {
-            // Trash mobs patrol a 5 yd radius around their spawn point
-            c->SetWanderDistance(5.0f);
-            c->SetDefaultMovementType(RANDOM_MOTION_TYPE);
-            c->GetMotionMaster()->MoveRandom(5.0f);
+            pointPack[packIndex[i]] = packOf[i];
+            // The leader's distance, taken before the entry roll can drop its point
+            if (packDistance[packOf[i]] < 0.0f)
+                packDistance[packOf[i]] = points[packIndex[i]].DistanceFromEntrance;
         }
+    }
 
-        // --- Install custom AI ---
-        // Both trash and bosses get custom AI.  Boss creatures are pulled from
-        // the dungeon-boss pool (ScriptName != ''), but their native C++ AI
-        // depends on their home dungeon's InstanceScript (encounter states,
-        // phase tracking, add management) and will silently fail or crash
-        // when spawned in a foreign instance — leaving bosses with nothing
-        // but auto-attacks.  DungeonMasterBossAI gives every boss a themed
-        // spell rotation; spell damage is scaled by dm_unit_script.
-        if (isBoss)
-            c->SetAI(new DungeonMasterBossAI(c));
-        else
-            c->SetAI(new DungeonMasterCreatureAI(c));
-
-        // Force visibility refresh or client won't see the creature
-        c->UpdateObjectVisibility(true);
-
-        // Track this GUID for future cleanup
-        guidList.push_back(c->GetGUID());
-    };
-
-    // Spawn trash mobs
-    uint32 spawnedMobs = 0;
-    for (auto& sp : session->SpawnPoints)
+    // ---- Roll the trash plan up front; summoning follows the party (StreamPopulation) ----
+    session->SpawnPlan.clear();
+    session->NextPlanned    = 0;
+    session->StreamFrontier = 0.0f;
+    std::vector<uint32> packSize(packCount, 0);
+    for (size_t i = 0; i < points.size(); ++i)
     {
-        if (sp.IsBossPosition) continue;
+        const SpawnPoint& sp = points[i];
+        if (sp.IsBossPosition || !used[i]) continue;
+        uint32 packId = pointPack[i];
 
-        uint32 entry = SelectCreatureForTheme(theme, false);
+        uint32 entry = SelectCreatureForTheme(theme, false, session->Rng);
         if (!entry) continue;
 
-        Creature* c = map->SummonCreature(entry, sp.Pos);
-        if (!c) continue;
-
-        c->SetFaction(14);               // hostile to all
-        c->SetReactState(REACT_AGGRESSIVE);
-        c->SetObjectScale(1.0f);
-        c->SetCorpseDelay(300);          // 5 min corpse before despawn
-        c->RemoveFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NON_ATTACKABLE | UNIT_FLAG_IMMUNE_TO_PC
-                                        | UNIT_FLAG_IMMUNE_TO_NPC | UNIT_FLAG_PACIFIED
-                                        | UNIT_FLAG_STUNNED | UNIT_FLAG_FLEEING
-                                        | UNIT_FLAG_NOT_SELECTABLE);
-        c->SetUInt32Value(UNIT_FIELD_FLAGS_2, 0);
-        c->SetImmuneToPC(false);
-        c->SetImmuneToNPC(false);
-        c->setActive(true);             // Keep creature in grid update cycle for aggro detection
-
-        bool isElite = (RandInt<uint32>(1, 100) <= sDMConfig->GetEliteChance());
+        bool isElite = session->Rng.Chance(sDMConfig->GetEliteChance());
 
         // Roguelike affix multipliers for trash
         float affixHpMult = 1.0f, affixDmgMult = 1.0f, affixEliteMult = 1.0f;
@@ -1463,31 +1644,47 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
             if (affixEliteMult > 1.0f && !isElite)
             {
                 uint32 boostedChance = static_cast<uint32>(sDMConfig->GetEliteChance() * affixEliteMult);
-                isElite = (RandInt<uint32>(1, 100) <= boostedChance);
+                isElite = session->Rng.Chance(boostedChance);
             }
         }
 
         float eliteHpMult  = isElite ? sDMConfig->GetEliteHealthMult() : 1.0f;
         float eliteDmgMult = isElite ? 1.5f : 1.0f;
 
-        applyLevelAndStats(c, eliteHpMult * affixHpMult, eliteDmgMult * affixDmgMult, false);
+        ++packSize[packId];
 
-        SpawnedCreature sc;
-        sc.Guid = c->GetGUID(); sc.Entry = entry;
-        sc.IsElite = isElite; sc.IsBoss = false;
-        session->SpawnedCreatures.push_back(sc);
-        ++spawnedMobs;
+        PlannedSpawn ps;
+        ps.PointIndex = static_cast<uint32>(i);
+        ps.Entry      = entry;
+        ps.PackId     = packId;
+        ps.HpMult     = eliteHpMult * affixHpMult * plan.Toughness;
+        ps.DmgMult    = eliteDmgMult * affixDmgMult;
+        ps.IsElite    = isElite;
+        session->SpawnPlan.push_back(ps);
     }
-    session->TotalMobs = spawnedMobs;
+
+    // Whole packs in leader-distance order, so a pack is never split across batches
+    for (auto& ps : session->SpawnPlan)
+        ps.Distance = packDistance[ps.PackId];
+    std::stable_sort(session->SpawnPlan.begin(), session->SpawnPlan.end(),
+        [](const PlannedSpawn& a, const PlannedSpawn& b) { return a.PackId < b.PackId; });
+
+    session->TotalMobs  = static_cast<uint32>(session->SpawnPlan.size());
+    session->TotalPacks = static_cast<uint32>(std::count_if(packSize.begin(), packSize.end(),
+        [](uint32 n) { return n >= 2; }));
+
+    // Everything within StreamAhead of the entrance now (all of it when streaming is off)
+    StreamPopulation(session, map, 0.0f);
 
     // --- Rare spawn (configurable chance, max 1 per run) ---
+    uint32 rareSpawned = 0;
     if (sDMConfig->GetRareSpawnChance() > 0 &&
-        RandInt<uint32>(1, 100) <= sDMConfig->GetRareSpawnChance())
+        session->Rng.Chance(sDMConfig->GetRareSpawnChance()))
     {
         // Pick non-boss spawn points for rare placement (prefer middle of dungeon)
         std::vector<size_t> validRarePoints;
-        for (size_t i = 0; i < session->SpawnPoints.size(); ++i)
-            if (!session->SpawnPoints[i].IsBossPosition)
+        for (size_t i = 0; i < points.size(); ++i)
+            if (!points[i].IsBossPosition)
                 validRarePoints.push_back(i);
 
         if (!validRarePoints.empty())
@@ -1495,10 +1692,10 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
             size_t startIdx = validRarePoints.size() / 3;
             size_t endIdx   = std::max(startIdx, validRarePoints.size() * 2 / 3);
             if (endIdx >= validRarePoints.size()) endIdx = validRarePoints.size() - 1;
-            size_t pickIdx  = validRarePoints[RandInt<size_t>(startIdx, endIdx)];
-            SpawnPoint& rareSP = session->SpawnPoints[pickIdx];
+            size_t pickIdx  = validRarePoints[session->Rng.Range<size_t>(startIdx, endIdx)];
+            const SpawnPoint& rareSP = points[pickIdx];
 
-            uint32 rareEntry = SelectCreatureForTheme(theme, true);
+            uint32 rareEntry = SelectCreatureForTheme(theme, true, session->Rng);
             if (rareEntry)
             {
                 Creature* r = map->SummonCreature(rareEntry, rareSP.Pos);
@@ -1514,7 +1711,7 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
                     r->SetUInt32Value(UNIT_FIELD_FLAGS_2, 0);
                     r->SetImmuneToPC(false);
                     r->SetImmuneToNPC(false);
-                    r->setActive(true);
+                    sDMAggro->Register(r);
 
                     // Silver dragon portrait (rank 4 = rare)
                     r->SetByteValue(UNIT_FIELD_BYTES_0, 2, 4);
@@ -1529,16 +1726,14 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
                         sRoguelikeMgr->GetAffixMultipliers(session->RoguelikeRunId,
                             false, true, affixHpM, affixDmgM, affixEliteM);
 
-                    applyLevelAndStats(r, rareHpMult * affixHpM, rareDmgMult * affixDmgM, false);
+                    ApplyLevelAndStats(session, r, rareHpMult * affixHpM, rareDmgMult * affixDmgM, false);
 
                     // Install custom AI (rare is treated as enhanced trash, not a scripted boss)
                     r->SetAI(new DungeonMasterCreatureAI(r));
 
-                    SpawnedCreature sc;
-                    sc.Guid = r->GetGUID(); sc.Entry = rareEntry;
-                    sc.IsElite = true; sc.IsBoss = false; sc.IsRare = true;
-                    session->SpawnedCreatures.push_back(sc);
+                    session->SpawnedCreatures.Add(r->GetGUID(), rareEntry, SPAWN_ELITE | SPAWN_RARE);
                     guidList.push_back(r->GetGUID());
+                    ++rareSpawned;
 
                     for (const auto& pd : session->Players)
                         if (Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid))
@@ -1555,12 +1750,12 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
 
     // Spawn bosses (real dungeon bosses)
     uint32 bossesSpawned = 0;
-    for (auto& sp : session->SpawnPoints)
+    for (const auto& sp : points)
     {
         if (!sp.IsBossPosition || bossesSpawned >= sDMConfig->GetBossCount())
             continue;
 
-        uint32 entry = SelectDungeonBoss(theme);
+        uint32 entry = SelectDungeonBoss(theme, session->Rng);
         if (!entry) { LOG_WARN("module", "DungeonMaster: No boss candidate."); continue; }
 
         Creature* b = map->SummonCreature(entry, sp.Pos);
@@ -1576,7 +1771,7 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
         b->SetUInt32Value(UNIT_FIELD_FLAGS_2, 0);
         b->SetImmuneToPC(false);
         b->SetImmuneToNPC(false);
-        b->setActive(true);             // Keep creature in grid update cycle for aggro detection
+        sDMAggro->Register(b);          // woken into the grid update cycle as players approach
 
         // Roguelike affix multipliers for bosses
         float bossAffixHpMult = 1.0f, bossAffixDmgMult = 1.0f, _unused = 1.0f;
@@ -1584,14 +1779,11 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
             sRoguelikeMgr->GetAffixMultipliers(session->RoguelikeRunId,
                 true, true, bossAffixHpMult, bossAffixDmgMult, _unused);
 
-        applyLevelAndStats(b,
+        ApplyLevelAndStats(session, b,
             sDMConfig->GetBossHealthMult() * bossAffixHpMult,
             sDMConfig->GetBossDamageMult() * bossAffixDmgMult, true);
 
-        SpawnedCreature sc;
-        sc.Guid = b->GetGUID(); sc.Entry = entry;
-        sc.IsElite = true; sc.IsBoss = true;
-        session->SpawnedCreatures.push_back(sc);
+        session->SpawnedCreatures.Add(b->GetGUID(), entry, SPAWN_ELITE | SPAWN_BOSS);
         ++bossesSpawned;
 
         LOG_INFO("module", "DungeonMaster: Boss spawned — entry {}, name '{}', "
@@ -1602,8 +1794,11 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
     }
     session->TotalBosses = bossesSpawned;
 
-    LOG_INFO("module", "DungeonMaster: Session {} — {} mobs, {} bosses spawned.",
-        session->SessionId, session->TotalMobs, session->TotalBosses);
+    session->BudgetCharge = session->TotalMobs + rareSpawned + bossesSpawned;   // whole plan, streamed or not
+    _liveBudgetUsed.fetch_add(session->BudgetCharge, std::memory_order_relaxed);
+
+    LOG_INFO("module", "DungeonMaster: Session {} — {} mobs ({} packs), {} bosses spawned.",
+        session->SessionId, session->TotalMobs, session->TotalPacks, session->TotalBosses);
 
     // --- Reset encounter states to NOT_STARTED so boss AIs can engage properly ---
     // We set all encounters to DONE earlier (line ~1049) to clear original dungeon
@@ -1668,84 +1863,37 @@ void DungeonMasterMgr::PopulateDungeon(Session* session, InstanceMap* map)
 }
 
 // Select a creature matching the theme
-uint32 DungeonMasterMgr::SelectCreatureForTheme(const Theme* theme, bool isBoss)
+uint32 DungeonMasterMgr::SelectCreatureForTheme(const Theme* theme, bool isBoss, DMRng& rng)
 {
     if (!theme) return 0;
 
+    const std::vector<uint32>* types = &theme->CreatureTypes;
+    uint32 candidates = 0;
+    uint32 entry = 0;
 
-    std::set<uint32> types;
-    bool anyType = false;
-    for (uint32 t : theme->CreatureTypes)
-    {
-        if (t == uint32(-1)) anyType = true;
-        else types.insert(t);
-    }
+    // Bosses: themed elites first, then promote themed trash (stats will be scaled up)
+    if (isBoss)
+        entry = PickPoolEntry(_bossCreatures, types, rng, &candidates);
+    if (!candidates)
+        entry = PickPoolEntry(_creaturesByType, types, rng, &candidates);
 
-    auto typeMatch = [&](uint32 cType) -> bool
+    // Fallback: any type
+    if (!candidates && !MatchesAnyType(theme->CreatureTypes))
     {
-        return anyType || types.count(cType);
-    };
+        LOG_WARN("module", "DungeonMaster: No '{}' creatures found — falling back to any type.",
+            theme->Name);
 
-    std::vector<uint32> candidates;
+        if (isBoss)
+            entry = PickPoolEntry(_bossCreatures, nullptr, rng, &candidates);
+        if (!candidates)
+            entry = PickPoolEntry(_creaturesByType, nullptr, rng, &candidates);
+    }
 
-    if (isBoss)
-    {
-        // --- Try themed elites first ---
-        for (const auto& [type, vec] : _bossCreatures)
-        {
-            if (!typeMatch(type)) continue;
-            for (const auto& e : vec)
-                candidates.push_back(e.Entry);
-        }
-
-        // --- Fallback: promote themed trash to boss (stats will be scaled up) ---
-        if (candidates.empty())
-        {
-            for (const auto& [type, vec] : _creaturesByType)
-            {
-                if (!typeMatch(type)) continue;
-                for (const auto& e : vec)
-                    candidates.push_back(e.Entry);
-            }
-        }
-    }
-    else
-    {
-        // --- Themed trash ---
-        for (const auto& [type, vec] : _creaturesByType)
-        {
-            if (!typeMatch(type)) continue;
-            for (const auto& e : vec)
-                candidates.push_back(e.Entry);
-        }
-    }
-
-    // Fallback: any type
-    if (candidates.empty() && !anyType)
-    {
-        LOG_WARN("module", "DungeonMaster: No '{}' creatures found — falling back to any type.",
-            theme->Name);
-
-        if (isBoss)
-        {
-            for (const auto& [type, vec] : _bossCreatures)
-                for (const auto& e : vec)
-                    candidates.push_back(e.Entry);
-        }
-
-        if (candidates.empty())
-        {
-            for (const auto& [type, vec] : _creaturesByType)
-                for (const auto& e : vec)
-                    candidates.push_back(e.Entry);
-        }
-    }
-
-    if (!candidates.empty())
+    if (candidates)
     {
         LOG_DEBUG("module", "DungeonMaster: {} candidates for theme '{}' (boss={})",
-            candidates.size(), theme->Name, isBoss);
-        return candidates[RandInt<size_t>(0, candidates.size() - 1)];
+            candidates, theme->Name, isBoss);
+        return entry;
     }
 
     LOG_ERROR("module", "DungeonMaster: ZERO candidates for theme '{}' (boss={})",
@@ -1754,53 +1902,31 @@ uint32 DungeonMasterMgr::SelectCreatureForTheme(const Theme* theme, bool isBoss)
 }
 
 
-uint32 DungeonMasterMgr::SelectDungeonBoss(const Theme* theme)
+uint32 DungeonMasterMgr::SelectDungeonBoss(const Theme* theme, DMRng& rng)
 {
     if (!theme) return 0;
 
-
-    std::set<uint32> types;
-    bool anyType = false;
-    for (uint32 t : theme->CreatureTypes)
-    {
-        if (t == uint32(-1)) anyType = true;
-        else types.insert(t);
-    }
-
-    auto typeMatch = [&](uint32 cType) -> bool
-    {
-        return anyType || types.count(cType);
-    };
-
     // Prefer themed dungeon bosses
-    std::vector<uint32> candidates;
-    for (const auto& [type, vec] : _dungeonBossPool)
-    {
-        if (!typeMatch(type)) continue;
-        for (const auto& e : vec)
-            candidates.push_back(e.Entry);
-    }
+    uint32 candidates = 0;
+    uint32 entry = PickPoolEntry(_dungeonBossPool, &theme->CreatureTypes, rng, &candidates);
 
     // Fallback: any dungeon boss
-    if (candidates.empty())
+    if (!candidates)
     {
         LOG_DEBUG("module", "DungeonMaster: No themed dungeon boss for '{}' — using any dungeon boss.",
             theme->Name);
-        for (const auto& [type, vec] : _dungeonBossPool)
-            for (const auto& e : vec)
-                candidates.push_back(e.Entry);
+        entry = PickPoolEntry(_dungeonBossPool, nullptr, rng, &candidates);
     }
 
     // Last resort: generic boss pool
-    if (candidates.empty())
+    if (!candidates)
     {
         LOG_WARN("module", "DungeonMaster: Dungeon boss pool empty — falling back to generic boss selection.");
-        return SelectCreatureForTheme(theme, true);
+        return SelectCreatureForTheme(theme, true, rng);
     }
 
-    uint32 entry = candidates[RandInt<size_t>(0, candidates.size() - 1)];
     LOG_DEBUG("module", "DungeonMaster: Selected dungeon boss entry {} from {} candidates (theme '{}')",
-        entry, candidates.size(), theme->Name);
+        entry, candidates, theme->Name);
     return entry;
 }
 
@@ -1813,73 +1939,65 @@ void DungeonMasterMgr::HandleCreatureDeath(Creature* creature, Session* session)
     LOG_INFO("module", "DungeonMaster: HandleCreatureDeath called for {} (GUID: {}) in session {}",
         creature->GetName(), creature->GetGUID().GetCounter(), session->SessionId);
 
-    for (auto& sc : session->SpawnedCreatures)
-    {
-        if (sc.Guid == creature->GetGUID())
-        {
-            // Mark dead if not already (boss-AI path via OnUnitDeath may arrive
-            // here first when creatures don't use our custom AI).
-            if (!sc.IsDead)
-                sc.IsDead = true;
+    SpawnRoster& roster = session->SpawnedCreatures;
+    uint32 i = roster.Find(creature->GetGUID());
+    if (i == SpawnRoster::NOT_FOUND)
+        return;
 
-            LOG_INFO("module", "DungeonMaster: Processing death for {} (Boss: {}, Elite: {}, LootFilled: {}, KillCredited: {})",
-                creature->GetName(), sc.IsBoss, sc.IsElite, sc.LootFilled, sc.KillCredited);
+    bool isBoss  = roster.Has(i, SPAWN_BOSS);
+    bool isElite = roster.Has(i, SPAWN_ELITE);
 
-            // ---- Loot: always fill here (OnUnitDeath fires AFTER core death processing) ----
-            if (!sc.LootFilled)
-            {
-                sc.LootFilled = true;
-                FillCreatureLoot(creature, session, sc.IsBoss);
-            }
+    // Mark dead if not already (boss-AI path via OnUnitDeath may arrive
+    // here first when creatures don't use our custom AI).
+    roster.Claim(i, SPAWN_DEAD);
 
-            // ---- Kill credit: only once ----
-            if (!sc.KillCredited)
-            {
-                sc.KillCredited = true;
-                GiveKillXP(session, sc.IsBoss, sc.IsElite);
+    LOG_INFO("module", "DungeonMaster: Processing death for {} (Boss: {}, Elite: {}, LootFilled: {}, KillCredited: {})",
+        creature->GetName(), isBoss, isElite, roster.Has(i, SPAWN_LOOT_FILLED), roster.Has(i, SPAWN_KILL_CREDITED));
 
-                if (sc.IsBoss)
-                {
-                    PendingPhaseCheck ppc;
-                    ppc.DeathPos   = { creature->GetPositionX(), creature->GetPositionY(),
-                                       creature->GetPositionZ(), creature->GetOrientation() };
-                    ppc.DeathTime  = GameTime::GetGameTime().count();
-                    ppc.OrigEntry  = creature->GetEntry();
-                    ppc.Resolved   = false;
-                    session->PendingPhaseChecks.push_back(ppc);
-
-                    LOG_INFO("module", "DungeonMaster: Boss '{}' died — deferring kill count for phase check",
-                        creature->GetName());
-                }
-                else
-                {
-                    ++session->MobsKilled;
-                    for (auto& pd : session->Players)
-                        ++pd.MobsKilled;
-                }
-            }
-            break;
+    PartyView party;
+    party.Resolve(*session);
+
+    // ---- Loot: always fill here (OnUnitDeath fires AFTER core death processing) ----
+    if (roster.Claim(i, SPAWN_LOOT_FILLED))
+        FillCreatureLoot(creature, session, party, isBoss);
+
+    // ---- Kill credit: only once ----
+    if (roster.Claim(i, SPAWN_KILL_CREDITED))
+    {
+        QueueKillXP(*session, party, isBoss, isElite);
+
+        if (isBoss)
+        {
+            PendingPhaseCheck ppc;
+            ppc.DeathPos   = { creature->GetPositionX(), creature->GetPositionY(),
+                               creature->GetPositionZ(), creature->GetOrientation() };
+            ppc.DeathTime  = GameTime::GetGameTime().count();
+            ppc.OrigEntry  = creature->GetEntry();
+            ppc.Resolved   = false;
+            session->PendingPhaseChecks.push_back(ppc);
+
+            LOG_INFO("module", "DungeonMaster: Boss '{}' died — deferring kill count for phase check",
+                creature->GetName());
+        }
+        else
+        {
+            session->CreditMobKill();
         }
     }
+    party.CommitCounters();
 
     // Completion is now handled by the phase check system in Update()
 }
 
-void DungeonMasterMgr::HandleBossDeath(Session* session)
+void DungeonMasterMgr::HandleBossDeath(Session* session, const PartyView& party)
 {
-    if (!session) return;
-    for (const auto& pd : session->Players)
-        if (Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid))
-        {
-            if (session->BossesKilled < session->TotalBosses && p->GetSession())
-            {
-                char buf[128];
-                snprintf(buf, sizeof(buf),
-                    "|cFFFFFF00[Dungeon Master]|r Boss defeated! |cFFFFFFFF%u|r remaining.",
-                    session->TotalBosses - session->BossesKilled);
-                ChatHandler(p->GetSession()).SendSysMessage(buf);
-            }
-        }
+    if (!session || session->BossesKilled >= session->TotalBosses) return;
+
+    char buf[128];
+    snprintf(buf, sizeof(buf),
+        "|cFFFFFF00[Dungeon Master]|r Boss defeated! |cFFFFFFFF%u|r remaining.",
+        session->TotalBosses - session->BossesKilled);
+    ChatBroadcast(buf).SendTo(party.Players());
 }
 
     // Called from JustDied hook — fills loot before corpse is opened
@@ -1899,67 +2017,67 @@ void DungeonMasterMgr::OnCreatureDeathHook(Creature* creature)
         if (creature->GetMapId() != session.MapId)
             continue;
 
-        for (auto& sc : session.SpawnedCreatures)
-        {
-            if (sc.Guid == creature->GetGUID())
-            {
-                if (sc.IsDead)
-                {
-                    LOG_WARN("module", "DungeonMaster: OnCreatureDeathHook - creature {} already marked as dead",
-                        creature->GetGUID().GetCounter());
-                    return;
-                }
-
-                sc.IsDead = true;
-                LOG_INFO("module", "DungeonMaster: OnCreatureDeathHook processing death for {} (Boss: {}, Elite: {})",
-                    creature->GetName(), sc.IsBoss, sc.IsElite);
-
-                // ----------------------------------------------------------
-                // IMPORTANT: Do NOT call FillCreatureLoot here!
-                // This hook fires from JustDied, which runs INSIDE
-                // Creature::setDeathState / Unit::Kill.  After JustDied
-                // returns, the core clears creature->loot and removes
-                // UNIT_DYNFLAG_LOOTABLE for creatures with no template loot
-                // table, wiping everything we added.
-                //
-                // Loot is filled in HandleCreatureDeath (OnUnitDeath hook)
-                // which fires AFTER the core's death processing completes.
-                // ----------------------------------------------------------
-
-                // Credit kill XP now (safe — doesn't depend on loot timing)
-                if (!sc.KillCredited)
-                {
-                    sc.KillCredited = true;
-                    GiveKillXP(&session, sc.IsBoss, sc.IsElite);
+        SpawnRoster& roster = session.SpawnedCreatures;
+        uint32 i = roster.Find(creature->GetGUID());
+        if (i == SpawnRoster::NOT_FOUND)
+            continue;
 
-                    if (sc.IsBoss)
-                    {
-                        PendingPhaseCheck ppc;
-                        ppc.DeathPos   = { creature->GetPositionX(), creature->GetPositionY(),
-                                           creature->GetPositionZ(), creature->GetOrientation() };
-                        ppc.DeathTime  = GameTime::GetGameTime().count();
-                        ppc.OrigEntry  = creature->GetEntry();
-                        ppc.Resolved   = false;
-                        session.PendingPhaseChecks.push_back(ppc);
-
-                        LOG_INFO("module", "DungeonMaster: Boss '{}' died — deferring kill count for phase check (entry {})",
-                            creature->GetName(), creature->GetEntry());
-                    }
-                    else
-                    {
-                        ++session.MobsKilled;
-                        for (auto& pd : session.Players)
-                            ++pd.MobsKilled;
-                    }
-                }
+        if (!roster.Claim(i, SPAWN_DEAD))
+        {
+            LOG_WARN("module", "DungeonMaster: OnCreatureDeathHook - creature {} already marked as dead",
+                creature->GetGUID().GetCounter());
+            return;
+        }
 
-                LOG_DEBUG("module", "DungeonMaster: Creature {} (entry {}) death handled via hook "
-                    "(session {}, boss={}).  Loot deferred to OnUnitDeath.",
-                    creature->GetGUID().ToString(), creature->GetEntry(),
-                    sid, sc.IsBoss);
-                return;
+        bool isBoss  = roster.Has(i, SPAWN_BOSS);
+        bool isElite = roster.Has(i, SPAWN_ELITE);
+        LOG_INFO("module", "DungeonMaster: OnCreatureDeathHook processing death for {} (Boss: {}, Elite: {})",
+            creature->GetName(), isBoss, isElite);
+
+        // ----------------------------------------------------------
+        // IMPORTANT: Do NOT call FillCreatureLoot here!
+        // This hook fires from JustDied, which runs INSIDE
+        // Creature::setDeathState / Unit::Kill.  After JustDied
+        // returns, the core clears creature->loot and removes
+        // UNIT_DYNFLAG_LOOTABLE for creatures with no template loot
+        // table, wiping everything we added.
+        //
+        // Loot is filled in HandleCreatureDeath (OnUnitDeath hook)
+        // which fires AFTER the core's death processing completes.
+        // ----------------------------------------------------------
+
+        // Queue kill XP now (safe — doesn't depend on loot timing); paid next tick
+        if (roster.Claim(i, SPAWN_KILL_CREDITED))
+        {
+            PartyView party;
+            party.Resolve(session);
+            QueueKillXP(session, party, isBoss, isElite);
+            party.CommitCounters();
+
+            if (isBoss)
+            {
+                PendingPhaseCheck ppc;
+                ppc.DeathPos   = { creature->GetPositionX(), creature->GetPositionY(),
+                                   creature->GetPositionZ(), creature->GetOrientation() };
+                ppc.DeathTime  = GameTime::GetGameTime().count();
+                ppc.OrigEntry  = creature->GetEntry();
+                ppc.Resolved   = false;
+                session.PendingPhaseChecks.push_back(ppc);
+
+                LOG_INFO("module", "DungeonMaster: Boss '{}' died — deferring kill count for phase check (entry {})",
+                    creature->GetName(), creature->GetEntry());
+            }
+            else
+            {
+                session.CreditMobKill();
             }
         }
+
+        LOG_DEBUG("module", "DungeonMaster: Creature {} (entry {}) death handled via hook "
+            "(session {}, boss={}).  Loot deferred to OnUnitDeath.",
+            creature->GetGUID().ToString(), creature->GetEntry(),
+            sid, isBoss);
+        return;
     }
 }
 
@@ -1967,8 +2085,15 @@ void DungeonMasterMgr::HandlePlayerDeath(Player* player, Session* session)
 {
     if (!player || !session) return;
 
-    if (PlayerSessionData* pd = session->GetPlayerData(player->GetGUID()))
-        ++pd->Deaths;
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        ApplyPresenceEvents();      // a resurrect still in the queue must count before the wipe check
+        if (PlayerSessionData* pd = session->GetPlayerData(player->GetGUID()))
+        {
+            session->CreditDeath(*pd);
+            session->UpdatePresence(*pd, true, false, false);
+        }
+    }
 
     // Block release-spirit; auto-rez instead
     player->SetFlag(PLAYER_FIELD_BYTES, PLAYER_FIELD_BYTE_NO_RELEASE_WINDOW);
@@ -1996,9 +2121,7 @@ void DungeonMasterMgr::HandlePlayerDeath(Player* player, Session* session)
             if (!p) continue;
             p->RemoveFlag(PLAYER_FIELD_BYTES, PLAYER_FIELD_BYTE_NO_RELEASE_WINDOW);
             if (!p->IsAlive()) { p->ResurrectPlayer(1.0f); p->SpawnCorpseBones(); }
-            if (p->GetSession())
-                ChatHandler(p->GetSession()).SendSysMessage(
-                    "|cFFFF0000[Dungeon Master]|r Total party wipe! Challenge failed.");
+            ChatBroadcast::Get(MSG_PARTY_WIPED).SendTo(p);
             p->TeleportTo(psd.ReturnMapId, psd.ReturnPosition.GetPositionX(),
                 psd.ReturnPosition.GetPositionY(), psd.ReturnPosition.GetPositionZ(),
                 psd.ReturnPosition.GetOrientation());
@@ -2006,10 +2129,7 @@ void DungeonMasterMgr::HandlePlayerDeath(Player* player, Session* session)
     }
     else
     {
-        if (player->GetSession())
-            ChatHandler(player->GetSession()).SendSysMessage(
-                "|cFFFFFF00[Dungeon Master]|r You have fallen! "
-                "You will be revived when your group leaves combat.");
+        ChatBroadcast::Get(MSG_PLAYER_FALLEN).SendTo(player);
     }
 }
 
@@ -2059,25 +2179,71 @@ void DungeonMasterMgr::DistributeRewards(Session* session)
 }
 
 
-void DungeonMasterMgr::GiveKillXP(Session* session, bool isBoss, bool isElite)
+// Eligibility and amount are decided at the kill, as when XP was paid on the
+// spot: a member who dies or levels before the next flush gets the same XP
+void DungeonMasterMgr::QueueKillXP(Session& session, const PartyView& party, bool isBoss, bool isElite)
 {
-    if (!session) return;
-
-    for (const auto& pd : session->Players)
+    uint32 maxLevel = sWorld->getIntConfig(CONFIG_MAX_PLAYER_LEVEL);
+    uint32 units    = isBoss ? 10 : isElite ? 2 : 1;
+    const std::vector<Player*>& players = party.Players();
+    for (size_t k = 0; k < players.size() && k < session.Players.size(); ++k)
     {
-        Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
-        if (!p || !p->IsAlive()) continue;
-        if (p->GetLevel() >= sWorld->getIntConfig(CONFIG_MAX_PLAYER_LEVEL)) continue;
+        Player* p = players[k];
+        if (p && p->IsAlive() && p->GetLevel() < maxLevel)
+            session.QueueKillXP(session.Players[k], ((p->GetLevel() * 5) + 45) * units);
+    }
+}
 
-        uint32 baseXP = (p->GetLevel() * 5) + 45;
+// One GiveXP and one progress line per player for everything killed since the
+// last tick, however many mobs an AoE pull dropped at once. XP queued for a
+// member who logged out before the flush is dropped, as it would have been
+// had they logged out just before the kill.
+void DungeonMasterMgr::FlushKillCredit(Session& session, const PartyView& party)
+{
+    if (!session.PendingKillXP && !session.PendingMobKills)
+        return;
 
-        float mult = 1.0f;
-        if (isBoss)       mult = 10.0f;
-        else if (isElite) mult = 2.0f;
+    uint32 maxLevel = sWorld->getIntConfig(CONFIG_MAX_PLAYER_LEVEL);
+    if (session.PendingKillXP)
+    {
+        const std::vector<Player*>& players = party.Players();
+        for (size_t k = 0; k < players.size() && k < session.Players.size(); ++k)
+        {
+            PlayerSessionData& pd = session.Players[k];
+            Player* p = players[k];
+            if (pd.PendingKillXP && p && p->GetLevel() < maxLevel)
+                p->GiveXP(pd.PendingKillXP, nullptr);
+            else if (pd.PendingKillXP && !p)
+                LOG_DEBUG("module", "DungeonMaster: Session {} — dropped {} kill XP for offline player {}",
+                    session.SessionId, pd.PendingKillXP, pd.PlayerGuid.ToString());
+            pd.PendingKillXP = 0;
+        }
+    }
 
-        uint32 xp = static_cast<uint32>(baseXP * mult);
-        p->GiveXP(xp, nullptr);
+    if (session.PendingMobKills)
+    {
+        char buf[160];
+        snprintf(buf, sizeof(buf),
+            "|cFF00FF00[Dungeon Master]|r |cFFFFFFFF%u|r %s slain, |cFFFFFFFF%u/%u|r",
+            session.PendingMobKills, session.PendingMobKills != 1 ? "enemies" : "enemy",
+            session.MobsKilled, session.TotalMobs);
+        ChatBroadcast(buf).SendTo(party.Players());
     }
+
+    session.PendingKillXP   = 0;
+    session.PendingMobKills = 0;
+}
+
+// Pays what the last tick has not, so ending a run never drops a kill
+void DungeonMasterMgr::FlushKillCredit(Session& session)
+{
+    if (!session.PendingKillXP && !session.PendingMobKills)
+        return;
+
+    PartyView party;
+    party.Resolve(session);
+    FlushKillCredit(session, party);
+    party.CommitCounters();
 }
 
 void DungeonMasterMgr::GiveGoldReward(Player* player, uint32 amount)
@@ -2303,136 +2469,15 @@ void DungeonMasterMgr::DistributeRoguelikeRewards(uint32 tier, uint8 effectiveLe
     }
 }
 
-// Armor type by class
-static uint8 GetMaxArmorSubclass(uint32 playerClass)
-{
-    switch (playerClass)
-    {
-        case 5: case 8: case 9:              return 1;  // cloth: Priest, Mage, Warlock
-        case 4: case 11:                     return 2;  // leather: Rogue, Druid
-        case 3: case 7:                      return 3;  // mail: Hunter, Shaman
-        case 1: case 2: case 6:              return 4;  // plate: Warrior, Paladin, DK
-        default:                             return 4;
-    }
-}
-
-static uint32 GetClassBitmask(uint32 playerClass)
-{
-    if (playerClass == 0 || playerClass > 11) return 0x7FF;  // all classes
-    return 1 << (playerClass - 1);
-}
-
-// Primary stat for class-based reward weighting
-// Returns: ITEM_MOD_AGILITY(3), ITEM_MOD_STRENGTH(4), ITEM_MOD_INTELLECT(5)
-static uint32 GetPrimaryStatForClass(uint32 playerClass)
-{
-    switch (playerClass)
-    {
-        case 1:  return 4;  // Warrior  -> STR
-        case 2:  return 4;  // Paladin  -> STR
-        case 3:  return 3;  // Hunter   -> AGI
-        case 4:  return 3;  // Rogue    -> AGI
-        case 5:  return 5;  // Priest   -> INT
-        case 6:  return 4;  // DK       -> STR
-        case 7:  return 5;  // Shaman   -> INT
-        case 8:  return 5;  // Mage     -> INT
-        case 9:  return 5;  // Warlock  -> INT
-        case 11: return 3;  // Druid    -> AGI
-        default: return 4;
-    }
-}
-
-// Score item stat alignment with player class (0.0 = bad, 1.0 = perfect match)
-static float ScoreItemForClass(uint32 itemEntry, uint32 playerClass)
-{
-    const ItemTemplate* proto = sObjectMgr->GetItemTemplate(itemEntry);
-    if (!proto) return 0.0f;
-
-    uint32 primaryStat = GetPrimaryStatForClass(playerClass);
-    float totalStats = 0.0f;
-    float primaryTotal = 0.0f;
-
-    for (uint8 i = 0; i < MAX_ITEM_PROTO_STATS; ++i)
-    {
-        int32 val = proto->ItemStat[i].ItemStatValue;
-        uint32 type = proto->ItemStat[i].ItemStatType;
-        if (val <= 0) continue;
-
-        totalStats += static_cast<float>(val);
-        if (type == primaryStat)
-            primaryTotal += static_cast<float>(val);
-    }
-
-    if (totalStats <= 0.0f) return 0.5f;  // No stats (trinket, etc.) = neutral
-    return primaryTotal / totalStats;
-}
-
 uint32 DungeonMasterMgr::SelectRewardItem(uint8 level, uint8 quality, uint32 playerClass)
 {
-    uint8  maxArmor   = GetMaxArmorSubclass(playerClass);
-    uint32 classMask  = GetClassBitmask(playerClass);
-
-    // Try progressively wider level windows, but always prefer closer to player level
-    struct { uint8 below; uint8 above; } windows[] = {
-        { 3, 0 },    // strict: [level-3, level]
-        { 8, 0 },    // medium: [level-8, level]
-        { 15, 0 },   // wide: [level-15, level]
-        { 25, 0 },   // very wide: [level-25, level]
-        { 80, 0 },   // last resort: [1, level] (never items above player level)
-    };
-
-    for (const auto& win : windows)
+    ItemPick pick = PickRewardItem(_rewardItems, level, quality, playerClass, ThreadRng());
+    if (pick.Entry)
     {
-        std::vector<uint32> cands;
-        uint8 lo = (level > win.below) ? (level - win.below) : 1;
-        uint8 hi = level;  // Never give items above player level
-
-        for (const auto& ri : _rewardItems)
-        {
-            // Quality filter
-            if (ri.Quality != quality) continue;
-
-            // Level filter: item RequiredLevel must be within window
-            if (ri.MinLevel < lo || ri.MinLevel > hi) continue;
-
-            // Class restriction: AllowableClass bitmask check
-            if (ri.AllowableClass != -1 && !(ri.AllowableClass & classMask))
-                continue;
-
-            // Armor subclass: player can only wear their class's max armor or lower
-            if (ri.Class == 4 && ri.SubClass > 0 && ri.SubClass <= 4)
-            {
-                if (ri.SubClass > maxArmor) continue;
-            }
-
-            cands.push_back(ri.Entry);
-        }
-
-        if (!cands.empty())
-        {
-            LOG_INFO("module", "DungeonMaster: SelectRewardItem(level={}, quality={}, class={}) "
-                "-> {} candidates in window [{}, {}]",
-                level, quality, playerClass, cands.size(), lo, hi);
-
-            // 75% chance: bias toward items with matching primary stat
-            if (cands.size() > 3 && playerClass > 0 && RandInt<uint32>(1, 100) <= 75)
-            {
-                std::vector<std::pair<uint32, float>> scored;
-                scored.reserve(cands.size());
-                for (uint32 entry : cands)
-                    scored.push_back({entry, ScoreItemForClass(entry, playerClass)});
-
-                std::sort(scored.begin(), scored.end(),
-                    [](const auto& a, const auto& b) { return a.second > b.second; });
-
-                // Pick from the top third (at least 3 items)
-                size_t topN = std::max<size_t>(3, scored.size() / 3);
-                return scored[RandInt<size_t>(0, topN - 1)].first;
-            }
-
-            // 25% chance: purely random from valid pool
-            return cands[RandInt<size_t>(0, cands.size() - 1)];
-        }
+        LOG_INFO("module", "DungeonMaster: SelectRewardItem(level={}, quality={}, class={}) "
+            "-> {} candidates in window [{}, {}]",
+            level, quality, playerClass, pick.Candidates, pick.Lo, pick.Hi);
+        return pick.Entry;
     }
 
     LOG_WARN("module", "DungeonMaster: SelectRewardItem(level={}, quality={}, class={}) "
@@ -2445,82 +2490,13 @@ uint32 DungeonMasterMgr::SelectRewardItem(uint8 level, uint8 quality, uint32 pla
 uint32 DungeonMasterMgr::SelectLootItem(uint8 level, uint8 minQuality, uint8 maxQuality,
                                         bool equipmentOnly, uint32 playerClass)
 {
-    // Expected ItemLevel range for this level
-    uint16 expectedMaxIlvl = static_cast<uint16>(level) * 2 + 10;
-
-    uint8  maxArmor  = playerClass ? GetMaxArmorSubclass(playerClass) : 4;
-    uint32 classMask = playerClass ? GetClassBitmask(playerClass) : 0x7FF;
-
-    // Progressively widen level windows, always preferring items closer to player level
-    struct { uint8 below; uint8 above; } windows[] = {
-        { 3, 1 },   // strict: RequiredLevel in [level-3, level+1]
-        { 5, 2 },   // medium
-        { 8, 3 },   // wide
-        { 15, 5 },  // very wide
-        { 25, 8 },  // extremely wide (last resort)
-    };
-
-    for (const auto& win : windows)
+    ItemPick pick = PickLootItem(_lootPool, level, minQuality, maxQuality, equipmentOnly, playerClass, ThreadRng());
+    if (pick.Entry)
     {
-        uint8 lo = (level > win.below) ? (level - win.below) : 0;
-        uint8 hi = std::min<uint16>(level + win.above, 83);
-
-        std::vector<uint32> cands;
-        for (const auto& li : _lootPool)
-        {
-            if (li.Quality < minQuality || li.Quality > maxQuality) continue;
-            if (equipmentOnly && li.ItemClass != 2 && li.ItemClass != 4) continue;
-
-            // Level filter for items with RequiredLevel > 0
-            if (li.MinLevel > 0)
-            {
-                if (li.MinLevel < lo || li.MinLevel > hi) continue;
-            }
-            else
-            {
-                // RequiredLevel = 0: use ItemLevel as a sanity check
-                if (li.ItemLevel > expectedMaxIlvl) continue;
-            }
-
-            // Class restriction for equipment items
-            if (equipmentOnly || (li.ItemClass == 2 || li.ItemClass == 4))
-            {
-                // AllowableClass bitmask check
-                if (li.AllowableClass != -1 && !(li.AllowableClass & classMask))
-                    continue;
-
-                // Armor subclass check (only for armor, not weapons)
-                if (li.ItemClass == 4 && li.SubClass > 0 && li.SubClass <= 4)
-                    if (li.SubClass > maxArmor) continue;
-            }
-
-            cands.push_back(li.Entry);
-        }
-
-        if (!cands.empty())
-        {
-            LOG_INFO("module", "DungeonMaster: SelectLootItem(level={}, quality={}-{}, eqOnly={}, class={}) "
-                "-> {} candidates in window [{}, {}]",
-                level, minQuality, maxQuality, equipmentOnly, playerClass, cands.size(), lo, hi);
-
-            // Bias equipment loot toward matching primary stat (75% chance)
-            if (equipmentOnly && playerClass > 0 && cands.size() > 3
-                && RandInt<uint32>(1, 100) <= 75)
-            {
-                std::vector<std::pair<uint32, float>> scored;
-                scored.reserve(cands.size());
-                for (uint32 entry : cands)
-                    scored.push_back({entry, ScoreItemForClass(entry, playerClass)});
-
-                std::sort(scored.begin(), scored.end(),
-                    [](const auto& a, const auto& b) { return a.second > b.second; });
-
-                size_t topN = std::max<size_t>(3, scored.size() / 3);
-                return scored[RandInt<size_t>(0, topN - 1)].first;
-            }
-
-            return cands[RandInt<size_t>(0, cands.size() - 1)];
-        }
+        LOG_INFO("module", "DungeonMaster: SelectLootItem(level={}, quality={}-{}, eqOnly={}, class={}) "
+            "-> {} candidates in window [{}, {}]",
+            level, minQuality, maxQuality, equipmentOnly, playerClass, pick.Candidates, pick.Lo, pick.Hi);
+        return pick.Entry;
     }
 
     LOG_WARN("module", "DungeonMaster: SelectLootItem(level={}, quality={}-{}, eqOnly={}, class={}) "
@@ -2531,7 +2507,7 @@ uint32 DungeonMasterMgr::SelectLootItem(uint8 level, uint8 minQuality, uint8 max
 }
 
 
-void DungeonMasterMgr::FillCreatureLoot(Creature* creature, Session* session, bool isBoss)
+void DungeonMasterMgr::FillCreatureLoot(Creature* creature, Session* session, const PartyView& party, bool isBoss)
 {
     if (!creature || !session) return;
 
@@ -2542,24 +2518,19 @@ void DungeonMasterMgr::FillCreatureLoot(Creature* creature, Session* session, bo
 
     // Pick a random party member's class for loot filtering
     uint32 lootClass = 0;
-    if (!session->Players.empty())
+    const std::vector<Player*>& members = party.Players();
+    if (!members.empty())
     {
         // Try to pick a random alive player's class
         std::vector<uint32> classes;
-        for (const auto& pd : session->Players)
-        {
-            Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
+        for (Player* p : members)
             if (p && p->IsAlive())
                 classes.push_back(p->getClass());
-        }
         if (classes.empty())
         {
             // All dead? Just pick from any player
-            for (const auto& pd : session->Players)
-            {
-                Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
+            for (Player* p : members)
                 if (p) { classes.push_back(p->getClass()); break; }
-            }
         }
         if (!classes.empty())
             lootClass = classes[RandInt<size_t>(0, classes.size() - 1)];
@@ -2599,17 +2570,10 @@ void DungeonMasterMgr::FillCreatureLoot(Creature* creature, Session* session, bo
     }
     else
     {
-        bool isElite = false;
-        bool isRare  = false;
-        for (const auto& sc : session->SpawnedCreatures)
-        {
-            if (sc.Guid == creature->GetGUID())
-            {
-                isElite = sc.IsElite;
-                isRare  = sc.IsRare;
-                break;
-            }
-        }
+        const SpawnRoster& roster = session->SpawnedCreatures;
+        uint32 idx   = roster.Find(creature->GetGUID());
+        bool isElite = idx != SpawnRoster::NOT_FOUND && roster.Has(idx, SPAWN_ELITE);
+        bool isRare  = idx != SpawnRoster::NOT_FOUND && roster.Has(idx, SPAWN_RARE);
 
         if (isRare)
         {
@@ -2645,9 +2609,8 @@ void DungeonMasterMgr::FillCreatureLoot(Creature* creature, Session* session, bo
     loot.loot_type = LOOT_CORPSE;
     Player* looter = nullptr;
     Group*  group  = nullptr;
-    for (const auto& pd : session->Players)
+    for (Player* p : members)
     {
-        Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
         if (p && p->IsInWorld() && p->GetGroup())
         {
             looter = p;
@@ -2677,12 +2640,9 @@ void DungeonMasterMgr::FillCreatureLoot(Creature* creature, Session* session, bo
         group->GroupLoot(&loot, creature);
 
         // Force dynamic flag update to all session players so they see the lootable corpse
-        for (const auto& pd : session->Players)
-        {
-            Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
+        for (Player* p : members)
             if (p && p->IsInWorld() && p->GetMapId() == session->MapId)
                 creature->SendUpdateToPlayer(p);
-        }
 
         LOG_INFO("module", "DungeonMaster: Group loot triggered for {} — {} items, "
             "lootMethod={}, threshold={}, groupSize={}",
@@ -2716,16 +2676,19 @@ void DungeonMasterMgr::EndSession(uint32 sessionId, bool success)
             LOG_INFO("module", "DungeonMaster: EndSession {} — roguelike run {}, delegating to RoguelikeMgr.",
                 sessionId, roguelikeRunId);
 
+            FlushKillCredit(s);
+
             // Persist stats while session is still alive
             UpdatePlayerStatsFromSession(s, success);
 
             // Clean up mappings
             uint32 savedInstanceId = s.InstanceId;
             if (savedInstanceId != 0)
-                _instanceToSession.erase(savedInstanceId);
+                ReleaseInstance(savedInstanceId);
             for (const auto& pd : s.Players)
-                _playerToSession.erase(pd.PlayerGuid);
+                UntrackSessionPlayer(pd.PlayerGuid);
 
+            ReleaseCreatureBudget(s);
             _activeSessions.erase(it);
         }
     } // lock released
@@ -2746,12 +2709,11 @@ void DungeonMasterMgr::EndSession(uint32 sessionId, bool success)
     LOG_INFO("module", "DungeonMaster: EndSession {} — success={}, state={}, players={}",
         sessionId, success, static_cast<int>(s.State), s.Players.size());
 
+    FlushKillCredit(s);
+
+    const ChatBroadcast& outcome = ChatBroadcast::Get(success ? MSG_CHALLENGE_COMPLETE : MSG_CHALLENGE_ENDED);
     for (const auto& pd : s.Players)
-        if (Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid))
-            if (p->GetSession())
-                ChatHandler(p->GetSession()).SendSysMessage(
-                    success ? "|cFF00FF00[Dungeon Master]|r Challenge complete! Distributing rewards..."
-                            : "|cFFFF0000[Dungeon Master]|r Challenge ended. No rewards given.");
+        outcome.SendTo(ObjectAccessor::FindPlayer(pd.PlayerGuid));
 
     if (success && s.State == SessionState::Completed)
         DistributeRewards(&s);
@@ -2767,18 +2729,59 @@ void DungeonMasterMgr::EndSession(uint32 sessionId, bool success)
     CleanupSession(s);
 
     for (const auto& pd : s.Players)
+    {
         SetCooldown(pd.PlayerGuid);
+        ForgetCheckpoint(pd.PlayerGuid);
+    }
 
     if (savedInstanceId != 0)
-        _instanceToSession.erase(savedInstanceId);
+        ReleaseInstance(savedInstanceId);
     for (const auto& pd : s.Players)
-        _playerToSession.erase(pd.PlayerGuid);
+        UntrackSessionPlayer(pd.PlayerGuid);
 
+    ReleaseCreatureBudget(s);
     _activeSessions.erase(it);
 }
 
 void DungeonMasterMgr::AbandonSession(uint32 id) { EndSession(id, false); }
 
+// ---- Session membership filter ----
+// Counting filter over the low bits of the player GUID. Zero means the player
+// is certainly in no session; non-zero falls through to the locked lookup.
+
+void DungeonMasterMgr::TrackSessionPlayer(ObjectGuid guid, uint32 sessionId)
+{
+    if (_playerToSession.insert_or_assign(guid, sessionId).second)
+        _sessionPlayerFilter[guid.GetCounter() & (SESSION_FILTER_SIZE - 1)].fetch_add(1, std::memory_order_release);
+}
+
+void DungeonMasterMgr::UntrackSessionPlayer(ObjectGuid guid)
+{
+    if (_playerToSession.erase(guid))
+        _sessionPlayerFilter[guid.GetCounter() & (SESSION_FILTER_SIZE - 1)].fetch_sub(1, std::memory_order_release);
+}
+
+bool DungeonMasterMgr::MayBeInSession(ObjectGuid guid) const
+{
+    return _sessionPlayerFilter[guid.GetCounter() & (SESSION_FILTER_SIZE - 1)].load(std::memory_order_acquire) != 0;
+}
+
+// Drops everything keyed by a finished session's instance. The creatures
+// themselves stay with the map, which unloads once the party is out.
+void DungeonMasterMgr::ReleaseInstance(uint32 instanceId)
+{
+    _instanceToSession.erase(instanceId);
+    _instanceCreatureGuids.erase(instanceId);
+    sDMAggro->ClearInstance(instanceId);
+}
+
+void DungeonMasterMgr::ReleaseCreatureBudget(Session& session)
+{
+    if (session.BudgetCharge)
+        _liveBudgetUsed.fetch_sub(session.BudgetCharge, std::memory_order_relaxed);
+    session.BudgetCharge = 0;
+}
+
 
 void DungeonMasterMgr::CleanupRoguelikeSession(uint32 sessionId, bool success)
 {
@@ -2788,6 +2791,7 @@ void DungeonMasterMgr::CleanupRoguelikeSession(uint32 sessionId, bool success)
 
     Session& s = it->second;
 
+    FlushKillCredit(s);
 
     UpdatePlayerStatsFromSession(s, success);
     if (success && s.State == SessionState::Completed)
@@ -2798,10 +2802,11 @@ void DungeonMasterMgr::CleanupRoguelikeSession(uint32 sessionId, bool success)
 
     // Clean up mappings (no teleport/cooldowns for roguelike)
     if (savedInstanceId != 0)
-        _instanceToSession.erase(savedInstanceId);
+        ReleaseInstance(savedInstanceId);
     for (const auto& pd : s.Players)
-        _playerToSession.erase(pd.PlayerGuid);
+        UntrackSessionPlayer(pd.PlayerGuid);
 
+    ReleaseCreatureBudget(s);
     _activeSessions.erase(it);
 
     LOG_DEBUG("module", "DungeonMaster: Roguelike session {} cleaned up (success={}).",
@@ -2813,32 +2818,22 @@ void DungeonMasterMgr::CleanupSession(Session& s) { s.InstanceId = 0; }
 // Cooldowns
 bool DungeonMasterMgr::IsOnCooldown(ObjectGuid g) const
 {
-    std::lock_guard<std::mutex> lock(_cooldownMutex);
-    auto it = _cooldowns.find(g);
-    return it != _cooldowns.end()
-        && GameTime::GetGameTime().count() < static_cast<time_t>(it->second);
+    return _cooldowns.IsActive(g, GameTime::GetGameTime().count());
 }
 
 void DungeonMasterMgr::SetCooldown(ObjectGuid g)
 {
-    std::lock_guard<std::mutex> lock(_cooldownMutex);
-    _cooldowns[g] = GameTime::GetGameTime().count() + sDMConfig->GetCooldownMinutes() * 60;
+    _cooldowns.Set(g, GameTime::GetGameTime().count() + sDMConfig->GetCooldownMinutes() * 60);
 }
 
 void DungeonMasterMgr::ClearCooldown(ObjectGuid g)
 {
-    std::lock_guard<std::mutex> lock(_cooldownMutex);
-    _cooldowns.erase(g);
+    _cooldowns.Clear(g);
 }
 
 uint32 DungeonMasterMgr::GetRemainingCooldown(ObjectGuid g) const
 {
-    std::lock_guard<std::mutex> lock(_cooldownMutex);
-    auto it = _cooldowns.find(g);
-    if (it == _cooldowns.end()) return 0;
-    time_t now = GameTime::GetGameTime().count();
-    return (now < static_cast<time_t>(it->second))
-        ? static_cast<uint32>(it->second - now) : 0;
+    return _cooldowns.GetRemaining(g, GameTime::GetGameTime().count());
 }
 
 bool DungeonMasterMgr::CanCreateNewSession() const
@@ -2848,73 +2843,220 @@ bool DungeonMasterMgr::CanCreateNewSession() const
 
 // Player Statistics & Leaderboard
 
-void DungeonMasterMgr::LoadAllPlayerStats()
-{
-    std::lock_guard<std::mutex> lock(_statsMutex);
-    _playerStats.clear();
+// ---- Player stats cache ----
 
-    QueryResult result = CharacterDatabase.Query(
-        "SELECT guid, total_runs, completed_runs, failed_runs, "
+std::string NormalStatsTraits::SelectQuery(uint32 guidLow)
+{
+    char query[256];
+    snprintf(query, sizeof(query),
+        "SELECT total_runs, completed_runs, failed_runs, "
         "total_mobs_killed, total_bosses_killed, total_deaths, fastest_clear "
-        "FROM dm_player_stats");
+        "FROM dm_player_stats WHERE guid = %u", guidLow);
+    return query;
+}
 
-    if (!result)
-    {
-        LOG_INFO("module", "DungeonMaster: No player stats found (table may be empty or missing).");
+void NormalStatsTraits::Read(Field* f, PlayerStats& ps)
+{
+    ps.TotalRuns         = f[0].Get<uint32>();
+    ps.CompletedRuns     = f[1].Get<uint32>();
+    ps.FailedRuns        = f[2].Get<uint32>();
+    ps.TotalMobsKilled   = f[3].Get<uint32>();
+    ps.TotalBossesKilled = f[4].Get<uint32>();
+    ps.TotalDeaths       = f[5].Get<uint32>();
+    ps.FastestClear      = f[6].Get<uint32>();
+}
+
+std::string NormalStatsTraits::ReplaceQuery(uint32 guidLow, const PlayerStats& ps)
+{
+    char query[512];
+    snprintf(query, sizeof(query),
+        "REPLACE INTO dm_player_stats "
+        "(guid, total_runs, completed_runs, failed_runs, "
+        "total_mobs_killed, total_bosses_killed, total_deaths, fastest_clear) "
+        "VALUES (%u, %u, %u, %u, %u, %u, %u, %u)",
+        guidLow, ps.TotalRuns, ps.CompletedRuns, ps.FailedRuns,
+        ps.TotalMobsKilled, ps.TotalBossesKilled, ps.TotalDeaths, ps.FastestClear);
+    return query;
+}
+
+std::string NormalStatsTraits::MergeQuery(uint32 guidLow, const PlayerStats& d)
+{
+    char query[1024];
+    snprintf(query, sizeof(query),
+        "INSERT INTO dm_player_stats "
+        "(guid, total_runs, completed_runs, failed_runs, "
+        "total_mobs_killed, total_bosses_killed, total_deaths, fastest_clear) "
+        "VALUES (%u, %u, %u, %u, %u, %u, %u, %u) "
+        "ON DUPLICATE KEY UPDATE "
+        "total_runs = total_runs + %u, completed_runs = completed_runs + %u, "
+        "failed_runs = failed_runs + %u, total_mobs_killed = total_mobs_killed + %u, "
+        "total_bosses_killed = total_bosses_killed + %u, total_deaths = total_deaths + %u, "
+        "fastest_clear = IF(%u > 0 AND (fastest_clear = 0 OR %u < fastest_clear), %u, fastest_clear)",
+        guidLow, d.TotalRuns, d.CompletedRuns, d.FailedRuns,
+        d.TotalMobsKilled, d.TotalBossesKilled, d.TotalDeaths, d.FastestClear,
+        d.TotalRuns, d.CompletedRuns, d.FailedRuns,
+        d.TotalMobsKilled, d.TotalBossesKilled, d.TotalDeaths,
+        d.FastestClear, d.FastestClear, d.FastestClear);
+    return query;
+}
+
+void NormalStatsTraits::Merge(PlayerStats& ps, const PlayerStats& d)
+{
+    ps.TotalRuns         += d.TotalRuns;
+    ps.CompletedRuns     += d.CompletedRuns;
+    ps.FailedRuns        += d.FailedRuns;
+    ps.TotalMobsKilled   += d.TotalMobsKilled;
+    ps.TotalBossesKilled += d.TotalBossesKilled;
+    ps.TotalDeaths       += d.TotalDeaths;
+    if (d.FastestClear > 0 && (ps.FastestClear == 0 || d.FastestClear < ps.FastestClear))
+        ps.FastestClear = d.FastestClear;
+}
+
+void DungeonMasterMgr::OnPlayerLogin(ObjectGuid guid)
+{
+    _playerStats.Load(guid.GetCounter());
+}
+
+void DungeonMasterMgr::OnPlayerLogout(ObjectGuid guid)
+{
+    _playerStats.SetOffline(guid.GetCounter());
+}
+
+void DungeonMasterMgr::QueuePlayerPresence(Player* player, bool online, bool alive, bool inCombat)
+{
+    if (!player || !MayBeInSession(player->GetGUID()))
         return;
+
+    std::lock_guard<std::mutex> lock(_presenceMutex);
+    _presenceEvents.push_back({ player->GetGUID(), online, alive, inCombat });
+}
+
+// Applied in arrival order, so the latest report for a player wins
+void DungeonMasterMgr::ApplyPresenceEvents()
+{
+    std::vector<PresenceEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(_presenceMutex);
+        if (_presenceEvents.empty())
+            return;
+        events.swap(_presenceEvents);
     }
 
-    uint32 count = 0;
-    do
+    for (const PresenceEvent& ev : events)
     {
-        Field* f = result->Fetch();
-        uint32 guidLow = f[0].Get<uint32>();
-
-        PlayerStats ps;
-        ps.TotalRuns        = f[1].Get<uint32>();
-        ps.CompletedRuns    = f[2].Get<uint32>();
-        ps.FailedRuns       = f[3].Get<uint32>();
-        ps.TotalMobsKilled  = f[4].Get<uint32>();
-        ps.TotalBossesKilled = f[5].Get<uint32>();
-        ps.TotalDeaths      = f[6].Get<uint32>();
-        ps.FastestClear     = f[7].Get<uint32>();
-
-        _playerStats[guidLow] = ps;
-        ++count;
-    } while (result->NextRow());
+        auto pit = _playerToSession.find(ev.Guid);
+        if (pit == _playerToSession.end())
+            continue;
+        auto sit = _activeSessions.find(pit->second);
+        if (sit == _activeSessions.end())
+            continue;
+        if (PlayerSessionData* pd = sit->second.GetPlayerData(ev.Guid))
+            sit->second.UpdatePresence(*pd, ev.Online, ev.Alive, ev.InCombat);
+    }
+}
+
+// Sessions are snapshotted under the session lock; run state is added by
+// RoguelikeMgr afterwards so the two managers' locks never nest here
+void DungeonMasterMgr::WriteCheckpoints()
+{
+    std::vector<PlayerCheckpoint> rows;
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        for (const auto& [sid, s] : _activeSessions)
+        {
+            // Return positions are only taken when the party is teleported in
+            if (s.State == SessionState::None || s.State == SessionState::Preparing)
+                continue;
 
-    LOG_INFO("module", "DungeonMaster: Loaded stats for {} players.", count);
+            std::string deadMask = CheckpointStore::EncodeDeadMask(s.SpawnedCreatures);
+            for (const auto& pd : s.Players)
+            {
+                PlayerCheckpoint cp;
+                cp.Guid         = pd.PlayerGuid.GetCounter();
+                cp.LeaderGuid   = s.LeaderGuid.GetCounter();
+                cp.MapId        = s.MapId;
+                cp.InstanceId   = s.InstanceId;
+                cp.DifficultyId = s.DifficultyId;
+                cp.Seed         = s.Seed;
+                cp.Creatures    = static_cast<uint32>(s.SpawnedCreatures.size());
+                cp.DeadMask     = deadMask;
+                cp.RunId        = s.RoguelikeRunId;
+                cp.ReturnMapId  = pd.ReturnMapId;
+                cp.ReturnPos    = pd.ReturnPosition;
+                rows.push_back(std::move(cp));
+            }
+        }
+    }
+
+    sRoguelikeMgr->AppendRunCheckpoints(rows);
+    _checkpoints.Write(rows);
 }
 
-PlayerStats DungeonMasterMgr::GetPlayerStats(ObjectGuid guid) const
+void DungeonMasterMgr::ForgetCheckpoint(ObjectGuid g)
 {
-    std::lock_guard<std::mutex> lock(_statsMutex);
-    uint32 guidLow = guid.GetCounter();
-    auto it = _playerStats.find(guidLow);
-    if (it != _playerStats.end())
-        return it->second;
-    return {};
+    _checkpoints.Forget(g.GetCounter());
 }
 
-void DungeonMasterMgr::SavePlayerStats(uint32 guidLow)
+// The instance and its summons do not survive a restart, so the run cannot be
+// resumed: the player is revived and sent back where it started, no cooldown
+// is charged, and a leader gets the population seed back for .dm replay.
+void DungeonMasterMgr::RecoverPlayer(Player* player)
 {
-    PlayerStats ps;
+    PlayerCheckpoint cp;
+    if (!player || !_checkpoints.TakeRecovery(player->GetGUID().GetCounter(), cp))
+        return;
+
+    player->RemoveFlag(PLAYER_FIELD_BYTES, PLAYER_FIELD_BYTE_NO_RELEASE_WINDOW);
+    if (!player->IsAlive())
     {
-        std::lock_guard<std::mutex> lock(_statsMutex);
-        auto it = _playerStats.find(guidLow);
-        if (it == _playerStats.end()) return;
-        ps = it->second;
+        player->ResurrectPlayer(1.0f);
+        player->SpawnCorpseBones();
     }
+    if (cp.Tier)
+        sRoguelikeMgr->RemoveBuffStacks(player, 0);
 
-    char query[512];
-    snprintf(query, sizeof(query),
-        "REPLACE INTO dm_player_stats "
-        "(guid, total_runs, completed_runs, failed_runs, "
-        "total_mobs_killed, total_bosses_killed, total_deaths, fastest_clear) "
-        "VALUES (%u, %u, %u, %u, %u, %u, %u, %u)",
-        guidLow, ps.TotalRuns, ps.CompletedRuns, ps.FailedRuns,
-        ps.TotalMobsKilled, ps.TotalBossesKilled, ps.TotalDeaths, ps.FastestClear);
-    CharacterDatabase.Execute(query);
+    if (cp.ReturnMapId != 0 || cp.ReturnPos.GetPositionX() != 0.0f)
+        player->TeleportTo(cp.ReturnMapId, cp.ReturnPos.GetPositionX(), cp.ReturnPos.GetPositionY(),
+            cp.ReturnPos.GetPositionZ(), cp.ReturnPos.GetOrientation());
+    else
+        player->TeleportTo(player->m_homebindMapId, player->m_homebindX, player->m_homebindY,
+            player->m_homebindZ, player->GetOrientation());
+
+    ClearCooldown(player->GetGUID());
+    bool leader = cp.Seed != 0 && cp.LeaderGuid == cp.Guid;
+    if (leader)
+        SetReplaySeed(player->GetGUID(), cp.Seed);
+
+    const DungeonInfo* dg = sDMConfig->GetDungeon(cp.MapId);
+    char buf[256];
+    if (cp.Tier)
+        snprintf(buf, sizeof(buf),
+            "|cFFFFFF00[Dungeon Master]|r Your roguelike run (tier |cFFFFFFFF%u|r) was interrupted "
+            "by a server restart. You have been returned and no cooldown was applied.",
+            cp.Tier);
+    else
+        snprintf(buf, sizeof(buf),
+            "|cFFFFFF00[Dungeon Master]|r Your challenge in |cFFFFFFFF%s|r was interrupted by a server "
+            "restart (%u/%u enemies down). You have been returned and no cooldown was applied.",
+            dg ? dg->Name.c_str() : "a dungeon", cp.CountDead(), cp.Creatures);
+    ChatBroadcast(buf).SendTo(player);
+    if (leader && !cp.Tier)
+        ChatBroadcast("|cFFFFFF00[Dungeon Master]|r Your next challenge will use the same layout.").SendTo(player);
+
+    LOG_INFO("module", "DungeonMaster: Recovered {} from an interrupted run (map {}, instance {}, seed {}, tier {}, "
+        "{}/{} dead, affixes [{}])", player->GetName(), cp.MapId, cp.InstanceId, cp.Seed, cp.Tier,
+        cp.CountDead(), cp.Creatures, cp.Affixes);
+}
+
+void DungeonMasterMgr::FlushPlayerStats()
+{
+    _playerStats.Flush();
+    _cooldowns.Flush();
+}
+
+PlayerStats DungeonMasterMgr::GetPlayerStats(ObjectGuid guid) const
+{
+    return _playerStats.Get(guid.GetCounter());
 }
 
 void DungeonMasterMgr::UpdatePlayerStatsFromSession(const Session& session, bool success)
@@ -2925,29 +3067,24 @@ void DungeonMasterMgr::UpdatePlayerStatsFromSession(const Session& session, bool
     else
         clearTime = static_cast<uint32>(GameTime::GetGameTime().count() - session.StartTime);
 
+    // Applied as a delta; persisted by the periodic write-behind flush
     for (const auto& pd : session.Players)
     {
-        uint32 guidLow = pd.PlayerGuid.GetCounter();
-
+        PlayerStats delta;
+        delta.TotalRuns = 1;
+        if (success)
         {
-            std::lock_guard<std::mutex> lock(_statsMutex);
-            auto& ps = _playerStats[guidLow];
-            ps.TotalRuns++;
-            if (success)
-            {
-                ps.CompletedRuns++;
-                if (ps.FastestClear == 0 || clearTime < ps.FastestClear)
-                    ps.FastestClear = clearTime;
-            }
-            else
-                ps.FailedRuns++;
-
-            ps.TotalMobsKilled   += pd.MobsKilled;
-            ps.TotalBossesKilled += pd.BossesKilled;
-            ps.TotalDeaths       += pd.Deaths;
+            delta.CompletedRuns = 1;
+            delta.FastestClear  = clearTime;
         }
+        else
+            delta.FailedRuns = 1;
 
-        SavePlayerStats(guidLow);
+        delta.TotalMobsKilled   = pd.MobsKilled;
+        delta.TotalBossesKilled = pd.BossesKilled;
+        delta.TotalDeaths       = pd.Deaths;
+
+        _playerStats.Apply(pd.PlayerGuid.GetCounter(), delta);
     }
 }
 
@@ -2967,14 +3104,10 @@ void DungeonMasterMgr::SaveLeaderboardEntry(const Session& session)
 
     uint8 partySize = static_cast<uint8>(session.Players.size());
 
-    // Aggregate kills/deaths across all participants
-    uint32 totalMobs = 0, totalBosses = 0, totalDeaths = 0;
-    for (const auto& pd : session.Players)
-    {
-        totalMobs   += pd.MobsKilled;
-        totalBosses += pd.BossesKilled;
-        totalDeaths += pd.Deaths;
-    }
+    // Kills/deaths across all participants, summed as they were credited
+    uint32 totalMobs   = session.PartyMobKills;
+    uint32 totalBosses = session.PartyBossKills;
+    uint32 totalDeaths = session.PartyDeaths;
 
     std::string safeName = leaderName;
     size_t pos = 0;
@@ -2996,26 +3129,85 @@ void DungeonMasterMgr::SaveLeaderboardEntry(const Session& session)
         static_cast<uint32>(session.EffectiveLevel),
         totalMobs, totalBosses, totalDeaths);
     CharacterDatabase.Execute(query);
+
+    // The row id is assigned asynchronously; the cache never needs it
+    LeaderboardEntry e;
+    e.Guid           = session.LeaderGuid.GetCounter();
+    e.CharName       = leaderName;
+    e.MapId          = session.MapId;
+    e.DifficultyId   = session.DifficultyId;
+    e.ClearTime      = clearTime;
+    e.PartySize      = partySize;
+    e.Scaled         = session.ScaleToParty;
+    e.EffectiveLevel = session.EffectiveLevel;
+    e.MobsKilled     = totalMobs;
+    e.BossesKilled   = totalBosses;
+    e.Deaths         = totalDeaths;
+    CacheLeaderboardEntry(e);
+}
+
+// ---- Leaderboard cache ----
+// Boards are kept sorted by clear time and capped at LEADERBOARD_CACHE_SIZE.
+// A new entry goes after existing ties so the earlier clear keeps its place.
+
+static bool InsertTopN(std::vector<LeaderboardEntry>& board, const LeaderboardEntry& e, size_t cap)
+{
+    auto it = std::upper_bound(board.begin(), board.end(), e,
+        [](const LeaderboardEntry& a, const LeaderboardEntry& b) { return a.ClearTime < b.ClearTime; });
+    if (static_cast<size_t>(it - board.begin()) >= cap)
+        return false;
+
+    board.insert(it, e);
+    if (board.size() > cap)
+        board.pop_back();
+    return true;
 }
 
-std::vector<LeaderboardEntry> DungeonMasterMgr::GetLeaderboard(
-    uint32 mapId, uint32 difficultyId, uint32 limit) const
+static std::vector<LeaderboardEntry> CopyTopN(const std::vector<LeaderboardEntry>& board, uint32 limit)
 {
-    std::vector<LeaderboardEntry> entries;
+    size_t n = std::min<size_t>(board.size(), limit);
+    return std::vector<LeaderboardEntry>(board.begin(), board.begin() + n);
+}
 
-    char query[512];
+// A leader's fastest clear across all boards, 0 if they have none
+static uint32 OverallBest(const std::map<std::pair<uint32, uint32>, uint32>& bests)
+{
+    uint32 overall = 0;
+    for (const auto& [board, clearTime] : bests)
+        if (clearTime && (overall == 0 || clearTime < overall))
+            overall = clearTime;
+    return overall;
+}
+
+void DungeonMasterMgr::LoadLeaderboards()
+{
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    _mapLeaderboards.clear();
+    _overallLeaderboard.clear();
+    _boardClearTimes.clear();
+    _overallClearTimes.clear();
+    _personalBests.clear();
+
+    // Only the top N of each (map, difficulty) can ever be shown, and the
+    // overall top N is necessarily a subset of those, so never pull more.
+    char query[768];
     snprintf(query, sizeof(query),
         "SELECT id, guid, char_name, map_id, difficulty_id, clear_time, party_size, "
-        "scaled, effective_level, mobs_killed, bosses_killed, deaths "
-        "FROM dm_leaderboard "
-        "WHERE map_id = %u AND difficulty_id = %u "
-        "ORDER BY clear_time ASC LIMIT %u",
-        mapId, difficultyId, limit);
+        "scaled, effective_level, mobs_killed, bosses_killed, deaths FROM ("
+        "SELECT l.*, ROW_NUMBER() OVER (PARTITION BY l.map_id, l.difficulty_id "
+        "ORDER BY l.clear_time ASC, l.id ASC) AS board_rank FROM dm_leaderboard l) ranked "
+        "WHERE board_rank <= %u "
+        "ORDER BY clear_time ASC, id ASC",
+        LEADERBOARD_CACHE_SIZE);
 
     QueryResult result = CharacterDatabase.Query(query);
+    if (!result)
+    {
+        LOG_INFO("module", "DungeonMaster: No leaderboard entries found.");
+        return;
+    }
 
-    if (!result) return entries;
-
+    uint32 count = 0;
     do
     {
         Field* f = result->Fetch();
@@ -3032,48 +3224,142 @@ std::vector<LeaderboardEntry> DungeonMasterMgr::GetLeaderboard(
         e.MobsKilled     = f[9].Get<uint32>();
         e.BossesKilled   = f[10].Get<uint32>();
         e.Deaths         = f[11].Get<uint32>();
-        entries.push_back(e);
+
+        // Rows arrive in clear-time order, so appending keeps every board sorted
+        _mapLeaderboards[{ e.MapId, e.DifficultyId }].push_back(e);
+        if (_overallLeaderboard.size() < LEADERBOARD_CACHE_SIZE)
+            _overallLeaderboard.push_back(e);
+        ++count;
     } while (result->NextRow());
 
-    return entries;
+    LOG_INFO("module", "DungeonMaster: Cached {} leaderboard entries across {} boards.",
+        count, _mapLeaderboards.size());
+
+    // Rank index: each leader's best per board, sorted once after loading
+    result = CharacterDatabase.Query(
+        "SELECT guid, map_id, difficulty_id, MIN(clear_time) FROM dm_leaderboard "
+        "GROUP BY guid, map_id, difficulty_id");
+    if (!result) return;
+
+    uint32 indexed = 0;
+    do
+    {
+        Field* f = result->Fetch();
+        uint32 guidLow   = f[0].Get<uint32>();
+        auto   board     = std::make_pair(f[1].Get<uint32>(), f[2].Get<uint32>());
+        uint32 clearTime = f[3].Get<uint32>();
+
+        _personalBests[guidLow][board] = clearTime;
+        _boardClearTimes[board].push_back(clearTime);
+        ++indexed;
+    } while (result->NextRow());
+
+    for (auto& [board, times] : _boardClearTimes)
+        std::sort(times.begin(), times.end());
+    for (const auto& [guidLow, bests] : _personalBests)
+        _overallClearTimes.push_back(OverallBest(bests));
+    std::sort(_overallClearTimes.begin(), _overallClearTimes.end());
+
+    LOG_INFO("module", "DungeonMaster: Indexed {} personal bests for {} players.",
+        indexed, _personalBests.size());
 }
 
-std::vector<LeaderboardEntry> DungeonMasterMgr::GetOverallLeaderboard(uint32 limit) const
+// Number of leaders with a strictly faster best + 1
+static uint32 RankIn(const std::vector<uint32>& sortedTimes, uint32 clearTime)
 {
-    std::vector<LeaderboardEntry> entries;
+    return static_cast<uint32>(
+        std::lower_bound(sortedTimes.begin(), sortedTimes.end(), clearTime) - sortedTimes.begin()) + 1;
+}
 
-    char query[512];
-    snprintf(query, sizeof(query),
-        "SELECT id, guid, char_name, map_id, difficulty_id, clear_time, party_size, "
-        "scaled, effective_level, mobs_killed, bosses_killed, deaths "
-        "FROM dm_leaderboard "
-        "ORDER BY clear_time ASC LIMIT %u",
-        limit);
+// Swaps one leader's old best (0 for none) for their new one, keeping the order
+static void ReplaceTime(std::vector<uint32>& sortedTimes, uint32 oldTime, uint32 newTime)
+{
+    if (oldTime)
+    {
+        auto it = std::lower_bound(sortedTimes.begin(), sortedTimes.end(), oldTime);
+        if (it != sortedTimes.end() && *it == oldTime)
+            sortedTimes.erase(it);
+    }
+    sortedTimes.insert(std::upper_bound(sortedTimes.begin(), sortedTimes.end(), newTime), newTime);
+}
 
-    QueryResult result = CharacterDatabase.Query(query);
+void DungeonMasterMgr::CacheLeaderboardEntry(const LeaderboardEntry& entry)
+{
+    auto board = std::make_pair(entry.MapId, entry.DifficultyId);
 
-    if (!result) return entries;
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    InsertTopN(_mapLeaderboards[board], entry, LEADERBOARD_CACHE_SIZE);
+    InsertTopN(_overallLeaderboard, entry, LEADERBOARD_CACHE_SIZE);
 
-    do
+    // Only a new personal best moves the rank index
+    auto& bests = _personalBests[entry.Guid];
+    uint32 overall = OverallBest(bests);
+    uint32& best = bests[board];
+    if (best != 0 && entry.ClearTime >= best)
+        return;
+
+    ReplaceTime(_boardClearTimes[board], best, entry.ClearTime);
+    if (overall == 0 || entry.ClearTime < overall)
+        ReplaceTime(_overallClearTimes, overall, entry.ClearTime);
+    best = entry.ClearTime;
+}
+
+std::vector<LeaderboardEntry> DungeonMasterMgr::GetLeaderboard(
+    uint32 mapId, uint32 difficultyId, uint32 limit) const
+{
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    auto it = _mapLeaderboards.find({ mapId, difficultyId });
+    if (it == _mapLeaderboards.end())
+        return {};
+    return CopyTopN(it->second, limit);
+}
+
+std::vector<LeaderboardEntry> DungeonMasterMgr::GetOverallLeaderboard(uint32 limit) const
+{
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    return CopyTopN(_overallLeaderboard, limit);
+}
+
+std::vector<PersonalBest> DungeonMasterMgr::GetPersonalBests(ObjectGuid guid) const
+{
+    std::vector<PersonalBest> bests;
+
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    auto it = _personalBests.find(guid.GetCounter());
+    if (it == _personalBests.end())
+        return bests;
+
+    for (const auto& [board, clearTime] : it->second)
     {
-        Field* f = result->Fetch();
-        LeaderboardEntry e;
-        e.Id             = f[0].Get<uint32>();
-        e.Guid           = f[1].Get<uint32>();
-        e.CharName       = f[2].Get<std::string>();
-        e.MapId          = f[3].Get<uint32>();
-        e.DifficultyId   = f[4].Get<uint32>();
-        e.ClearTime      = f[5].Get<uint32>();
-        e.PartySize      = f[6].Get<uint8>();
-        e.Scaled         = f[7].Get<uint8>() != 0;
-        e.EffectiveLevel = f[8].Get<uint8>();
-        e.MobsKilled     = f[9].Get<uint32>();
-        e.BossesKilled   = f[10].Get<uint32>();
-        e.Deaths         = f[11].Get<uint32>();
-        entries.push_back(e);
-    } while (result->NextRow());
+        PersonalBest pb;
+        pb.MapId        = board.first;
+        pb.DifficultyId = board.second;
+        pb.ClearTime    = clearTime;
+
+        auto bt = _boardClearTimes.find(board);
+        if (bt != _boardClearTimes.end())
+        {
+            pb.Rank      = RankIn(bt->second, clearTime);
+            pb.BoardSize = static_cast<uint32>(bt->second.size());
+        }
+        bests.push_back(pb);
+    }
+    return bests;
+}
+
+uint32 DungeonMasterMgr::GetLeaderboardRank(uint32 mapId, uint32 difficultyId, uint32 clearTime) const
+{
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    auto it = _boardClearTimes.find({ mapId, difficultyId });
+    if (it == _boardClearTimes.end())
+        return 1;
+    return RankIn(it->second, clearTime);
+}
 
-    return entries;
+uint32 DungeonMasterMgr::GetOverallRank(uint32 clearTime) const
+{
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    return RankIn(_overallClearTimes, clearTime);
 }
 
 // Scaling multipliers
@@ -3083,11 +3369,8 @@ float DungeonMasterMgr::CalculateHealthMultiplier(const Session* s) const
     const DifficultyTier* d = sDMConfig->GetDifficulty(s->DifficultyId);
     if (!d) return 1.0f;
 
-    float base = d->HealthMultiplier;
-    uint32 n   = s->Players.size();
-    float mult;
-    if (n <= 1) mult = base * sDMConfig->GetSoloMultiplier();
-    else        mult = base * (1.0f + (n - 1) * sDMConfig->GetPerPlayerHealthMult());
+    float mult = d->HealthMultiplier * PartyScaling(static_cast<uint32>(s->Players.size()),
+        sDMConfig->GetSoloMultiplier(), sDMConfig->GetPerPlayerHealthMult());
 
     // Roguelike tier scaling
     if (s->RoguelikeRunId != 0)
@@ -3102,11 +3385,8 @@ float DungeonMasterMgr::CalculateDamageMultiplier(const Session* s) const
     const DifficultyTier* d = sDMConfig->GetDifficulty(s->DifficultyId);
     if (!d) return 1.0f;
 
-    float base = d->DamageMultiplier;
-    uint32 n   = s->Players.size();
-    float mult;
-    if (n <= 1) mult = base * sDMConfig->GetSoloMultiplier();
-    else        mult = base * (1.0f + (n - 1) * sDMConfig->GetPerPlayerDamageMult());
+    float mult = d->DamageMultiplier * PartyScaling(static_cast<uint32>(s->Players.size()),
+        sDMConfig->GetSoloMultiplier(), sDMConfig->GetPerPlayerDamageMult());
 
     // Roguelike tier scaling
     if (s->RoguelikeRunId != 0)
@@ -3142,11 +3422,9 @@ bool DungeonMasterMgr::IsSessionBoss(ObjectGuid playerGuid, ObjectGuid creatureG
     if (sit == _activeSessions.end())
         return false;
 
-    for (const auto& sc : sit->second.SpawnedCreatures)
-        if (sc.Guid == creatureGuid)
-            return sc.IsBoss;
-
-    return false;
+    const SpawnRoster& roster = sit->second.SpawnedCreatures;
+    uint32 i = roster.Find(creatureGuid);
+    return i != SpawnRoster::NOT_FOUND && roster.Has(i, SPAWN_BOSS);
 }
 
 // Compute damage scale for a session creature attacking a session player.
@@ -3166,23 +3444,10 @@ float DungeonMasterMgr::GetSessionCreatureDamageScale(
 
     const Session& session = sit->second;
 
-    // Verify this creature belongs to the session
-    bool isBoss = false;
-    bool found  = false;
-    for (const auto& sc : session.SpawnedCreatures)
-    {
-        if (sc.Guid == creatureGuid)
-        {
-            found  = true;
-            isBoss = sc.IsBoss;
-            break;
-        }
-    }
-    if (!found)
-        return 1.0f;
-
+    // Verify this creature belongs to the session.
     // Trash mobs use our custom AI — melee is already scaled, no spells.
-    if (!isBoss)
+    uint32 idx = session.SpawnedCreatures.Find(creatureGuid);
+    if (idx == SpawnRoster::NOT_FOUND || !session.SpawnedCreatures.Has(idx, SPAWN_BOSS))
         return 1.0f;
 
     // For bosses: compare session target level to the boss's original template level.
@@ -3279,30 +3544,160 @@ float DungeonMasterMgr::GetEnvironmentalDamageScale(ObjectGuid playerGuid)
 }
 
 // Main update tick (1s interval)
+// Heap held by one session's own containers; the spawned Creature objects live
+// in the map and the spawn points in the per-map cache
+static uint64 SessionFootprint(const Session& s)
+{
+    return sizeof(Session)
+        + HeapBytes(s.Players)
+        + s.SpawnedCreatures.GetHeapBytes()
+        + HeapBytes(s.SpawnPlan)
+        + HeapBytes(s.PendingPhaseChecks);
+}
+
+template <class Pool>
+static uint64 PoolBytes(const Pool& pool)
+{
+    uint64 bytes = HeapBytes(pool);
+    for (const auto& [type, entries] : pool)
+        bytes += HeapBytes(entries);
+    return bytes;
+}
+
+MemoryReport DungeonMasterMgr::GetMemoryReport() const
+{
+    MemoryReport r;
+
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        r.Sessions.reserve(_activeSessions.size());
+        for (const auto& [sid, s] : _activeSessions)
+            r.Sessions.push_back({ sid, s.MapId, static_cast<uint32>(s.SpawnedCreatures.size()), SessionFootprint(s) });
+
+        uint64 guidBytes = HeapBytes(_instanceCreatureGuids);
+        for (const auto& [inst, guids] : _instanceCreatureGuids)
+            guidBytes += HeapBytes(guids);
+        r.Caches.push_back({ "Instance GUID lists", static_cast<uint32>(_instanceCreatureGuids.size()), guidBytes });
+
+        r.Caches.push_back({ "Session index", static_cast<uint32>(_playerToSession.size()),
+            HeapBytes(_instanceToSession) + HeapBytes(_playerToSession) + HeapBytes(_replaySeeds)
+            + sizeof(_sessionPlayerFilter) });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_spawnPointMutex);
+        uint64 bytes = HeapBytes(_spawnPointCache);
+        for (const auto& [mapId, points] : _spawnPointCache)
+            bytes += sizeof(std::vector<SpawnPoint>) + 2 * sizeof(void*) + HeapBytes(*points);
+        r.Caches.push_back({ "Spawn points", static_cast<uint32>(_spawnPointCache.size()), bytes });
+    }
+
+    // Loaded once at startup and read-only afterwards
+    r.Caches.push_back({ "Creature pools",
+        static_cast<uint32>(_creaturesByType.size() + _bossCreatures.size() + _dungeonBossPool.size()),
+        PoolBytes(_creaturesByType) + PoolBytes(_bossCreatures) + PoolBytes(_dungeonBossPool) });
+    r.Caches.push_back({ "Class level stats", static_cast<uint32>(_classLevelStats.size()), HeapBytes(_classLevelStats) });
+    r.Caches.push_back({ "Reward items", static_cast<uint32>(_rewardItems.size()), HeapBytes(_rewardItems) });
+    r.Caches.push_back({ "Loot pool", static_cast<uint32>(_lootPool.size()), HeapBytes(_lootPool) });
+    r.Caches.push_back({ "Dungeon entrances", static_cast<uint32>(_dungeonEntrances.size()), HeapBytes(_dungeonEntrances) });
+
+    {
+        std::lock_guard<std::mutex> lock(_leaderboardMutex);
+        auto boardBytes = [](const std::vector<LeaderboardEntry>& board)
+        {
+            uint64 bytes = HeapBytes(board);
+            for (const auto& e : board)
+                bytes += HeapBytes(e.CharName);
+            return bytes;
+        };
+
+        uint64 bytes = HeapBytes(_mapLeaderboards) + boardBytes(_overallLeaderboard)
+                     + HeapBytes(_boardClearTimes) + HeapBytes(_overallClearTimes) + HeapBytes(_personalBests);
+        for (const auto& [key, board] : _mapLeaderboards)
+            bytes += boardBytes(board);
+        for (const auto& [key, times] : _boardClearTimes)
+            bytes += HeapBytes(times);
+        for (const auto& [guidLow, bests] : _personalBests)
+            bytes += HeapBytes(bests);
+        r.Caches.push_back({ "Leaderboards", static_cast<uint32>(_mapLeaderboards.size()), bytes });
+    }
+
+    r.Caches.push_back({ "Cooldowns", _cooldowns.GetCount(), _cooldowns.GetHeapBytes() });
+    r.Caches.push_back({ "Checkpoints", _checkpoints.GetPendingCount(), _checkpoints.GetHeapBytes() });
+
+    r.Caches.push_back({ "Player stats cache", _playerStats.GetResidentCount(), _playerStats.GetHeapBytes() });
+    r.Caches.push_back({ "Aggro grids", sDMAggro->GetTrackedCount(), sDMAggro->GetHeapBytes() });
+    return r;
+}
+
 void DungeonMasterMgr::Update(uint32 diff)
 {
+    // ---- World load for the population budget (~16-tick moving average) ----
+    _worldDiffAvg += (static_cast<float>(diff) - _worldDiffAvg) / 16.0f;
+    _worldDiffMs.store(static_cast<uint32>(_worldDiffAvg), std::memory_order_relaxed);
+
+    // ---- Stats cache: async loads + write-behind ----
+    _playerStats.ProcessCallbacks();
+    _statsFlushTimer += diff;
+    if (_statsFlushTimer >= sDMConfig->GetStatsFlushInterval() * 1000)
+    {
+        _statsFlushTimer = 0;
+        FlushPlayerStats();
+    }
+
+    // ---- Crash-recovery checkpoints ----
+    if (uint32 interval = sDMConfig->GetCheckpointInterval())
+    {
+        _checkpointTimer += diff;
+        if (_checkpointTimer >= interval * 1000)
+        {
+            _checkpointTimer = 0;
+            WriteCheckpoints();
+        }
+    }
+
     _updateTimer += diff;
     if (_updateTimer < UPDATE_INTERVAL)
         return;
     _updateTimer = 0;
 
+    PerfScope tickScope(PERF_UPDATE_TOTAL);
+    PerfTickAccumulator perf;
+
     std::vector<std::pair<uint32, bool>> toEnd;
     std::vector<std::pair<uint32, uint32>> roguelikeCompleted; // {runId, sessionId}
 
+    // Load this tick ran under, sampled before sessions end (.dm perf load)
+    uint32 loadSessions  = 0;
+    uint32 loadCreatures = 0;
+    uint64 loadBytes     = 0;
+
     {
         std::lock_guard<std::mutex> lock(_sessionMutex);
+        ApplyPresenceEvents();
+
+        if (sDMConfig->IsPerfEnabled())
+        {
+            loadSessions = static_cast<uint32>(_activeSessions.size());
+            for (const auto& [sid, session] : _activeSessions)
+            {
+                loadCreatures += static_cast<uint32>(session.SpawnedCreatures.size());
+                loadBytes     += SessionFootprint(session);
+            }
+        }
+
+        // Resolved once per session; the buffer is reused across sessions
+        PartyView party;
 
         for (auto& [sid, session] : _activeSessions)
         {
+            party.CommitCounters();     // the previous session's view
+            party.Resolve(session);
+
             // ---- Poll creature deaths ----
             if (session.IsActive())
             {
-                Player* ref = nullptr;
-                for (const auto& pd : session.Players)
-                {
-                    Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
-                    if (p && p->GetMapId() == session.MapId) { ref = p; break; }
-                }
+                Player* ref = party.GetRef();
 
                 if (ref)
                 {
@@ -3333,10 +3728,7 @@ void DungeonMasterMgr::Update(uint32 diff)
                                 session.InstanceId = inst->GetInstanceId();
                                 _instanceToSession[session.InstanceId] = session.SessionId;
 
-                                for (const auto& pd2 : session.Players)
-                                    if (Player* p2 = ObjectAccessor::FindPlayer(pd2.PlayerGuid))
-                                        ChatHandler(p2->GetSession()).SendSysMessage(
-                                            "|cFF00FF00[Dungeon Master]|r Preparing the challenge...");
+                                ChatBroadcast::Get(MSG_PREPARING).SendTo(party.Players());
 
                                 PopulateDungeon(&session, inst);
 
@@ -3351,238 +3743,244 @@ void DungeonMasterMgr::Update(uint32 diff)
                                     "|cFFFFFFFF%u-%u|r. Good luck!",
                                     session.TotalMobs, session.TotalBosses,
                                     session.LevelBandMin, session.LevelBandMax);
-                                for (const auto& pd2 : session.Players)
-                                    if (Player* p2 = ObjectAccessor::FindPlayer(pd2.PlayerGuid))
-                                        ChatHandler(p2->GetSession()).SendSysMessage(buf);
+                                ChatBroadcast(buf).SendTo(party.Players());
                             }
                         }
                     }
 
                     // Build set of our known GUIDs for stray detection
                     std::set<ObjectGuid> ourGuids;
-                    for (const auto& sc : session.SpawnedCreatures)
-                        ourGuids.insert(sc.Guid);
-
-                    for (auto& sc : session.SpawnedCreatures)
                     {
-                        if (sc.IsDead && sc.LootFilled && sc.KillCredited)
-                            continue;   // fully processed
-                        Creature* c = ObjectAccessor::GetCreature(*ref, sc.Guid);
-                        if (!c || !c->IsAlive())
-                        {
-                            sc.IsDead = true;
+                        PerfScope scope(PERF_DEATH_POLL, &perf);
+                        SpawnRoster& roster = session.SpawnedCreatures;
+                        ourGuids.insert(roster.GetGuids().begin(), roster.GetGuids().end());
 
-                            if (!sc.LootFilled && c)
+                        // Fully processed creatures are skipped eight flag bytes at a time
+                        for (uint32 i = roster.NextUnprocessed(0); i < roster.size(); i = roster.NextUnprocessed(i + 1))
+                        {
+                            Creature* c = ObjectAccessor::GetCreature(*ref, roster.GetGuid(i));
+                            if (!c || !c->IsAlive())
                             {
-                                sc.LootFilled = true;
-                                FillCreatureLoot(c, &session, sc.IsBoss);
-                            }
+                                roster.Claim(i, SPAWN_DEAD);
+                                bool isBoss = roster.Has(i, SPAWN_BOSS);
 
-                            if (!sc.KillCredited)
-                            {
-                                sc.KillCredited = true;
-                                GiveKillXP(&session, sc.IsBoss, sc.IsElite);
+                                // A vanished corpse has nothing left to loot
+                                if (roster.Claim(i, SPAWN_LOOT_FILLED) && c)
+                                    FillCreatureLoot(c, &session, party, isBoss);
 
-                                if (sc.IsBoss)
-                                {
-                                    PendingPhaseCheck ppc;
-                                    if (c)
-                                        ppc.DeathPos = { c->GetPositionX(), c->GetPositionY(),
-                                                         c->GetPositionZ(), c->GetOrientation() };
-                                    ppc.DeathTime = GameTime::GetGameTime().count();
-                                    ppc.OrigEntry = sc.Entry;
-                                    ppc.Resolved  = false;
-                                    session.PendingPhaseChecks.push_back(ppc);
-                                }
-                                else
+                                if (roster.Claim(i, SPAWN_KILL_CREDITED))
                                 {
-                                    ++session.MobsKilled;
-                                    for (auto& pd : session.Players)
-                                        ++pd.MobsKilled;
+                                    QueueKillXP(session, party, isBoss, roster.Has(i, SPAWN_ELITE));
+
+                                    if (isBoss)
+                                    {
+                                        PendingPhaseCheck ppc;
+                                        if (c)
+                                            ppc.DeathPos = { c->GetPositionX(), c->GetPositionY(),
+                                                             c->GetPositionZ(), c->GetOrientation() };
+                                        ppc.DeathTime = GameTime::GetGameTime().count();
+                                        ppc.OrigEntry = roster.GetEntry(i);
+                                        ppc.Resolved  = false;
+                                        session.PendingPhaseChecks.push_back(ppc);
+                                    }
+                                    else
+                                    {
+                                        session.CreditMobKill();
+                                    }
                                 }
                             }
                         }
                     }
 
+                    // ---- Streaming population: keep the spawned frontier ahead of the lead player ----
+                    if (session.NextPlanned < session.SpawnPlan.size())
+                    {
+                        Map* sm = ref->GetMap();
+                        InstanceMap* inst = sm ? sm->ToInstanceMap() : nullptr;
+                        if (inst && inst->GetInstanceId() == session.InstanceId)
+                        {
+                            PerfScope scope(PERF_STREAM, &perf);
+                            float progress = 0.0f;
+                            for (Player* p : party.Players())
+                                if (p && p->GetMap() == sm)
+                                    progress = std::max(progress, p->GetExactDist(&session.EntrancePos));
+                            StreamPopulation(&session, inst, progress);
+                        }
+                    }
+
                     // ---- Multi-phase boss resolution ----
                     // After 5 seconds, check if new creatures spawned near the boss death location.
                     // If found, promote them to boss status. If not, confirm the boss kill.
-                    uint64 nowTime = GameTime::GetGameTime().count();
-                    for (auto& ppc : session.PendingPhaseChecks)
                     {
-                        if (ppc.Resolved) continue;
-                        if (nowTime - ppc.DeathTime < 5) continue;  // Wait 5 seconds for phase transitions
-
-                        ppc.Resolved = true;
-
-                        // Scan for new non-tracked creatures near the boss death position
-                        bool phaseCreatureFound = false;
-                        Map* scanMap = ref->GetMap();
-                        if (scanMap && scanMap->IsDungeon() && ppc.DeathPos.GetPositionX() != 0.0f)
+                        PerfScope scope(PERF_PHASE_CHECKS, &perf);
+                        uint64 nowTime = GameTime::GetGameTime().count();
+                        for (auto& ppc : session.PendingPhaseChecks)
                         {
-                            std::list<Creature*> nearby;
-                            ref->GetCreatureListWithEntryInGrid(nearby, 0, 5000.0f);
+                            if (ppc.Resolved) continue;
+                            if (nowTime - ppc.DeathTime < 5) continue;  // Wait 5 seconds for phase transitions
+
+                            ppc.Resolved = true;
 
-                            for (Creature* nc : nearby)
+                            // Scan for new non-tracked creatures near the boss death position
+                            bool phaseCreatureFound = false;
+                            Map* scanMap = ref->GetMap();
+                            if (scanMap && scanMap->IsDungeon() && ppc.DeathPos.GetPositionX() != 0.0f)
                             {
-                                if (!nc || !nc->IsAlive() || nc->IsPet() || nc->IsGuardian())
-                                    continue;
-                                if (nc->GetEntry() == sDMConfig->GetNpcEntry())
-                                    continue;
-                                if (ourGuids.count(nc->GetGUID()) > 0)
-                                    continue;  // Already tracked
-
-                                // Check distance from boss death position (within 40 yards)
-                                float dx = nc->GetPositionX() - ppc.DeathPos.GetPositionX();
-                                float dy = nc->GetPositionY() - ppc.DeathPos.GetPositionY();
-                                float dz = nc->GetPositionZ() - ppc.DeathPos.GetPositionZ();
-                                float dist = std::sqrt(dx*dx + dy*dy + dz*dz);
-
-                                if (dist > 40.0f) continue;
-
-                                // Check if it's an elite/boss creature (likely phase 2)
-                                const CreatureTemplate* tmpl = nc->GetCreatureTemplate();
-                                if (!tmpl || (tmpl->rank != 1 && tmpl->rank != 2 && tmpl->rank != 4))
-                                    continue;
-
-                                // Promote to boss creature
-                                LOG_INFO("module", "DungeonMaster: Phase creature detected! '{}' (entry {}) "
-                                    "spawned {:.1f} yds from boss death location — promoting to boss",
-                                    nc->GetName(), nc->GetEntry(), dist);
-
-                                nc->SetFaction(14);
-                                nc->SetReactState(REACT_AGGRESSIVE);
-                                nc->RemoveFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NON_ATTACKABLE | UNIT_FLAG_IMMUNE_TO_PC
-                                                                | UNIT_FLAG_IMMUNE_TO_NPC | UNIT_FLAG_PACIFIED);
-                                nc->SetImmuneToPC(false);
-                                nc->SetImmuneToNPC(false);
-
-                                SpawnedCreature nsc;
-                                nsc.Guid = nc->GetGUID();
-                                nsc.Entry = nc->GetEntry();
-                                nsc.IsElite = true;
-                                nsc.IsBoss = true;
-                                session.SpawnedCreatures.push_back(nsc);
-                                ourGuids.insert(nc->GetGUID());
-
-                                // Track the GUID for cleanup
-                                auto& gl = _instanceCreatureGuids[session.InstanceId];
-                                gl.push_back(nc->GetGUID());
-
-                                phaseCreatureFound = true;
-
-                                for (const auto& pd3 : session.Players)
-                                    if (Player* p3 = ObjectAccessor::FindPlayer(pd3.PlayerGuid))
-                                        if (p3->GetSession())
-                                            ChatHandler(p3->GetSession()).SendSysMessage(
-                                                "|cFFFF8000[Dungeon Master]|r The boss enters a new phase!");
-                                break;  // Only promote one phase creature per check
+                                std::list<Creature*> nearby;
+                                ref->GetCreatureListWithEntryInGrid(nearby, 0, 5000.0f);
+
+                                for (Creature* nc : nearby)
+                                {
+                                    if (!nc || !nc->IsAlive() || nc->IsPet() || nc->IsGuardian())
+                                        continue;
+                                    if (nc->GetEntry() == sDMConfig->GetNpcEntry())
+                                        continue;
+                                    if (ourGuids.count(nc->GetGUID()) > 0)
+                                        continue;  // Already tracked
+
+                                    // Check distance from boss death position (within 40 yards)
+                                    float dx = nc->GetPositionX() - ppc.DeathPos.GetPositionX();
+                                    float dy = nc->GetPositionY() - ppc.DeathPos.GetPositionY();
+                                    float dz = nc->GetPositionZ() - ppc.DeathPos.GetPositionZ();
+                                    float dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+                                    if (dist > 40.0f) continue;
+
+                                    // Check if it's an elite/boss creature (likely phase 2)
+                                    const CreatureTemplate* tmpl = nc->GetCreatureTemplate();
+                                    if (!tmpl || (tmpl->rank != 1 && tmpl->rank != 2 && tmpl->rank != 4))
+                                        continue;
+
+                                    // Promote to boss creature
+                                    LOG_INFO("module", "DungeonMaster: Phase creature detected! '{}' (entry {}) "
+                                        "spawned {:.1f} yds from boss death location — promoting to boss",
+                                        nc->GetName(), nc->GetEntry(), dist);
+
+                                    nc->SetFaction(14);
+                                    nc->SetReactState(REACT_AGGRESSIVE);
+                                    nc->RemoveFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NON_ATTACKABLE | UNIT_FLAG_IMMUNE_TO_PC
+                                                                    | UNIT_FLAG_IMMUNE_TO_NPC | UNIT_FLAG_PACIFIED);
+                                    nc->SetImmuneToPC(false);
+                                    nc->SetImmuneToNPC(false);
+
+                                    session.SpawnedCreatures.Add(nc->GetGUID(), nc->GetEntry(), SPAWN_ELITE | SPAWN_BOSS);
+                                    ourGuids.insert(nc->GetGUID());
+
+                                    // Track the GUID for cleanup
+                                    auto& gl = _instanceCreatureGuids[session.InstanceId];
+                                    gl.push_back(nc->GetGUID());
+
+                                    phaseCreatureFound = true;
+
+                                    ChatBroadcast::Get(MSG_BOSS_NEW_PHASE).SendTo(party.Players());
+                                    break;  // Only promote one phase creature per check
+                                }
                             }
-                        }
 
-                        if (!phaseCreatureFound)
-                        {
-                            // No phase creature found — confirm the boss kill
-                            ++session.BossesKilled;
-                            for (auto& pd : session.Players)
-                                ++pd.BossesKilled;
-
-                            LOG_INFO("module", "DungeonMaster: Boss kill confirmed (entry {}) — progress: {}/{}",
-                                ppc.OrigEntry, session.BossesKilled, session.TotalBosses);
-                            HandleBossDeath(&session);
-
-                            // Check completion
-                            if (session.IsActive() && session.TotalBosses > 0
-                                && session.BossesKilled >= session.TotalBosses)
+                            if (!phaseCreatureFound)
                             {
-                                session.State   = SessionState::Completed;
-                                session.EndTime = GameTime::GetGameTime().count();
-
-                                uint32 delay = (session.RoguelikeRunId != 0)
-                                    ? sDMConfig->GetRoguelikeTransitionDelay()
-                                    : sDMConfig->GetCompletionTeleportDelay();
-
-                                for (const auto& pd2 : session.Players)
-                                    if (Player* p = ObjectAccessor::FindPlayer(pd2.PlayerGuid))
-                                        if (p->GetSession())
-                                        {
-                                            char buf[256];
-                                            snprintf(buf, sizeof(buf),
-                                                "|cFF00FF00[Dungeon Master]|r %s "
-                                                "Rewards in |cFFFFFFFF%u|r seconds...",
-                                                session.RoguelikeRunId != 0
-                                                    ? "Floor cleared!" : "Dungeon complete!",
-                                                delay);
-                                            ChatHandler(p->GetSession()).SendSysMessage(buf);
-                                        }
-                                break;
+                                // No phase creature found — confirm the boss kill
+                                session.CreditBossKill();
+
+                                LOG_INFO("module", "DungeonMaster: Boss kill confirmed (entry {}) — progress: {}/{}",
+                                    ppc.OrigEntry, session.BossesKilled, session.TotalBosses);
+                                HandleBossDeath(&session, party);
+
+                                // Check completion
+                                if (session.IsActive() && session.TotalBosses > 0
+                                    && session.BossesKilled >= session.TotalBosses)
+                                {
+                                    session.State   = SessionState::Completed;
+                                    session.EndTime = GameTime::GetGameTime().count();
+
+                                    uint32 delay = (session.RoguelikeRunId != 0)
+                                        ? sDMConfig->GetRoguelikeTransitionDelay()
+                                        : sDMConfig->GetCompletionTeleportDelay();
+
+                                    char buf[256];
+                                    snprintf(buf, sizeof(buf),
+                                        "|cFF00FF00[Dungeon Master]|r %s "
+                                        "Rewards in |cFFFFFFFF%u|r seconds...",
+                                        session.RoguelikeRunId != 0
+                                            ? "Floor cleared!" : "Dungeon complete!",
+                                        delay);
+                                    ChatBroadcast(buf).SendTo(party.Players());
+                                    break;
+                                }
                             }
                         }
-                    }
 
-                    // Clean up resolved phase checks
-                    session.PendingPhaseChecks.erase(
-                        std::remove_if(session.PendingPhaseChecks.begin(), session.PendingPhaseChecks.end(),
-                            [](const PendingPhaseCheck& p) { return p.Resolved; }),
-                        session.PendingPhaseChecks.end());
+                        // Clean up resolved phase checks
+                        session.PendingPhaseChecks.erase(
+                            std::remove_if(session.PendingPhaseChecks.begin(), session.PendingPhaseChecks.end(),
+                                [](const PendingPhaseCheck& p) { return p.Resolved; }),
+                            session.PendingPhaseChecks.end());
+                    }
 
                     // ---- Sweep for stray creatures (script-spawned, respawned) ----
-                    Map* m = ref->GetMap();
-                    if (m && m->IsDungeon())
                     {
-                        uint32 npcEntry = sDMConfig->GetNpcEntry();
-                        auto const& dbStore = static_cast<InstanceMap*>(m)->GetCreatureBySpawnIdStore();
-                        for (auto const& pair : dbStore)
+                        PerfScope scope(PERF_STRAY_SWEEP, &perf);
+                        Map* m = ref->GetMap();
+                        if (m && m->IsDungeon())
                         {
-                            Creature* stray = pair.second;
-                            if (stray && stray->IsInWorld() && stray->IsAlive()
-                                && stray->GetEntry() != npcEntry
-                                && !stray->IsPet() && !stray->IsGuardian() && !stray->IsTotem()
-                                && ourGuids.count(stray->GetGUID()) == 0)
+                            uint32 npcEntry = sDMConfig->GetNpcEntry();
+                            auto const& dbStore = static_cast<InstanceMap*>(m)->GetCreatureBySpawnIdStore();
+                            for (auto const& pair : dbStore)
                             {
-                                stray->SetRespawnTime(7 * DAY);
-                                stray->DespawnOrUnsummon();
+                                Creature* stray = pair.second;
+                                if (stray && stray->IsInWorld() && stray->IsAlive()
+                                    && stray->GetEntry() != npcEntry
+                                    && !stray->IsPet() && !stray->IsGuardian() && !stray->IsTotem()
+                                    && ourGuids.count(stray->GetGUID()) == 0)
+                                {
+                                    stray->SetRespawnTime(7 * DAY);
+                                    stray->DespawnOrUnsummon();
+                                }
                             }
                         }
                     }
                 }
 
                 // ---- Auto-rez when out of combat ----
-                if (session.IsActive() && !session.IsGroupInCombat())
                 {
-                    for (const auto& pd : session.Players)
+                    PerfScope scope(PERF_AUTO_REZ, &perf);
+                    if (session.IsActive() && session.HasDeadPlayers() && !session.IsGroupInCombat())
                     {
-                        Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
-                        if (p && !p->IsAlive() && p->GetMapId() == session.MapId)
+                        for (Player* p : party.Players())
                         {
-                            p->RemoveFlag(PLAYER_FIELD_BYTES, PLAYER_FIELD_BYTE_NO_RELEASE_WINDOW);
-                            p->ResurrectPlayer(1.0f);
-                            p->SpawnCorpseBones();
-                            p->TeleportTo(session.MapId,
-                                session.EntrancePos.GetPositionX(),
-                                session.EntrancePos.GetPositionY(),
-                                session.EntrancePos.GetPositionZ(),
-                                session.EntrancePos.GetOrientation());
-                            ChatHandler(p->GetSession()).SendSysMessage(
-                                "|cFF00FF00[Dungeon Master]|r Revived at entrance. Get back in there!");
+                            if (p && !p->IsAlive() && p->GetMapId() == session.MapId)
+                            {
+                                p->RemoveFlag(PLAYER_FIELD_BYTES, PLAYER_FIELD_BYTE_NO_RELEASE_WINDOW);
+                                p->ResurrectPlayer(1.0f);
+                                p->SpawnCorpseBones();
+                                p->TeleportTo(session.MapId,
+                                    session.EntrancePos.GetPositionX(),
+                                    session.EntrancePos.GetPositionY(),
+                                    session.EntrancePos.GetPositionZ(),
+                                    session.EntrancePos.GetOrientation());
+                                ChatBroadcast::Get(MSG_REVIVED).SendTo(p);
+                            }
                         }
                     }
                 }
             }
 
+            // ---- Kill XP and progress gathered since the last tick ----
+            FlushKillCredit(session, party);
+
             // ---- Time limit ----
-            if (session.TimeLimit > 0 && session.State == SessionState::InProgress)
             {
-                uint64 elapsed = GameTime::GetGameTime().count() - session.StartTime;
-                if (elapsed >= session.TimeLimit)
+                PerfScope scope(PERF_TIME_LIMIT, &perf);
+                if (session.TimeLimit > 0 && session.State == SessionState::InProgress)
                 {
-                    session.State = SessionState::Failed;
-                    toEnd.emplace_back(sid, false);
-                    for (const auto& pd : session.Players)
-                        if (Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid))
-                            ChatHandler(p->GetSession()).SendSysMessage(
-                                "|cFFFF0000[Dungeon Master]|r Time's up! Challenge failed.");
-                    continue;
+                    uint64 elapsed = GameTime::GetGameTime().count() - session.StartTime;
+                    if (elapsed >= session.TimeLimit)
+                    {
+                        session.State = SessionState::Failed;
+                        toEnd.emplace_back(sid, false);
+                        ChatBroadcast::Get(MSG_TIME_UP).SendTo(party.Players());
+                        continue;
+                    }
                 }
             }
 
@@ -3603,14 +4001,7 @@ void DungeonMasterMgr::Update(uint32 diff)
                     {
                         if (remaining == sec)
                         {
-                            char cbuf[128];
-                            snprintf(cbuf, sizeof(cbuf),
-                                "|cFF00FFFF[Roguelike]|r Next dungeon in |cFFFFFFFF%u|r second%s...",
-                                remaining, remaining != 1 ? "s" : "");
-                            for (const auto& pd3 : session.Players)
-                                if (Player* p3 = ObjectAccessor::FindPlayer(pd3.PlayerGuid))
-                                    if (p3->GetSession())
-                                        ChatHandler(p3->GetSession()).SendSysMessage(cbuf);
+                            ChatBroadcast::Countdown(remaining).SendTo(party.Players());
                             break;
                         }
                     }
@@ -3646,13 +4037,8 @@ void DungeonMasterMgr::Update(uint32 diff)
             if (session.IsActive()
                 && (GameTime::GetGameTime().count() - session.StartTime) >= 15)
             {
-                bool anyone = false;
-                for (const auto& pd : session.Players)
-                {
-                    Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid);
-                    if (p && p->GetMapId() == session.MapId) { anyone = true; break; }
-                }
-                if (!anyone)
+                // Auto-rez teleports stay on the map, so the tick-start ref still holds
+                if (!party.GetRef())
                 {
                     LOG_INFO("module", "DungeonMaster: Session {} abandoned — no players on map {} after grace period",
                         sid, session.MapId);
@@ -3661,6 +4047,7 @@ void DungeonMasterMgr::Update(uint32 diff)
                 }
             }
         }
+        party.CommitCounters();
     } // release lock
 
     for (const auto& [id, ok] : toEnd)
@@ -3672,11 +4059,13 @@ void DungeonMasterMgr::Update(uint32 diff)
 
 
     {
-        std::lock_guard<std::mutex> lock(_cooldownMutex);
-        time_t now = GameTime::GetGameTime().count();
-        for (auto it = _cooldowns.begin(); it != _cooldowns.end(); )
-            (now >= static_cast<time_t>(it->second)) ? it = _cooldowns.erase(it) : ++it;
+        PerfScope scope(PERF_COOLDOWN_PURGE, &perf);
+        _cooldowns.Purge(GameTime::GetGameTime().count());
     }
+
+    perf.Commit();
+    if (sDMConfig->IsPerfEnabled())
+        sDMPerf->RecordLoad(loadSessions, loadCreatures, loadBytes, tickScope.ElapsedMicros());
 }
 
 std::string DungeonMasterMgr::GetSessionStatusString(const Session* s) const
@@ -3684,10 +4073,10 @@ std::string DungeonMasterMgr::GetSessionStatusString(const Session* s) const
     if (!s) return "No session";
     static const char* names[] = { "None","Preparing","InProgress","BossPhase","Completed","Failed","Abandoned" };
     char buf[256];
-    snprintf(buf, sizeof(buf), "Session %u — %s, Mobs %u/%u, Bosses %u/%u, Band %u-%u",
+    snprintf(buf, sizeof(buf), "Session %u — %s, Mobs %u/%u, Bosses %u/%u, Band %u-%u, Seed %llu",
         s->SessionId, names[static_cast<int>(s->State)],
         s->MobsKilled, s->TotalMobs, s->BossesKilled, s->TotalBosses,
-        s->LevelBandMin, s->LevelBandMax);
+        s->LevelBandMin, s->LevelBandMax, static_cast<unsigned long long>(s->Seed));
     return buf;
 }
 
@@ -8,6 +8,11 @@
 
 #include "DMTypes.h"
 #include "DMConfig.h"
+#include "PlayerStatsCache.h"
+#include "DMCooldowns.h"
+#include "DMCheckpoint.h"
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <map>
 #include <unordered_map>
@@ -17,10 +22,63 @@ class Group;
 class Creature;
 class Map;
 class InstanceMap;
+class Field;
 
 namespace DungeonMaster
 {
 
+// dm_player_stats row mapping for PlayerStatsCache
+struct NormalStatsTraits
+{
+    using Stats = PlayerStats;
+    static std::string SelectQuery(uint32 guidLow);
+    static void        Read(Field* fields, PlayerStats& out);
+    static std::string ReplaceQuery(uint32 guidLow, const PlayerStats& stats);
+    static std::string MergeQuery(uint32 guidLow, const PlayerStats& delta);
+    static void        Merge(PlayerStats& into, const PlayerStats& delta);
+};
+
+// .dm mem: estimated heap bytes per session and per global cache
+struct MemoryReport
+{
+    struct SessionUsage
+    {
+        uint32 SessionId = 0;
+        uint32 MapId     = 0;
+        uint32 Creatures = 0;
+        uint64 Bytes     = 0;
+    };
+
+    struct CacheUsage
+    {
+        const char* Name    = "";
+        uint32      Entries = 0;
+        uint64      Bytes   = 0;
+    };
+
+    std::vector<SessionUsage> Sessions;
+    std::vector<CacheUsage>   Caches;
+};
+
+// A session's members resolved to Player* once, in Session::Players order
+// (nullptr while offline). Update resolves each session once per tick and the
+// death poll, messages, kill XP, loot and auto-rez all read from it.
+class PartyView
+{
+public:
+    void Resolve(const Session& session);
+    void CommitCounters() const;    // .dm perf hooks; call once the view is done with
+
+    const std::vector<Player*>& Players() const { _demand += _players.size(); return _players; }
+    Player* GetRef() const { _demand += _refLookups; return _ref; }     // first member on the session's map
+
+private:
+    std::vector<Player*> _players;  // capacity kept across Resolve calls
+    Player*              _ref        = nullptr;
+    uint32               _refLookups = 0;    // FindPlayer calls a standalone search for _ref makes
+    mutable uint64       _demand     = 0;    // FindPlayer calls the readers would have made on their own
+};
+
 class DungeonMasterMgr
 {
     DungeonMasterMgr();
@@ -37,17 +95,21 @@ public:
     Session*  GetSession(uint32 sessionId);
     Session*  GetSessionByInstance(uint32 instanceId);
     Session*  GetSessionByPlayer(ObjectGuid playerGuid);
+    bool      MayBeInSession(ObjectGuid playerGuid) const;   // lock-free; false = definitely not
     void      EndSession(uint32 sessionId, bool success);
     void      AbandonSession(uint32 sessionId);
     void      CleanupRoguelikeSession(uint32 sessionId, bool success);
 
+    // Next session led by this player populates from `seed` (.dm replay)
+    void      SetReplaySeed(ObjectGuid leaderGuid, uint64 seed);
+
     // Session ops
     bool StartDungeon(Session* session);
     bool TeleportPartyIn(Session* session);
     void TeleportPartyOut(Session* session);
     void HandlePlayerDeath(Player* player, Session* session);
     void HandleCreatureDeath(Creature* creature, Session* session);
-    void HandleBossDeath(Session* session);
+    void HandleBossDeath(Session* session, const PartyView& party);
     void OnCreatureDeathHook(Creature* creature);
 
     // Dungeon population
@@ -57,7 +119,7 @@ public:
 
     // Rewards
     void DistributeRewards(Session* session);
-    void FillCreatureLoot(Creature* creature, Session* session, bool isBoss);
+    void FillCreatureLoot(Creature* creature, Session* session, const PartyView& party, bool isBoss);
 
     // Cooldowns
     bool   IsOnCooldown(ObjectGuid playerGuid) const;
@@ -67,25 +129,49 @@ public:
 
     // Stats & leaderboard
     PlayerStats GetPlayerStats(ObjectGuid guid) const;
-    void        LoadAllPlayerStats();
-    void        SavePlayerStats(uint32 guidLow);
+    void        OnPlayerLogin(ObjectGuid guid);
+    void        OnPlayerLogout(ObjectGuid guid);
+
+    // Player hooks -> session alive / in-combat counters. Only queued here:
+    // the hooks can fire while _sessionMutex is held (ResurrectPlayer in the
+    // auto-rez pass), so the events are folded in by ApplyPresenceEvents.
+    void        QueuePlayerPresence(Player* player, bool online, bool alive, bool inCombat);
+
+    // Crash recovery (dm_checkpoints). RecoverPlayer is called on login and
+    // returns a player whose run was cut off by a restart.
+    void        WriteCheckpoints();
+    void        RecoverPlayer(Player* player);
+    void        ForgetCheckpoint(ObjectGuid playerGuid);     // run ended normally
+
+    void        FlushPlayerStats();
     void        UpdatePlayerStatsFromSession(const Session& session, bool success);
     void        SaveLeaderboardEntry(const Session& session);
+    void        LoadLeaderboards();
     std::vector<LeaderboardEntry> GetLeaderboard(uint32 mapId, uint32 difficultyId, uint32 limit = 10) const;
     std::vector<LeaderboardEntry> GetOverallLeaderboard(uint32 limit = 10) const;
+    std::vector<PersonalBest>     GetPersonalBests(ObjectGuid guid) const;
+    uint32      GetLeaderboardRank(uint32 mapId, uint32 difficultyId, uint32 clearTime) const;
+    uint32      GetOverallRank(uint32 clearTime) const;
 
     void Update(uint32 diff);
 
     uint32 GetActiveSessionCount() const { return static_cast<uint32>(_activeSessions.size()); }
+
+    // Population budget (.dm status)
+    uint32 GetLiveCreatureBudgetUsed() const { return _liveBudgetUsed.load(std::memory_order_relaxed); }
+    uint32 GetSmoothedWorldDiff()      const { return _worldDiffMs.load(std::memory_order_relaxed); }
     bool   CanCreateNewSession()   const;
 
+    MemoryReport GetMemoryReport() const;
+    void         ClearSpawnPointCache();
+
     // Env damage scaling
     bool  IsSessionCreature(ObjectGuid playerGuid, ObjectGuid creatureGuid);
     bool  IsSessionBoss(ObjectGuid playerGuid, ObjectGuid creatureGuid);
     float GetEnvironmentalDamageScale(ObjectGuid playerGuid);
     float GetSessionCreatureDamageScale(ObjectGuid playerGuid, ObjectGuid creatureGuid);
 
-    Position    GetDungeonEntrance(uint32 mapId);
+    Position    GetDungeonEntrance(uint32 mapId) const;
     std::string GetSessionStatusString(const Session* session) const;
     uint8       ComputeEffectiveLevel(Player* leader) const;
 
@@ -93,15 +179,18 @@ public:
                                        const std::vector<ObjectGuid>& playerGuids);
 
 private:
-    std::vector<SpawnPoint> GetSpawnPointsForMap(uint32 mapId);
-    uint32 SelectCreatureForTheme(const Theme* theme, bool isBoss);
-    uint32 SelectDungeonBoss(const Theme* theme);
+    SpawnPointList          GetSpawnPointsForMap(uint32 mapId);
+    std::vector<SpawnPoint> LoadSpawnPointsForMap(uint32 mapId);
+    uint32 SelectCreatureForTheme(const Theme* theme, bool isBoss, DMRng& rng);
+    uint32 SelectDungeonBoss(const Theme* theme, DMRng& rng);
 
     void   GiveGoldReward(Player* player, uint32 amount);
     void   GiveItemReward(Player* player, uint8 rewardLevel, uint8 quality);
     void   MailItemReward(Player* player, uint8 level, uint8 quality,
                           const std::string& subject, const std::string& body);
-    void   GiveKillXP(Session* session, bool isBoss, bool isElite);
+    void   QueueKillXP(Session& session, const PartyView& party, bool isBoss, bool isElite);
+    void   FlushKillCredit(Session& session, const PartyView& party);     // caller holds _sessionMutex
+    void   FlushKillCredit(Session& session);                             // before the session is erased
     uint32 SelectRewardItem(uint8 level, uint8 quality, uint32 playerClass);
     uint32 SelectLootItem(uint8 level, uint8 minQuality, uint8 maxQuality, bool equipmentOnly = false, uint32 playerClass = 0);
 
@@ -114,32 +203,80 @@ private:
     void LoadClassLevelStats();
     void LoadRewardItems();
     void LoadLootPool();
+    void LoadDungeonEntrances();
     void CleanupSession(Session& session);
+    void TrackSessionPlayer(ObjectGuid guid, uint32 sessionId);   // caller holds _sessionMutex
+    void UntrackSessionPlayer(ObjectGuid guid);                   // caller holds _sessionMutex
+    void CacheLeaderboardEntry(const LeaderboardEntry& entry);
+    void ReleaseCreatureBudget(Session& session);
+    void ReleaseInstance(uint32 instanceId);                      // caller holds _sessionMutex
+    void ApplyPresenceEvents();                                   // caller holds _sessionMutex
+
+    // Population helpers; caller holds _sessionMutex or owns the session
+    void   ApplyLevelAndStats(Session* session, Creature* c, float extraHpMult, float extraDmgMult, bool isBoss);
+    uint32 StreamPopulation(Session* session, InstanceMap* map, float progress);
 
     std::unordered_map<uint32, Session>      _activeSessions;
     std::unordered_map<uint32, uint32>       _instanceToSession;
     std::unordered_map<ObjectGuid, uint32>   _playerToSession;
     uint32 _nextSessionId = 1;
+    std::unordered_map<ObjectGuid, uint64>   _replaySeeds;   // leader -> seed for their next session
     mutable std::mutex _sessionMutex;
 
-    std::unordered_map<ObjectGuid, uint64>   _cooldowns;
-    mutable std::mutex _cooldownMutex;
-
-    std::unordered_map<uint32, PlayerStats>  _playerStats;
-    mutable std::mutex _statsMutex;
-
-    std::unordered_map<uint32, std::vector<CreaturePoolEntry>> _creaturesByType;
-    std::unordered_map<uint32, std::vector<CreaturePoolEntry>> _bossCreatures;
-    std::unordered_map<uint32, std::vector<CreaturePoolEntry>> _dungeonBossPool;
+    struct PresenceEvent
+    {
+        ObjectGuid Guid;
+        bool       Online;
+        bool       Alive;
+        bool       InCombat;
+    };
+    std::vector<PresenceEvent> _presenceEvents;
+    std::mutex _presenceMutex;
+
+    static constexpr uint32 SESSION_FILTER_SIZE = 4096;   // power of two
+    std::array<std::atomic<uint16>, SESSION_FILTER_SIZE> _sessionPlayerFilter{};
+
+    CooldownStore _cooldowns;      // flushed with the player stats
+
+    PlayerStatsCache<NormalStatsTraits> _playerStats;
+    uint32 _statsFlushTimer = 0;
+    CheckpointStore _checkpoints;
+    uint32 _checkpointTimer = 0;
+
+    // Top-N boards, sorted by clear time ascending
+    std::map<std::pair<uint32, uint32>, std::vector<LeaderboardEntry>> _mapLeaderboards;  // (map, difficulty)
+    std::vector<LeaderboardEntry> _overallLeaderboard;
+
+    // Each leader's best time per board and overall (sorted) for rank lookups,
+    // so they grow with new leaders rather than with every clear
+    std::map<std::pair<uint32, uint32>, std::vector<uint32>> _boardClearTimes;
+    std::vector<uint32> _overallClearTimes;
+    std::unordered_map<uint32, std::map<std::pair<uint32, uint32>, uint32>> _personalBests;  // guidLow -> board -> time
+    mutable std::mutex _leaderboardMutex;
+    static constexpr uint32 LEADERBOARD_CACHE_SIZE = 25;
+
+    CreaturePool _creaturesByType;
+    CreaturePool _bossCreatures;
+    CreaturePool _dungeonBossPool;
 
     std::map<std::pair<uint8,uint8>, ClassLevelStatEntry> _classLevelStats;
     std::unordered_map<uint32, std::vector<ObjectGuid>> _instanceCreatureGuids;
 
+    std::unordered_map<uint32, SpawnPointList> _spawnPointCache;   // mapId -> shared points
+    mutable std::mutex _spawnPointMutex;
+
+    std::unordered_map<uint32, Position> _dungeonEntrances;   // mapId -> areatrigger target
+
     std::vector<RewardItem> _rewardItems;
     std::vector<LootPoolItem> _lootPool;
 
     uint32 _updateTimer = 0;
     static constexpr uint32 UPDATE_INTERVAL = 1000;
+
+    // Population budget; charged at populate, released when the session goes
+    std::atomic<uint32> _liveBudgetUsed{0};
+    std::atomic<uint32> _worldDiffMs{0};
+    float  _worldDiffAvg = 0.0f;               // world thread only
 };
 
 } // namespace DungeonMaster
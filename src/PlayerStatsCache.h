@@ -0,0 +1,246 @@
+/*
+ * mod-dungeon-master — PlayerStatsCache.h
+ * Lazily loaded, LRU-bounded per-player stats with write-behind persistence.
+ */
+
+#ifndef DM_PLAYER_STATS_CACHE_H
+#define DM_PLAYER_STATS_CACHE_H
+
+#include "DatabaseEnv.h"
+#include "QueryCallback.h"
+#include "AsyncCallbackProcessor.h"
+#include "DMMemory.h"
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace DungeonMaster
+{
+
+// Traits supply the table-specific parts:
+//   using Stats = ...;
+//   static std::string SelectQuery(uint32 guidLow);
+//   static void        Read(Field* fields, Stats& out);
+//   static std::string ReplaceQuery(uint32 guidLow, const Stats& stats);
+//   static std::string MergeQuery(uint32 guidLow, const Stats& delta);   // upsert folding a delta into the row
+//   static void        Merge(Stats& into, const Stats& delta);
+//
+// Rows are fetched asynchronously on login (or first session), kept while
+// the player is online, and become LRU eviction candidates on logout.
+// Changes are only written on Flush(): resident rows as a full REPLACE,
+// non-resident players as a delta upsert so the row never has to be read.
+// Load() and ProcessCallbacks() must be called from the world thread.
+template<typename Traits>
+class PlayerStatsCache
+{
+public:
+    using Stats = typename Traits::Stats;
+
+    void SetCapacity(uint32 capacity)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _capacity = capacity;
+        Trim();
+    }
+
+    void Load(uint32 guidLow)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _entries.find(guidLow);
+            if (it != _entries.end())
+            {
+                Touch(guidLow, it->second, true);
+                return;
+            }
+
+            Entry& e = _entries[guidLow];
+            e.Online = true;
+
+            // Deltas written while the player was not resident have not
+            // been flushed yet; fold them in once the row arrives
+            auto dt = _deltas.find(guidLow);
+            if (dt != _deltas.end())
+            {
+                e.Pending    = dt->second;
+                e.HasPending = true;
+                _deltas.erase(dt);
+            }
+        }
+
+        _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery(Traits::SelectQuery(guidLow))
+            .WithCallback([this, guidLow](QueryResult result) { OnLoaded(guidLow, result); }));
+    }
+
+    void SetOffline(uint32 guidLow)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(guidLow);
+        if (it == _entries.end())
+            return;
+
+        Touch(guidLow, it->second, false);
+        Trim();
+    }
+
+    Stats Get(uint32 guidLow) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(guidLow);
+        if (it == _entries.end() || !it->second.Loaded)
+            return {};
+        return it->second.Data;
+    }
+
+    void Apply(uint32 guidLow, const Stats& delta)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(guidLow);
+        if (it == _entries.end())
+        {
+            Traits::Merge(_deltas[guidLow], delta);
+            return;
+        }
+
+        Entry& e = it->second;
+        if (e.Loaded)
+        {
+            Traits::Merge(e.Data, delta);
+            e.Dirty = true;
+        }
+        else
+        {
+            Traits::Merge(e.Pending, delta);
+            e.HasPending = true;
+        }
+    }
+
+    // Writes every dirty row and pending delta in a single transaction
+    void Flush()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        CharacterDatabaseTransaction trans;
+        auto append = [&trans](const std::string& sql)
+        {
+            if (!trans)
+                trans = CharacterDatabase.BeginTransaction();
+            trans->Append(sql);
+        };
+
+        for (auto& [guidLow, e] : _entries)
+        {
+            if (!e.Dirty) continue;
+            append(Traits::ReplaceQuery(guidLow, e.Data));
+            e.Dirty = false;
+        }
+
+        for (const auto& [guidLow, delta] : _deltas)
+            append(Traits::MergeQuery(guidLow, delta));
+        _deltas.clear();
+
+        if (trans)
+            CharacterDatabase.CommitTransaction(trans);
+
+        Trim();
+    }
+
+    void ProcessCallbacks() { _queryProcessor.ProcessReadyCallbacks(); }
+
+    uint32 GetResidentCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return static_cast<uint32>(_entries.size());
+    }
+
+    uint64 GetHeapBytes() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return DungeonMaster::HeapBytes(_entries) + DungeonMaster::HeapBytes(_deltas)
+             + static_cast<uint64>(_lru.size()) * (sizeof(uint32) + 2 * sizeof(void*));
+    }
+
+private:
+    struct Entry
+    {
+        Stats Data;
+        Stats Pending;                       // changes made while the load was in flight
+        bool  Loaded     = false;
+        bool  HasPending = false;
+        bool  Dirty      = false;
+        bool  Online     = false;
+        bool  InLru      = false;
+        std::list<uint32>::iterator LruPos;
+    };
+
+    void OnLoaded(uint32 guidLow, QueryResult result)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(guidLow);
+        if (it == _entries.end())
+            return;
+
+        Entry& e = it->second;
+        if (result)
+            Traits::Read(result->Fetch(), e.Data);
+        if (e.HasPending)
+        {
+            Traits::Merge(e.Data, e.Pending);
+            e.Pending    = {};
+            e.HasPending = false;
+            e.Dirty      = true;
+        }
+        e.Loaded = true;
+        Trim();
+    }
+
+    // Online players are pinned; offline ones queue for eviction, most recent first
+    void Touch(uint32 guidLow, Entry& e, bool online)
+    {
+        if (e.InLru)
+        {
+            _lru.erase(e.LruPos);
+            e.InLru = false;
+        }
+
+        e.Online = online;
+        if (!online)
+        {
+            _lru.push_front(guidLow);
+            e.LruPos = _lru.begin();
+            e.InLru  = true;
+        }
+    }
+
+    // Evicts least-recently-used offline rows; dirty or loading rows wait for the next flush
+    void Trim()
+    {
+        for (auto it = _lru.end(); it != _lru.begin() && _entries.size() > _capacity; )
+        {
+            --it;
+            auto et = _entries.find(*it);
+            if (et == _entries.end())
+            {
+                it = _lru.erase(it);
+                continue;
+            }
+            if (!et->second.Loaded || et->second.Dirty)
+                continue;
+
+            _entries.erase(et);
+            it = _lru.erase(it);
+        }
+    }
+
+    std::unordered_map<uint32, Entry> _entries;
+    std::unordered_map<uint32, Stats> _deltas;   // guidLow -> unflushed change for non-resident players
+    std::list<uint32>                 _lru;
+    uint32                            _capacity = 1000;
+    QueryCallbackProcessor            _queryProcessor;
+    mutable std::mutex                _mutex;
+};
+
+} // namespace DungeonMaster
+
+#endif // DM_PLAYER_STATS_CACHE_H
@@ -6,6 +6,10 @@
 #include "RoguelikeMgr.h"
 #include "DungeonMasterMgr.h"
 #include "DMConfig.h"
+#include "DMPerf.h"
+#include "DMSelection.h"
+#include "DMRandom.h"
+#include "DMChat.h"
 #include "Player.h"
 #include "Group.h"
 #include "Creature.h"
@@ -16,7 +20,6 @@
 #include "Log.h"
 #include "SpellAuras.h"
 #include "SpellAuraEffects.h"
-#include <random>
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
@@ -24,13 +27,11 @@
 namespace DungeonMaster
 {
 
-// RNG helpers (thread-local for safety)
-static thread_local std::mt19937 tRng{ std::random_device{}() };
-
+// RNG helpers (per-thread stream, see DMRandom.h)
 template<typename T>
 static T RandInt(T lo, T hi)
 {
-    return std::uniform_int_distribution<T>(lo, hi)(tRng);
+    return ThreadRng().Range<T>(lo, hi);
 }
 
 // Singleton
@@ -47,7 +48,8 @@ RoguelikeMgr* RoguelikeMgr::Instance()
 void RoguelikeMgr::Initialize()
 {
     BuildAffixPool();
-    LoadAllRoguelikePlayerStats();
+    LoadRoguelikeLeaderboards();
+    _roguelikeStats.SetCapacity(sDMConfig->GetStatsCacheSize());
     LOG_INFO("module", "RoguelikeMgr: Initialized — {} affix definitions, {} buff pool entries.",
         _affixDefs.size(), sDMConfig->GetRoguelikeBuffPool().size());
 }
@@ -228,7 +230,10 @@ bool RoguelikeMgr::StartRun(Player* leader, uint32 difficultyId, uint32 themeId,
 
     // Clear cooldowns for all party members so they can enter
     for (const auto& pd : run.Players)
+    {
         sDungeonMasterMgr->ClearCooldown(pd.PlayerGuid);
+        _roguelikeStats.Load(pd.PlayerGuid.GetCounter());  // no-op if already resident
+    }
 
     // Create the DM session with the player's scaling choice
     Session* session = sDungeonMasterMgr->CreateSession(
@@ -287,25 +292,16 @@ bool RoguelikeMgr::StartRun(Player* leader, uint32 difficultyId, uint32 themeId,
         "Theme: |cFF00FF00%s|r — How far can you go?",
         leader->GetName().c_str(),
         theme ? theme->Name.c_str() : "Random");
-
-    for (const auto& pd : run.Players)
-        if (Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid))
-            ChatHandler(p->GetSession()).SendSysMessage(buf);
+    AnnounceToRun(run, buf);
 
     // Announce active affixes if any are present at tier 1
-    if (!run.ActiveAffixes.empty())
+    if (!run.AffixNames.empty())
     {
-        std::string affixNames = GetActiveAffixNames(run.RunId);
-        if (!affixNames.empty())
-        {
-            char affixBuf[512];
-            snprintf(affixBuf, sizeof(affixBuf),
-                "|cFF00FFFF[Roguelike]|r Active affixes: %s",
-                affixNames.c_str());
-            for (const auto& pd : run.Players)
-                if (Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid))
-                    ChatHandler(p->GetSession()).SendSysMessage(affixBuf);
-        }
+        char affixBuf[512];
+        snprintf(affixBuf, sizeof(affixBuf),
+            "|cFF00FFFF[Roguelike]|r Active affixes: %s",
+            run.AffixNames.c_str());
+        AnnounceToRun(run, affixBuf);
     }
 
     LOG_INFO("module", "RoguelikeMgr: Run {} started — leader {}, party {}, theme {}, map {}",
@@ -345,8 +341,7 @@ void RoguelikeMgr::OnDungeonCompleted(uint32 runId, uint32 sessionId)
             sessionMobsKilled   = session->MobsKilled;
             sessionBossesKilled = session->BossesKilled;
             sessionMapId        = session->MapId;
-            for (const auto& pd : session->Players)
-                sessionDeaths += pd.Deaths;
+            sessionDeaths       = session->PartyDeaths;
 
             // Distribute per-floor rewards while session pointer is still valid
             sDungeonMasterMgr->DistributeRewards(session);
@@ -387,23 +382,10 @@ void RoguelikeMgr::OnDungeonCompleted(uint32 runId, uint32 sessionId)
         run->DungeonsCleared, run->CurrentTier);
 
     // Append active affixes
-    std::string affixStr;
-    for (RoguelikeAffix afxId : run->ActiveAffixes)
-    {
-        for (const auto& def : _affixDefs)
-        {
-            if (def.Id == afxId)
-            {
-                if (!affixStr.empty()) affixStr += ", ";
-                affixStr += "|cFFFF8800" + def.Name + "|r";
-                break;
-            }
-        }
-    }
-    if (!affixStr.empty())
+    if (!run->AffixNames.empty())
     {
         size_t len = strlen(buf);
-        snprintf(buf + len, sizeof(buf) - len, " Affixes: %s", affixStr.c_str());
+        snprintf(buf + len, sizeof(buf) - len, " Affixes: %s", run->AffixNames.c_str());
     }
 
     AnnounceToRun(*run, buf);
@@ -442,8 +424,7 @@ void RoguelikeMgr::OnPartyWipe(uint32 runId)
     {
         run->TotalMobsKilled   += session->MobsKilled;
         run->TotalBossesKilled += session->BossesKilled;
-        for (const auto& pd : session->Players)
-            run->TotalDeaths += pd.Deaths;
+        run->TotalDeaths       += session->PartyDeaths;
     }
 
     // Announce the wipe
@@ -499,9 +480,12 @@ void RoguelikeMgr::OnPartyWipe(uint32 runId)
     // Teleport everyone back to their original positions
     TeleportRunPlayersOut(*run);
 
-    // Set cooldowns
+    // Set cooldowns; the run ended normally, so nothing is left to recover
     for (const auto& pd : run->Players)
+    {
         sDungeonMasterMgr->SetCooldown(pd.PlayerGuid);
+        sDungeonMasterMgr->ForgetCheckpoint(pd.PlayerGuid);
+    }
 
     // Save before erase invalidates the pointer
     uint32 savedTier    = run->CurrentTier;
@@ -600,9 +584,12 @@ void RoguelikeMgr::EndRun(uint32 runId, bool announceResults)
     // Teleport out
     TeleportRunPlayersOut(*run);
 
-    // Set cooldowns
+    // Set cooldowns; the run ended normally, so nothing is left to recover
     for (const auto& pd : run->Players)
+    {
         sDungeonMasterMgr->SetCooldown(pd.PlayerGuid);
+        sDungeonMasterMgr->ForgetCheckpoint(pd.PlayerGuid);
+    }
 
     // Save before erase invalidates the pointer
     uint32 savedTier    = run->CurrentTier;
@@ -701,23 +688,8 @@ float RoguelikeMgr::GetTierHealthMultiplier(uint32 runId) const
     auto it = _activeRuns.find(runId);
     if (it == _activeRuns.end()) return 1.0f;
 
-    uint32 tier = it->second.CurrentTier;
-    if (tier <= 1) return 1.0f;
-
-    float baseScale = sDMConfig->GetRoguelikeHpScaling();
-    uint32 expThresh = sDMConfig->GetRoguelikeExpThreshold();
-    float  expFactor = sDMConfig->GetRoguelikeExpFactor();
-
-    if (tier <= expThresh)
-        return 1.0f + (tier - 1) * baseScale;
-
-    // Exponential scaling past threshold
-    float linearPart = (expThresh - 1) * baseScale;
-    float expPart    = 0.0f;
-    for (uint32 t = expThresh; t < tier; ++t)
-        expPart += baseScale * std::pow(expFactor, static_cast<float>(t - expThresh + 1));
-
-    return 1.0f + linearPart + expPart;
+    return TierScaling(it->second.CurrentTier, sDMConfig->GetRoguelikeHpScaling(),
+        sDMConfig->GetRoguelikeExpThreshold(), sDMConfig->GetRoguelikeExpFactor());
 }
 
 float RoguelikeMgr::GetTierDamageMultiplier(uint32 runId) const
@@ -726,22 +698,8 @@ float RoguelikeMgr::GetTierDamageMultiplier(uint32 runId) const
     auto it = _activeRuns.find(runId);
     if (it == _activeRuns.end()) return 1.0f;
 
-    uint32 tier = it->second.CurrentTier;
-    if (tier <= 1) return 1.0f;
-
-    float baseScale = sDMConfig->GetRoguelikeDmgScaling();
-    uint32 expThresh = sDMConfig->GetRoguelikeExpThreshold();
-    float  expFactor = sDMConfig->GetRoguelikeExpFactor();
-
-    if (tier <= expThresh)
-        return 1.0f + (tier - 1) * baseScale;
-
-    float linearPart = (expThresh - 1) * baseScale;
-    float expPart    = 0.0f;
-    for (uint32 t = expThresh; t < tier; ++t)
-        expPart += baseScale * std::pow(expFactor, static_cast<float>(t - expThresh + 1));
-
-    return 1.0f + linearPart + expPart;
+    return TierScaling(it->second.CurrentTier, sDMConfig->GetRoguelikeDmgScaling(),
+        sDMConfig->GetRoguelikeExpThreshold(), sDMConfig->GetRoguelikeExpFactor());
 }
 
 float RoguelikeMgr::GetTierArmorMultiplier(uint32 runId) const
@@ -750,11 +708,8 @@ float RoguelikeMgr::GetTierArmorMultiplier(uint32 runId) const
     auto it = _activeRuns.find(runId);
     if (it == _activeRuns.end()) return 1.0f;
 
-    uint32 tier = it->second.CurrentTier;
-    if (tier <= 1) return 1.0f;
-
-    float baseScale = sDMConfig->GetRoguelikeArmorScaling();
-    return 1.0f + (tier - 1) * baseScale;   // Armor scales linearly only
+    // Armor scales linearly only
+    return LinearTierScaling(it->second.CurrentTier, sDMConfig->GetRoguelikeArmorScaling());
 }
 
 void RoguelikeMgr::GetAffixMultipliers(
@@ -803,22 +758,7 @@ std::string RoguelikeMgr::GetActiveAffixNames(uint32 runId) const
 {
     std::lock_guard<std::mutex> lock(_runMutex);
     auto it = _activeRuns.find(runId);
-    if (it == _activeRuns.end()) return "";
-
-    std::string result;
-    for (RoguelikeAffix afxId : it->second.ActiveAffixes)
-    {
-        for (const auto& def : _affixDefs)
-        {
-            if (def.Id == afxId)
-            {
-                if (!result.empty()) result += ", ";
-                result += "|cFFFF8800" + def.Name + "|r";
-                break;
-            }
-        }
-    }
-    return result;
+    return it != _activeRuns.end() ? it->second.AffixNames : std::string();
 }
 
 // Buff system (+10% all stats per stack via direct stat modification)
@@ -896,6 +836,7 @@ void RoguelikeMgr::RemoveBuffStacks(Player* player, uint32 runId)
 void RoguelikeMgr::SelectAffixesForTier(RoguelikeRun& run)
 {
     run.ActiveAffixes.clear();
+    run.AffixNames.clear();
 
     uint32 affixStart  = sDMConfig->GetRoguelikeAffixStartTier();
     uint32 secondAffix = sDMConfig->GetRoguelikeSecondAffixTier();
@@ -916,10 +857,24 @@ void RoguelikeMgr::SelectAffixesForTier(RoguelikeRun& run)
         if (def.Id != AFFIX_NONE)
             pool.push_back(def.Id);
 
-    std::shuffle(pool.begin(), pool.end(), tRng);
+    std::shuffle(pool.begin(), pool.end(), ThreadRng());
 
     for (uint32 i = 0; i < numAffixes && i < pool.size(); ++i)
         run.ActiveAffixes.push_back(pool[i]);
+
+    // Formatted once per tier for every announcement that lists them
+    for (RoguelikeAffix afxId : run.ActiveAffixes)
+    {
+        for (const auto& def : _affixDefs)
+        {
+            if (def.Id == afxId)
+            {
+                if (!run.AffixNames.empty()) run.AffixNames += ", ";
+                run.AffixNames += "|cFFFF8800" + def.Name + "|r";
+                break;
+            }
+        }
+    }
 }
 
 // DUNGEON SELECTION
@@ -1082,31 +1037,40 @@ void RoguelikeMgr::TeleportRunPlayersOut(RoguelikeRun& run)
 
 // ANNOUNCEMENTS
 
+// One SMSG_MESSAGECHAT built for the whole run
 void RoguelikeMgr::AnnounceToRun(const RoguelikeRun& run, const char* msg)
 {
+    ChatBroadcast broadcast(msg);
     for (const auto& pd : run.Players)
-        if (Player* p = ObjectAccessor::FindPlayer(pd.PlayerGuid))
-            if (p->GetSession())
-                ChatHandler(p->GetSession()).SendSysMessage(msg);
+        broadcast.SendTo(ObjectAccessor::FindPlayer(pd.PlayerGuid));
 }
 
 void RoguelikeMgr::AnnounceCountdown(const RoguelikeRun& run, uint32 remainingSec)
 {
-    char buf[128];
-    snprintf(buf, sizeof(buf),
-        "|cFF00FFFF[Roguelike]|r Next dungeon in |cFFFFFFFF%u|r second%s...",
-        remainingSec, remainingSec != 1 ? "s" : "");
-    AnnounceToRun(run, buf);
+    const ChatBroadcast& countdown = ChatBroadcast::Countdown(remainingSec);
+    for (const auto& pd : run.Players)
+        countdown.SendTo(ObjectAccessor::FindPlayer(pd.PlayerGuid));
 }
 
 
 void RoguelikeMgr::Update(uint32 diff)
 {
+    // ---- Stats cache: async loads + write-behind ----
+    _roguelikeStats.ProcessCallbacks();
+    _statsFlushTimer += diff;
+    if (_statsFlushTimer >= sDMConfig->GetStatsFlushInterval() * 1000)
+    {
+        _statsFlushTimer = 0;
+        FlushRoguelikePlayerStats();
+    }
+
     _updateTimer += diff;
     if (_updateTimer < UPDATE_INTERVAL)
         return;
     _updateTimer = 0;
 
+    PerfScope perfScope(PERF_ROGUELIKE_UPDATE);
+
     std::vector<uint32> toAbandon;
 
     {
@@ -1162,6 +1126,34 @@ void RoguelikeMgr::Update(uint32 diff)
 
 // LEADERBOARD
 
+// Board orderings — must match the ORDER BY clauses in LoadRoguelikeLeaderboards
+static bool RanksAboveByTier(const RoguelikeLeaderboardEntry& a, const RoguelikeLeaderboardEntry& b)
+{
+    if (a.TierReached != b.TierReached)         return a.TierReached > b.TierReached;
+    if (a.DungeonsCleared != b.DungeonsCleared) return a.DungeonsCleared > b.DungeonsCleared;
+    return a.RunDuration < b.RunDuration;
+}
+
+static bool RanksAboveByFloors(const RoguelikeLeaderboardEntry& a, const RoguelikeLeaderboardEntry& b)
+{
+    if (a.DungeonsCleared != b.DungeonsCleared) return a.DungeonsCleared > b.DungeonsCleared;
+    if (a.TierReached != b.TierReached)         return a.TierReached > b.TierReached;
+    return a.RunDuration < b.RunDuration;
+}
+
+template<typename Cmp>
+static void InsertTopN(std::vector<RoguelikeLeaderboardEntry>& board,
+                       const RoguelikeLeaderboardEntry& e, size_t cap, Cmp cmp)
+{
+    auto it = std::upper_bound(board.begin(), board.end(), e, cmp);
+    if (static_cast<size_t>(it - board.begin()) >= cap)
+        return;
+
+    board.insert(it, e);
+    if (board.size() > cap)
+        board.pop_back();
+}
+
 void RoguelikeMgr::SaveRoguelikeLeaderboard(const RoguelikeRun& run)
 {
     uint32 duration = 0;
@@ -1195,153 +1187,236 @@ void RoguelikeMgr::SaveRoguelikeLeaderboard(const RoguelikeRun& run)
         duration, partySize);
     CharacterDatabase.Execute(query);
 
+    RoguelikeLeaderboardEntry e;
+    e.Guid            = run.LeaderGuid.GetCounter();
+    e.CharName        = leaderName;
+    e.TierReached     = run.CurrentTier;
+    e.DungeonsCleared = run.DungeonsCleared;
+    e.TotalKills      = run.TotalMobsKilled + run.TotalBossesKilled;
+    e.TotalBosses     = run.TotalBossesKilled;
+    e.TotalDeaths     = run.TotalDeaths;
+    e.RunDuration     = duration;
+    e.PartySize       = partySize;
+    {
+        std::lock_guard<std::mutex> lock(_leaderboardMutex);
+        InsertTopN(_tierLeaderboard, e, LEADERBOARD_CACHE_SIZE, RanksAboveByTier);
+        InsertTopN(_floorsLeaderboard, e, LEADERBOARD_CACHE_SIZE, RanksAboveByFloors);
+    }
+
     // Also update per-player roguelike stats
     UpdateRoguelikePlayerStats(run);
 }
 
-std::vector<RoguelikeLeaderboardEntry> RoguelikeMgr::GetRoguelikeLeaderboard(
-    uint32 limit, bool sortByFloors) const
+void RoguelikeMgr::LoadRoguelikeLeaderboards()
 {
-    std::vector<RoguelikeLeaderboardEntry> entries;
+    auto loadBoard = [](const char* orderBy, std::vector<RoguelikeLeaderboardEntry>& board)
+    {
+        board.clear();
 
-    char query[512];
-    if (sortByFloors)
-        snprintf(query, sizeof(query),
-            "SELECT id, guid, char_name, tier_reached, dungeons_cleared, "
-            "total_kills, total_bosses, total_deaths, run_duration, party_size "
-            "FROM dm_roguelike_leaderboard "
-            "ORDER BY dungeons_cleared DESC, tier_reached DESC, run_duration ASC "
-            "LIMIT %u", limit);
-    else
+        char query[512];
         snprintf(query, sizeof(query),
             "SELECT id, guid, char_name, tier_reached, dungeons_cleared, "
             "total_kills, total_bosses, total_deaths, run_duration, party_size "
             "FROM dm_roguelike_leaderboard "
-            "ORDER BY tier_reached DESC, dungeons_cleared DESC, run_duration ASC "
-            "LIMIT %u", limit);
-
-    QueryResult result = CharacterDatabase.Query(query);
-    if (!result) return entries;
-
-    do
-    {
-        Field* f = result->Fetch();
-        RoguelikeLeaderboardEntry e;
-        e.Id              = f[0].Get<uint32>();
-        e.Guid            = f[1].Get<uint32>();
-        e.CharName        = f[2].Get<std::string>();
-        e.TierReached     = f[3].Get<uint32>();
-        e.DungeonsCleared = f[4].Get<uint32>();
-        e.TotalKills      = f[5].Get<uint32>();
-        e.TotalBosses     = f[6].Get<uint32>();
-        e.TotalDeaths     = f[7].Get<uint32>();
-        e.RunDuration     = f[8].Get<uint32>();
-        e.PartySize       = f[9].Get<uint8>();
-        entries.push_back(e);
-    } while (result->NextRow());
-
-    return entries;
+            "ORDER BY %s LIMIT %u", orderBy, LEADERBOARD_CACHE_SIZE);
+
+        QueryResult result = CharacterDatabase.Query(query);
+        if (!result) return;
+
+        do
+        {
+            Field* f = result->Fetch();
+            RoguelikeLeaderboardEntry e;
+            e.Id              = f[0].Get<uint32>();
+            e.Guid            = f[1].Get<uint32>();
+            e.CharName        = f[2].Get<std::string>();
+            e.TierReached     = f[3].Get<uint32>();
+            e.DungeonsCleared = f[4].Get<uint32>();
+            e.TotalKills      = f[5].Get<uint32>();
+            e.TotalBosses     = f[6].Get<uint32>();
+            e.TotalDeaths     = f[7].Get<uint32>();
+            e.RunDuration     = f[8].Get<uint32>();
+            e.PartySize       = f[9].Get<uint8>();
+            board.push_back(e);
+        } while (result->NextRow());
+    };
+
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    loadBoard("tier_reached DESC, dungeons_cleared DESC, run_duration ASC, id ASC", _tierLeaderboard);
+    loadBoard("dungeons_cleared DESC, tier_reached DESC, run_duration ASC, id ASC", _floorsLeaderboard);
+
+    LOG_INFO("module", "RoguelikeMgr: Cached {} tier / {} floor leaderboard entries.",
+        _tierLeaderboard.size(), _floorsLeaderboard.size());
+}
+
+std::vector<RoguelikeLeaderboardEntry> RoguelikeMgr::GetRoguelikeLeaderboard(
+    uint32 limit, bool sortByFloors) const
+{
+    std::lock_guard<std::mutex> lock(_leaderboardMutex);
+    const auto& board = sortByFloors ? _floorsLeaderboard : _tierLeaderboard;
+    size_t n = std::min<size_t>(board.size(), limit);
+    return std::vector<RoguelikeLeaderboardEntry>(board.begin(), board.begin() + n);
 }
 
 // ---------------------------------------------------------------------------
 // Roguelike Player Stats
 // ---------------------------------------------------------------------------
 
-void RoguelikeMgr::LoadAllRoguelikePlayerStats()
+std::string RoguelikeStatsTraits::SelectQuery(uint32 guidLow)
 {
-    std::lock_guard<std::mutex> lock(_rlStatsMutex);
-    _roguelikeStats.clear();
-
-    QueryResult result = CharacterDatabase.Query(
-        "SELECT guid, total_runs, highest_tier, most_floors_cleared, "
+    char query[256];
+    snprintf(query, sizeof(query),
+        "SELECT total_runs, highest_tier, most_floors_cleared, "
         "total_floors_cleared, total_mobs_killed, total_bosses_killed, "
         "total_deaths, longest_run_time "
-        "FROM dm_roguelike_player_stats");
+        "FROM dm_roguelike_player_stats WHERE guid = %u", guidLow);
+    return query;
+}
 
-    if (!result)
-    {
-        LOG_INFO("module", "RoguelikeMgr: No roguelike player stats found.");
-        return;
-    }
+void RoguelikeStatsTraits::Read(Field* f, RoguelikePlayerStats& ps)
+{
+    ps.TotalRuns          = f[0].Get<uint32>();
+    ps.HighestTier        = f[1].Get<uint32>();
+    ps.MostFloorsCleared  = f[2].Get<uint32>();
+    ps.TotalFloorsCleared = f[3].Get<uint32>();
+    ps.TotalMobsKilled    = f[4].Get<uint32>();
+    ps.TotalBossesKilled  = f[5].Get<uint32>();
+    ps.TotalDeaths        = f[6].Get<uint32>();
+    ps.LongestRunTime     = f[7].Get<uint32>();
+}
 
-    uint32 count = 0;
-    do
-    {
-        Field* f = result->Fetch();
-        uint32 guidLow = f[0].Get<uint32>();
+std::string RoguelikeStatsTraits::ReplaceQuery(uint32 guidLow, const RoguelikePlayerStats& ps)
+{
+    char query[512];
+    snprintf(query, sizeof(query),
+        "REPLACE INTO dm_roguelike_player_stats "
+        "(guid, total_runs, highest_tier, most_floors_cleared, "
+        "total_floors_cleared, total_mobs_killed, total_bosses_killed, "
+        "total_deaths, longest_run_time) "
+        "VALUES (%u, %u, %u, %u, %u, %u, %u, %u, %u)",
+        guidLow, ps.TotalRuns, ps.HighestTier, ps.MostFloorsCleared,
+        ps.TotalFloorsCleared, ps.TotalMobsKilled, ps.TotalBossesKilled,
+        ps.TotalDeaths, ps.LongestRunTime);
+    return query;
+}
+
+std::string RoguelikeStatsTraits::MergeQuery(uint32 guidLow, const RoguelikePlayerStats& d)
+{
+    char query[1024];
+    snprintf(query, sizeof(query),
+        "INSERT INTO dm_roguelike_player_stats "
+        "(guid, total_runs, highest_tier, most_floors_cleared, "
+        "total_floors_cleared, total_mobs_killed, total_bosses_killed, "
+        "total_deaths, longest_run_time) "
+        "VALUES (%u, %u, %u, %u, %u, %u, %u, %u, %u) "
+        "ON DUPLICATE KEY UPDATE "
+        "total_runs = total_runs + %u, highest_tier = GREATEST(highest_tier, %u), "
+        "most_floors_cleared = GREATEST(most_floors_cleared, %u), "
+        "total_floors_cleared = total_floors_cleared + %u, "
+        "total_mobs_killed = total_mobs_killed + %u, total_bosses_killed = total_bosses_killed + %u, "
+        "total_deaths = total_deaths + %u, longest_run_time = GREATEST(longest_run_time, %u)",
+        guidLow, d.TotalRuns, d.HighestTier, d.MostFloorsCleared,
+        d.TotalFloorsCleared, d.TotalMobsKilled, d.TotalBossesKilled,
+        d.TotalDeaths, d.LongestRunTime,
+        d.TotalRuns, d.HighestTier, d.MostFloorsCleared, d.TotalFloorsCleared,
+        d.TotalMobsKilled, d.TotalBossesKilled, d.TotalDeaths, d.LongestRunTime);
+    return query;
+}
 
-        RoguelikePlayerStats ps;
-        ps.TotalRuns          = f[1].Get<uint32>();
-        ps.HighestTier        = f[2].Get<uint32>();
-        ps.MostFloorsCleared  = f[3].Get<uint32>();
-        ps.TotalFloorsCleared = f[4].Get<uint32>();
-        ps.TotalMobsKilled    = f[5].Get<uint32>();
-        ps.TotalBossesKilled  = f[6].Get<uint32>();
-        ps.TotalDeaths        = f[7].Get<uint32>();
-        ps.LongestRunTime     = f[8].Get<uint32>();
+void RoguelikeStatsTraits::Merge(RoguelikePlayerStats& ps, const RoguelikePlayerStats& d)
+{
+    ps.TotalRuns          += d.TotalRuns;
+    ps.HighestTier         = std::max(ps.HighestTier, d.HighestTier);
+    ps.MostFloorsCleared   = std::max(ps.MostFloorsCleared, d.MostFloorsCleared);
+    ps.TotalFloorsCleared += d.TotalFloorsCleared;
+    ps.TotalMobsKilled    += d.TotalMobsKilled;
+    ps.TotalBossesKilled  += d.TotalBossesKilled;
+    ps.TotalDeaths        += d.TotalDeaths;
+    ps.LongestRunTime      = std::max(ps.LongestRunTime, d.LongestRunTime);
+}
 
-        _roguelikeStats[guidLow] = ps;
-        ++count;
-    } while (result->NextRow());
+void RoguelikeMgr::OnPlayerLogin(ObjectGuid guid)
+{
+    _roguelikeStats.Load(guid.GetCounter());
+}
 
-    LOG_INFO("module", "RoguelikeMgr: Loaded roguelike stats for {} players.", count);
+void RoguelikeMgr::OnPlayerLogout(ObjectGuid guid)
+{
+    _roguelikeStats.SetOffline(guid.GetCounter());
 }
 
-RoguelikePlayerStats RoguelikeMgr::GetRoguelikePlayerStats(ObjectGuid guid) const
+void RoguelikeMgr::FlushRoguelikePlayerStats()
 {
-    std::lock_guard<std::mutex> lock(_rlStatsMutex);
-    uint32 guidLow = guid.GetCounter();
-    auto it = _roguelikeStats.find(guidLow);
-    if (it != _roguelikeStats.end())
-        return it->second;
-    return {};
+    _roguelikeStats.Flush();
 }
 
-void RoguelikeMgr::UpdateRoguelikePlayerStats(const RoguelikeRun& run)
+void RoguelikeMgr::AppendRunCheckpoints(std::vector<PlayerCheckpoint>& rows) const
 {
-    uint32 duration = 0;
-    if (GameTime::GetGameTime().count() > static_cast<time_t>(run.RunStartTime))
-        duration = static_cast<uint32>(GameTime::GetGameTime().count() - run.RunStartTime);
+    std::unordered_map<uint32, size_t> rowOf;     // guid low -> index in rows
+    for (size_t i = 0; i < rows.size(); ++i)
+        rowOf[rows[i].Guid] = i;
 
-    for (const auto& pd : run.Players)
+    std::lock_guard<std::mutex> lock(_runMutex);
+    for (const auto& [runId, run] : _activeRuns)
     {
-        uint32 guidLow = pd.PlayerGuid.GetCounter();
-
+        std::string affixes;
+        for (RoguelikeAffix afxId : run.ActiveAffixes)
         {
-            std::lock_guard<std::mutex> lock(_rlStatsMutex);
-            auto& ps = _roguelikeStats[guidLow];
-            ps.TotalRuns++;
-            if (run.CurrentTier > ps.HighestTier)
-                ps.HighestTier = run.CurrentTier;
-            if (run.DungeonsCleared > ps.MostFloorsCleared)
-                ps.MostFloorsCleared = run.DungeonsCleared;
-            ps.TotalFloorsCleared += run.DungeonsCleared;
-            ps.TotalMobsKilled    += run.TotalMobsKilled;
-            ps.TotalBossesKilled  += run.TotalBossesKilled;
-            ps.TotalDeaths        += run.TotalDeaths;
-            if (duration > ps.LongestRunTime)
-                ps.LongestRunTime = duration;
+            if (!affixes.empty()) affixes += ',';
+            affixes += std::to_string(static_cast<uint32>(afxId));
         }
 
-        // Persist
-        RoguelikePlayerStats ps;
+        for (const auto& pd : run.Players)
         {
-            std::lock_guard<std::mutex> lock(_rlStatsMutex);
-            ps = _roguelikeStats[guidLow];
-        }
+            auto it = rowOf.find(pd.PlayerGuid.GetCounter());
+            if (it == rowOf.end())
+            {
+                // Between floors: no session yet, only the run
+                PlayerCheckpoint cp;
+                cp.Guid         = pd.PlayerGuid.GetCounter();
+                cp.LeaderGuid   = run.LeaderGuid.GetCounter();
+                cp.MapId        = run.PreviousMapId;
+                cp.DifficultyId = run.BaseDifficultyId;
+                cp.RunId        = runId;
+                rows.push_back(std::move(cp));
+                it = rowOf.emplace(pd.PlayerGuid.GetCounter(), rows.size() - 1).first;
+            }
 
-        char query[512];
-        snprintf(query, sizeof(query),
-            "REPLACE INTO dm_roguelike_player_stats "
-            "(guid, total_runs, highest_tier, most_floors_cleared, "
-            "total_floors_cleared, total_mobs_killed, total_bosses_killed, "
-            "total_deaths, longest_run_time) "
-            "VALUES (%u, %u, %u, %u, %u, %u, %u, %u, %u)",
-            guidLow, ps.TotalRuns, ps.HighestTier, ps.MostFloorsCleared,
-            ps.TotalFloorsCleared, ps.TotalMobsKilled, ps.TotalBossesKilled,
-            ps.TotalDeaths, ps.LongestRunTime);
-        CharacterDatabase.Execute(query);
+            // A floor's own return position is the previous floor; go back to the start of the run
+            PlayerCheckpoint& cp = rows[it->second];
+            cp.Tier        = run.CurrentTier;
+            cp.BuffStacks  = run.BuffStacks;
+            cp.Affixes     = affixes;
+            cp.ReturnMapId = pd.OriginalMapId;
+            cp.ReturnPos   = pd.OriginalPosition;
+        }
     }
 }
 
+RoguelikePlayerStats RoguelikeMgr::GetRoguelikePlayerStats(ObjectGuid guid) const
+{
+    return _roguelikeStats.Get(guid.GetCounter());
+}
+
+void RoguelikeMgr::UpdateRoguelikePlayerStats(const RoguelikeRun& run)
+{
+    uint32 duration = 0;
+    if (GameTime::GetGameTime().count() > static_cast<time_t>(run.RunStartTime))
+        duration = static_cast<uint32>(GameTime::GetGameTime().count() - run.RunStartTime);
+
+    // Applied as a delta; persisted by the periodic write-behind flush
+    RoguelikePlayerStats delta;
+    delta.TotalRuns          = 1;
+    delta.HighestTier        = run.CurrentTier;
+    delta.MostFloorsCleared  = run.DungeonsCleared;
+    delta.TotalFloorsCleared = run.DungeonsCleared;
+    delta.TotalMobsKilled    = run.TotalMobsKilled;
+    delta.TotalBossesKilled  = run.TotalBossesKilled;
+    delta.TotalDeaths        = run.TotalDeaths;
+    delta.LongestRunTime     = duration;
+
+    for (const auto& pd : run.Players)
+        _roguelikeStats.Apply(pd.PlayerGuid.GetCounter(), delta);
+}
+
 } // namespace DungeonMaster
@@ -7,15 +7,29 @@
 #define ROGUELIKE_MGR_H
 
 #include "RoguelikeTypes.h"
+#include "PlayerStatsCache.h"
+#include "DMCheckpoint.h"
 #include <mutex>
 #include <unordered_map>
 
 class Player;
 class Group;
+class Field;
 
 namespace DungeonMaster
 {
 
+// dm_roguelike_player_stats row mapping for PlayerStatsCache
+struct RoguelikeStatsTraits
+{
+    using Stats = RoguelikePlayerStats;
+    static std::string SelectQuery(uint32 guidLow);
+    static void        Read(Field* fields, RoguelikePlayerStats& out);
+    static std::string ReplaceQuery(uint32 guidLow, const RoguelikePlayerStats& stats);
+    static std::string MergeQuery(uint32 guidLow, const RoguelikePlayerStats& delta);
+    static void        Merge(RoguelikePlayerStats& into, const RoguelikePlayerStats& delta);
+};
+
 class RoguelikeMgr
 {
     RoguelikeMgr();
@@ -65,12 +79,19 @@ public:
 
     // Leaderboard
     void SaveRoguelikeLeaderboard(const RoguelikeRun& run);
+    void LoadRoguelikeLeaderboards();
     std::vector<RoguelikeLeaderboardEntry> GetRoguelikeLeaderboard(uint32 limit = 10, bool sortByFloors = false) const;
 
     // Player stats (separate from normal run stats)
-    void LoadAllRoguelikePlayerStats();
     RoguelikePlayerStats GetRoguelikePlayerStats(ObjectGuid guid) const;
     void UpdateRoguelikePlayerStats(const RoguelikeRun& run);
+    void OnPlayerLogin(ObjectGuid guid);
+    void OnPlayerLogout(ObjectGuid guid);
+    void FlushRoguelikePlayerStats();
+
+    // Crash recovery: adds tier, buffs, affixes and the run's start position to
+    // the session rows, and rows for players between floors
+    void AppendRunCheckpoints(std::vector<PlayerCheckpoint>& rows) const;
 
 private:
     void BuildAffixPool();
@@ -89,8 +110,14 @@ private:
 
     std::vector<AffixDef> _affixDefs;
 
-    std::unordered_map<uint32, RoguelikePlayerStats> _roguelikeStats;  // guidLow -> stats
-    mutable std::mutex _rlStatsMutex;
+    PlayerStatsCache<RoguelikeStatsTraits> _roguelikeStats;
+    uint32 _statsFlushTimer = 0;
+
+    // Top-N boards, kept in the same order the NPC displays them
+    std::vector<RoguelikeLeaderboardEntry> _tierLeaderboard;
+    std::vector<RoguelikeLeaderboardEntry> _floorsLeaderboard;
+    mutable std::mutex _leaderboardMutex;
+    static constexpr uint32 LEADERBOARD_CACHE_SIZE = 25;
 
     uint32 _updateTimer = 0;
     static constexpr uint32 UPDATE_INTERVAL = 1000;
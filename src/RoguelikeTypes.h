@@ -81,6 +81,7 @@ struct RoguelikeRun
     uint32  BuffStacks = 0;                 // +10% all stats per stack (BoK aura with visual stacks)
 
     std::vector<RoguelikeAffix> ActiveAffixes;
+    std::string                 AffixNames;     // colored, comma-separated; set with ActiveAffixes
     std::vector<RoguelikePlayerData> Players;
 
     uint64  RunStartTime         = 0;
@@ -1,6 +1,7 @@
 /*
  * mod-dungeon-master — dm_allmap_script.cpp
- * Triggers dungeon population when a player enters the instance map.
+ * Triggers dungeon population when a player enters the instance map and
+ * drives the per-instance aggro scheduler from the map update.
  */
 
 #include "ScriptMgr.h"
@@ -8,6 +9,7 @@
 #include "Player.h"
 #include "DungeonMasterMgr.h"
 #include "DMConfig.h"
+#include "DMAggro.h"
 #include "Chat.h"
 #include "Log.h"
 #include <cstdio>
@@ -75,6 +77,15 @@ public:
             session->LevelBandMin, session->LevelBandMax);
         ChatHandler(player->GetSession()).SendSysMessage(buf);
     }
+
+    // Runs on the map's own update thread
+    void OnMapUpdate(Map* map, uint32 diff) override
+    {
+        if (!sDMConfig->IsEnabled())
+            return;
+
+        sDMAggro->Update(map, diff);
+    }
 };
 
 void AddSC_dm_allmap_script()
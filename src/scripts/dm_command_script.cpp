@@ -1,6 +1,7 @@
 /*
  * mod-dungeon-master — dm_command_script.cpp
- * GM commands: .dm reload, .dm status, .dm list, .dm end, .dm clearcooldown
+ * GM commands: .dm reload, .dm status, .dm list, .dm end, .dm clearcooldown,
+ *              .dm replay [seed], .dm perf [hooks|load|reset], .dm mem
  */
 
 #include "ScriptMgr.h"
@@ -10,6 +11,8 @@
 #include "Group.h"
 #include "DungeonMasterMgr.h"
 #include "DMConfig.h"
+#include "DMPerf.h"
+#include <algorithm>
 #include <cstdio>
 
 using namespace Acore::ChatCommands;
@@ -22,6 +25,13 @@ public:
 
     ChatCommandTable GetCommands() const override
     {
+        static ChatCommandTable perfTable =
+        {
+            { "",              HandlePerf,           SEC_GAMEMASTER,     Console::Yes },
+            { "hooks",         HandlePerfHooks,      SEC_GAMEMASTER,     Console::Yes },
+            { "load",          HandlePerfLoad,       SEC_GAMEMASTER,     Console::Yes },
+            { "reset",         HandlePerfReset,      SEC_ADMINISTRATOR,  Console::Yes },
+        };
         static ChatCommandTable dmTable =
         {
             { "reload",        HandleReload,        SEC_ADMINISTRATOR,  Console::Yes },
@@ -29,6 +39,9 @@ public:
             { "list",          HandleList,           SEC_GAMEMASTER,     Console::Yes },
             { "end",           HandleEnd,            SEC_ADMINISTRATOR,  Console::No  },
             { "clearcooldown", HandleClearCD,        SEC_GAMEMASTER,     Console::No  },
+            { "replay",        HandleReplay,         SEC_GAMEMASTER,     Console::No  },
+            { "mem",           HandleMem,            SEC_GAMEMASTER,     Console::Yes },
+            { "perf",          perfTable },
         };
         static ChatCommandTable root = { { "dm", dmTable } };
         return root;
@@ -37,6 +50,7 @@ public:
     static bool HandleReload(ChatHandler* h)
     {
         sDMConfig->LoadConfig(true);
+        sDungeonMasterMgr->ClearSpawnPointCache();
         h->SendSysMessage("DungeonMaster: Configuration reloaded.");
         return true;
     }
@@ -57,6 +71,19 @@ public:
             uint32(sDMConfig->GetThemes().size()),
             uint32(sDMConfig->GetDungeons().size()));
         h->SendSysMessage(buf);
+
+        uint32 cap  = sDMConfig->GetLiveCreatureBudget();
+        uint32 used = sDungeonMasterMgr->GetLiveCreatureBudgetUsed();
+        if (cap)
+            snprintf(buf, sizeof(buf), "Creature budget: %u / %u (%u left)", used, cap, cap > used ? cap - used : 0);
+        else
+            snprintf(buf, sizeof(buf), "Creature budget: %u (no cap)", used);
+        h->SendSysMessage(buf);
+        snprintf(buf, sizeof(buf), "World diff: %u ms (target %u ms, density x%.2f)",
+            sDungeonMasterMgr->GetSmoothedWorldDiff(), sDMConfig->GetLoadTargetDiff(),
+            LoadDensityScale(sDungeonMasterMgr->GetSmoothedWorldDiff(), sDMConfig->GetLoadTargetDiff(),
+                             sDMConfig->GetMinDensity()));
+        h->SendSysMessage(buf);
         return true;
     }
 
@@ -135,6 +162,171 @@ public:
         }
         return true;
     }
+
+    // No seed: show the current session's seed. With a seed: the next session
+    // led by the selected player (or the invoker) populates from it.
+    static bool HandleReplay(ChatHandler* h, Optional<uint64> seed)
+    {
+        Player* invoker = h->GetSession() ? h->GetSession()->GetPlayer() : nullptr;
+        if (!invoker) { h->SendSysMessage("In-game only."); return false; }
+
+        Player* t = h->getSelectedPlayer();
+        if (!t) t = invoker;
+
+        char buf[192];
+        if (!seed)
+        {
+            Session* s = sDungeonMasterMgr->GetSessionByPlayer(t->GetGUID());
+            if (!s) { h->SendSysMessage("Not in a DM session. Usage: .dm replay <seed>"); return false; }
+            snprintf(buf, sizeof(buf), "Session %u seed: %llu", s->SessionId,
+                static_cast<unsigned long long>(s->Seed));
+            h->SendSysMessage(buf);
+            return true;
+        }
+
+        sDungeonMasterMgr->SetReplaySeed(t->GetGUID(), *seed);
+        snprintf(buf, sizeof(buf), "Next session led by %s will populate from seed %llu.",
+            t->GetName().c_str(), static_cast<unsigned long long>(*seed));
+        h->SendSysMessage(buf);
+        return true;
+    }
+
+    // Estimated heap per session (largest first) and per global cache
+    static bool HandleMem(ChatHandler* h)
+    {
+        static constexpr size_t MAX_SESSION_LINES = 20;
+
+        MemoryReport r = sDungeonMasterMgr->GetMemoryReport();
+        std::sort(r.Sessions.begin(), r.Sessions.end(),
+            [](const MemoryReport::SessionUsage& a, const MemoryReport::SessionUsage& b) { return a.Bytes > b.Bytes; });
+
+        char buf[192];
+        h->SendSysMessage("=== Dungeon Master Memory (estimated heap) ===");
+
+        uint64 sessionTotal = 0;
+        for (const auto& s : r.Sessions)
+            sessionTotal += s.Bytes;
+        snprintf(buf, sizeof(buf), "Sessions: %u, %.1f KB", uint32(r.Sessions.size()), sessionTotal / 1024.0);
+        h->SendSysMessage(buf);
+        for (size_t i = 0; i < r.Sessions.size() && i < MAX_SESSION_LINES; ++i)
+        {
+            const auto& s = r.Sessions[i];
+            snprintf(buf, sizeof(buf), "  #%-6u map %-4u %4u creatures  %8.1f KB",
+                s.SessionId, s.MapId, s.Creatures, s.Bytes / 1024.0);
+            h->SendSysMessage(buf);
+        }
+        if (r.Sessions.size() > MAX_SESSION_LINES)
+        {
+            snprintf(buf, sizeof(buf), "  ... %u more", uint32(r.Sessions.size() - MAX_SESSION_LINES));
+            h->SendSysMessage(buf);
+        }
+
+        uint64 cacheTotal = 0;
+        h->SendSysMessage("Caches:");
+        for (const auto& c : r.Caches)
+        {
+            cacheTotal += c.Bytes;
+            snprintf(buf, sizeof(buf), "  %-20s %7u entries  %8.1f KB", c.Name, c.Entries, c.Bytes / 1024.0);
+            h->SendSysMessage(buf);
+        }
+        snprintf(buf, sizeof(buf), "Total: %.1f KB", (sessionTotal + cacheTotal) / 1024.0);
+        h->SendSysMessage(buf);
+        return true;
+    }
+
+    static bool HandlePerf(ChatHandler* h)
+    {
+        char buf[192];
+        h->SendSysMessage("=== Dungeon Master Perf (microseconds) ===");
+        if (!sDMConfig->IsPerfEnabled())
+            h->SendSysMessage("Timing is disabled (DungeonMaster.Perf.Enable = 0).");
+
+        for (uint8 i = 0; i < MAX_PERF_PHASES; ++i)
+        {
+            PerfPhase phase = static_cast<PerfPhase>(i);
+            PerfSnapshot snap = sDMPerf->GetSnapshot(phase);
+            snprintf(buf, sizeof(buf), "%-18s p50 %6u  p99 %6u  max %6u  (n=%llu)",
+                DMPerf::GetPhaseName(phase), snap.P50, snap.P99, snap.Max,
+                static_cast<unsigned long long>(snap.Count));
+            h->SendSysMessage(buf);
+        }
+        uint64 losHits   = sDMPerf->GetCount(HOOK_LOS_CACHE_HIT);
+        uint64 losMisses = sDMPerf->GetCount(HOOK_LOS_CACHE_MISS);
+        uint64 losTotal  = losHits + losMisses;
+        snprintf(buf, sizeof(buf), "Aggro LOS cache: %llu hits, %llu raycasts (%.1f%% hit)",
+            static_cast<unsigned long long>(losHits), static_cast<unsigned long long>(losMisses),
+            losTotal ? 100.0 * static_cast<double>(losHits) / static_cast<double>(losTotal) : 0.0);
+        h->SendSysMessage(buf);
+        snprintf(buf, sizeof(buf), "Window: last %u samples per phase.", DMPerf::WINDOW_SIZE);
+        h->SendSysMessage(buf);
+        return true;
+    }
+
+    static bool HandlePerfHooks(ChatHandler* h)
+    {
+        char buf[192];
+        h->SendSysMessage("=== Dungeon Master Unit Hooks ===");
+        if (!sDMConfig->IsPerfEnabled())
+            h->SendSysMessage("Counting is disabled (DungeonMaster.Perf.Enable = 0).");
+
+        for (uint8 i = 0; i < MAX_HOOK_COUNTERS; ++i)
+        {
+            HookCounter counter = static_cast<HookCounter>(i);
+            snprintf(buf, sizeof(buf), "%-18s %llu", DMPerf::GetCounterName(counter),
+                static_cast<unsigned long long>(sDMPerf->GetCount(counter)));
+            h->SendSysMessage(buf);
+        }
+
+        PerfSnapshot snap = sDMPerf->GetSnapshot(PERF_DAMAGE_HOOK);
+        snprintf(buf, sizeof(buf), "Damage hook (session path) us: p50 %u  p99 %u  max %u",
+            snap.P50, snap.P99, snap.Max);
+        h->SendSysMessage(buf);
+        return true;
+    }
+
+    static bool HandlePerfLoad(ChatHandler* h)
+    {
+        char buf[192];
+        h->SendSysMessage("=== Dungeon Master Tick vs Load (microseconds) ===");
+        if (!sDMConfig->IsPerfEnabled())
+            h->SendSysMessage("Sampling is disabled (DungeonMaster.Perf.Enable = 0).");
+
+        h->SendSysMessage("Sessions    p50     p99     max   mobs/sess   ticks");
+        bool any = false;
+        for (uint32 band = 0; band < DMPerf::LOAD_BANDS; ++band)
+        {
+            LoadBandSnapshot snap = sDMPerf->GetLoadSnapshot(band);
+            if (!snap.Tick.Count) continue;
+            any = true;
+
+            char range[16];
+            if (snap.MaxSessions == UINT32_MAX)
+                snprintf(range, sizeof(range), "%u+", snap.MinSessions);
+            else
+                snprintf(range, sizeof(range), "%u-%u", snap.MinSessions, snap.MaxSessions);
+
+            snprintf(buf, sizeof(buf), "%-8s %6u  %6u  %6u  %9.1f  %6llu",
+                range, snap.Tick.P50, snap.Tick.P99, snap.Tick.Max, snap.CreaturesPerSession,
+                static_cast<unsigned long long>(snap.Tick.Count));
+            h->SendSysMessage(buf);
+        }
+        if (!any)
+            h->SendSysMessage("No ticks sampled yet.");
+
+        snprintf(buf, sizeof(buf), "Peak: %u sessions, %llu KB session state (limit %u).",
+            sDMPerf->GetPeakSessions(),
+            static_cast<unsigned long long>(sDMPerf->GetPeakStateBytes() / 1024),
+            sDMConfig->GetMaxConcurrentRuns());
+        h->SendSysMessage(buf);
+        return true;
+    }
+
+    static bool HandlePerfReset(ChatHandler* h)
+    {
+        sDMPerf->Reset();
+        h->SendSysMessage("DungeonMaster: Perf counters reset.");
+        return true;
+    }
 };
 
 void AddSC_dm_command_script()
@@ -1,12 +1,15 @@
 /*
  * mod-dungeon-master — dm_player_script.cpp
  * Player death handling: blocks spirit release, checks for wipe.
+ * Login/logout drive the lazily loaded stats caches. Presence hooks keep the
+ * session alive / in-combat counters current.
  */
 
 #include "ScriptMgr.h"
 #include "Player.h"
 #include "Creature.h"
 #include "DungeonMasterMgr.h"
+#include "RoguelikeMgr.h"
 #include "DMConfig.h"
 
 using namespace DungeonMaster;
@@ -16,6 +19,53 @@ class dm_player_script : public PlayerScript
 public:
     dm_player_script() : PlayerScript("dm_player_script") {}
 
+    void OnPlayerLogin(Player* player) override
+    {
+        if (!sDMConfig->IsEnabled())
+            return;
+
+        sDungeonMasterMgr->OnPlayerLogin(player->GetGUID());
+        sRoguelikeMgr->OnPlayerLogin(player->GetGUID());
+        sDungeonMasterMgr->RecoverPlayer(player);
+        sDungeonMasterMgr->QueuePlayerPresence(player, true, player->IsAlive(), player->IsInCombat());
+    }
+
+    void OnPlayerLogout(Player* player) override
+    {
+        if (!sDMConfig->IsEnabled())
+            return;
+
+        sDungeonMasterMgr->OnPlayerLogout(player->GetGUID());
+        sRoguelikeMgr->OnPlayerLogout(player->GetGUID());
+        sDungeonMasterMgr->QueuePlayerPresence(player, false, false, false);
+    }
+
+    // ---- Presence (filtered lock-free for players in no session) ----
+
+    void OnPlayerJustDied(Player* player) override
+    {
+        if (sDMConfig->IsEnabled())
+            sDungeonMasterMgr->QueuePlayerPresence(player, true, false, false);
+    }
+
+    void OnPlayerResurrect(Player* player, float /*restorePercent*/, bool /*applySickness*/) override
+    {
+        if (sDMConfig->IsEnabled())
+            sDungeonMasterMgr->QueuePlayerPresence(player, true, true, player->IsInCombat());
+    }
+
+    void OnPlayerEnterCombat(Player* player, Unit* /*enemy*/) override
+    {
+        if (sDMConfig->IsEnabled())
+            sDungeonMasterMgr->QueuePlayerPresence(player, true, player->IsAlive(), true);
+    }
+
+    void OnPlayerLeaveCombat(Player* player) override
+    {
+        if (sDMConfig->IsEnabled())
+            sDungeonMasterMgr->QueuePlayerPresence(player, true, player->IsAlive(), false);
+    }
+
     void OnPlayerKilledByCreature(Creature* /*killer*/, Player* player) override
     {
         if (!sDMConfig->IsEnabled() || !player)
@@ -4,6 +4,8 @@
  *   - Session boss spells/melee: scaled by level ratio (template level → session level)
  *   - Session trash: already scaled by custom AI melee, passed through
  *   - Environmental (non-session): capped at 3% max HP
+ * Runs for every damage event in the world, so players outside a session are
+ * rejected through a lock-free membership filter before any mutex is taken.
  */
 
 #include "ScriptMgr.h"
@@ -12,11 +14,18 @@
 #include "SpellInfo.h"
 #include "DungeonMasterMgr.h"
 #include "DMConfig.h"
+#include "DMPerf.h"
 
 using namespace DungeonMaster;
 
 static constexpr float ENV_DAMAGE_MAX_PCT = 0.03f;
 
+static inline void CountHook(HookCounter counter)
+{
+    if (sDMConfig->IsPerfEnabled())
+        sDMPerf->Count(counter);
+}
+
 class dm_unit_script : public UnitScript
 {
 public:
@@ -49,6 +58,8 @@ public:
         if (!creature)
             return;
 
+        CountHook(HOOK_DEATH_CALLS);
+
         Player* player = nullptr;
         if (killer)
         {
@@ -57,13 +68,18 @@ public:
                 player = killer->GetOwner()->ToPlayer();
         }
 
-        Session* session = nullptr;
-        if (player)
-            session = sDungeonMasterMgr->GetSessionByPlayer(player->GetGUID());
+        if (!player || !sDungeonMasterMgr->MayBeInSession(player->GetGUID()))
+        {
+            CountHook(HOOK_DEATH_FAST_REJECT);
+            return;
+        }
 
+        Session* session = sDungeonMasterMgr->GetSessionByPlayer(player->GetGUID());
         if (!session || !session->IsActive())
             return;
 
+        CountHook(HOOK_DEATH_SESSION_HIT);
+
         if (creature->GetMapId() != session->MapId)
             return;
 
@@ -73,20 +89,32 @@ public:
 private:
     void ScaleDamage(Unit* target, Unit* attacker, uint32& damage)
     {
-        if (!sDMConfig->IsEnabled() || damage == 0)
-            return;
+        CountHook(HOOK_DAMAGE_CALLS);
 
         Player* player = target ? target->ToPlayer() : nullptr;
-        if (!player)
+        if (!sDMConfig->IsEnabled() || damage == 0 || !player || (attacker && attacker->ToPlayer()))
+        {
+            CountHook(HOOK_DAMAGE_EARLY_OUT);
             return;
+        }
+
+        ObjectGuid playerGuid = player->GetGUID();
 
-        if (attacker && attacker->ToPlayer())
+        if (!sDungeonMasterMgr->MayBeInSession(playerGuid))
+        {
+            CountHook(HOOK_DAMAGE_FAST_REJECT);
             return;
+        }
 
-        ObjectGuid playerGuid = player->GetGUID();
+        PerfScope perfScope(PERF_DAMAGE_HOOK);
 
         if (!sDungeonMasterMgr->GetSessionByPlayer(playerGuid))
+        {
+            CountHook(HOOK_DAMAGE_SESSION_MISS);
             return;
+        }
+
+        CountHook(HOOK_DAMAGE_SESSION_HIT);
 
         if (attacker)
         {
@@ -99,7 +127,10 @@ private:
                     playerGuid, attackerGuid);
 
                 if (scale < 1.0f)
+                {
                     damage = std::max(1u, static_cast<uint32>(damage * scale));
+                    CountHook(HOOK_DAMAGE_CREATURE_SCALED);
+                }
 
                 return;
             }
@@ -118,6 +149,8 @@ private:
 
         if (damage == 0)
             damage = 1;
+
+        CountHook(HOOK_DAMAGE_ENV_SCALED);
     }
 };
 
@@ -21,6 +21,8 @@ public:
     void OnAfterConfigLoad(bool reload) override
     {
         sDMConfig->LoadConfig(reload);
+        if (reload)
+            sDungeonMasterMgr->ClearSpawnPointCache();
     }
 
     void OnStartup() override
@@ -63,6 +65,13 @@ public:
         if (!sDMConfig->IsEnabled()) return;
         LOG_INFO("module", "DungeonMaster: Shutdown — {} sessions active.",
             sDungeonMasterMgr->GetActiveSessionCount());
+
+        // Write out anything still waiting on the write-behind timer; runs
+        // still in progress are checkpointed so their players are returned
+        if (sDMConfig->GetCheckpointInterval())
+            sDungeonMasterMgr->WriteCheckpoints();
+        sDungeonMasterMgr->FlushPlayerStats();
+        sRoguelikeMgr->FlushRoguelikePlayerStats();
     }
 
     void OnUpdate(uint32 diff) override
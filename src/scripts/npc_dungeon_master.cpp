@@ -17,9 +17,9 @@
 #include "RoguelikeMgr.h"
 #include "RoguelikeTypes.h"
 #include "DMConfig.h"
+#include "DMRandom.h"
 #include <cstdio>
 #include <mutex>
-#include <random>
 
 using namespace DungeonMaster;
 
@@ -520,6 +520,35 @@ private:
             chat.SendSysMessage(buf);
         }
 
+        // Per-board bests for runs this player led
+        auto bests = sDungeonMasterMgr->GetPersonalBests(player->GetGUID());
+        if (!bests.empty())
+        {
+            chat.SendSysMessage(" ");
+            chat.SendSysMessage("  |cFFFFD700Personal Bests:|r");
+
+            uint32 overallBest = 0;
+            for (const auto& pb : bests)
+            {
+                if (overallBest == 0 || pb.ClearTime < overallBest)
+                    overallBest = pb.ClearTime;
+
+                char timeBuf[64];
+                FormatTime(pb.ClearTime, timeBuf, sizeof(timeBuf));
+                const DifficultyTier* diff = sDMConfig->GetDifficulty(pb.DifficultyId);
+                const DungeonInfo* dg = sDMConfig->GetDungeon(pb.MapId);
+
+                snprintf(buf, sizeof(buf), "    %s (%s): |cFF00FFFF%s|r — Rank |cFFFFD700#%u|r of %u",
+                    dg ? dg->Name.c_str() : "?", diff ? diff->Name.c_str() : "?",
+                    timeBuf, pb.Rank, pb.BoardSize);
+                chat.SendSysMessage(buf);
+            }
+
+            snprintf(buf, sizeof(buf), "  Overall Rank: |cFFFFD700#%u|r",
+                sDungeonMasterMgr->GetOverallRank(overallBest));
+            chat.SendSysMessage(buf);
+        }
+
         chat.SendSysMessage("|cFFFFD700══════════════════════════════════════════|r");
 
         AddGossipItemFor(player, GOSSIP_ICON_TABARD, "|cFFFFD700View Leaderboards|r",
@@ -842,8 +871,7 @@ private:
             if (dgs.empty()) {
                 ChatHandler(player->GetSession()).SendSysMessage("|cFFFF0000[Dungeon Master]|r No dungeons available!");
                 return; }
-            static thread_local std::mt19937 rng{ std::random_device{}() };
-            mapId = dgs[std::uniform_int_distribution<size_t>(0, dgs.size()-1)(rng)]->MapId;
+            mapId = dgs[ThreadRng().Below(static_cast<uint32>(dgs.size()))]->MapId;
         }
 
         Session* s = sDungeonMasterMgr->CreateSession(player, sel.DifficultyId, sel.ThemeId, mapId, sel.ScaleToParty);